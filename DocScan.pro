@@ -1,6 +1,7 @@
 # Run  qmake CONFIG+=quazip5  to enable support for both ODF and OpenXML formats
 # Run  qmake CONFIG+=wv2  to enable support for historic Word file formats
-# Run  qmake "CONFIG+=wv2 quazip5"  to enable all features
+# Run  qmake CONFIG+=zstd  to enable storing full text in compressed form
+# Run  qmake "CONFIG+=wv2 quazip5 zstd"  to enable all features
 
 QT += network xml gui
 QT -= webkit
@@ -26,7 +27,7 @@ DEFINES += HAVE_ICONV_H ICONV_CONST= HAVE_STRING_H HAVE_MATH_H
 SOURCES += src/main.cpp src/watchdog.cpp \
     src/searchengineabstract.cpp \
     src/searchenginebing.cpp src/downloader.cpp \
-    src/fileanalyzerabstract.cpp \
+    src/fileanalyzerabstract.cpp src/languageidentifier.cpp src/aspellpool.cpp src/textanalysis.cpp \
     src/fileanalyzerpdf.cpp src/searchenginegoogle.cpp \
     src/logcollector.cpp src/popplerwrapper.cpp \
     src/general.cpp src/urldownloader.cpp \
@@ -34,13 +35,19 @@ SOURCES += src/main.cpp src/watchdog.cpp \
     src/filesystemscan.cpp src/filefinderlist.cpp \
     src/webcrawler.cpp src/fakedownloader.cpp \
     src/fileanalyzermultiplexer.cpp \
+    src/fileanalyzerworkerpool.cpp \
+    src/validatorscheduler.cpp \
+    src/analysiscache.cpp src/textstore.cpp \
+    src/journal.cpp \
+    src/stagetiming.cpp \
+    src/decompressor.cpp \
     src/geoip.cpp \
     src/searchenginespringerlink.cpp \
     src/networkaccessmanager.cpp \
     src/guessing.cpp
 HEADERS += src/searchengineabstract.h \
     src/searchenginebing.h src/downloader.h \
-    src/fileanalyzerabstract.h src/searchenginegoogle.h \
+    src/fileanalyzerabstract.h src/languageidentifier.h src/aspellpool.h src/textanalysis.h src/searchenginegoogle.h \
     src/fileanalyzerpdf.h \
     src/watchdog.h src/watchable.h \
     src/logcollector.h src/fromlogfile.h \
@@ -49,6 +56,12 @@ HEADERS += src/searchengineabstract.h \
     src/filesystemscan.h src/filefinderlist.h \
     src/webcrawler.h src/fakedownloader.h \
     src/fileanalyzermultiplexer.h \
+    src/fileanalyzerworkerpool.h \
+    src/validatorscheduler.h \
+    src/analysiscache.h src/textstore.h \
+    src/journal.h \
+    src/stagetiming.h \
+    src/decompressor.h \
     src/geoip.h \
     src/searchenginespringerlink.h \
     src/networkaccessmanager.h \
@@ -114,7 +127,17 @@ quazip5 {
     HEADERS += src/fileanalyzeropenxml.h src/fileanalyzerodf.h
 }
 
+zstd {
+    # compression of full text kept next to the log
+    CONFIG += link_pkgconfig
+    PKGCONFIG += libzstd
+    DEFINES += HAVE_ZSTD
+}
+
 unix {
     CONFIG += link_pkgconfig
     PKGCONFIG += glib-2.0 poppler-cpp poppler
+    # in-process decompression of xz, lzma, gz, and bz2 files
+    PKGCONFIG += liblzma zlib
+    LIBS += -lbz2
 }
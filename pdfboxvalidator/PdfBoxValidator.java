@@ -1,21 +1,27 @@
+import java.io.BufferedReader;
+import java.io.ByteArrayOutputStream;
 import java.io.IOException;
+import java.io.InputStreamReader;
+import java.io.OutputStream;
+import java.io.PrintStream;
+import java.nio.charset.StandardCharsets;
 import org.apache.pdfbox.preflight.parser.PreflightParser;
 import org.apache.pdfbox.preflight.*;
 import org.apache.pdfbox.preflight.exception.SyntaxValidationException;
 
 public class PdfBoxValidator {
 
-    public static void main(String[] args) {
+    /**
+     * Validate a single file, writing the verdict to 'out' and
+     * problems to 'err'.
+     * @return exit code as used when validating a single file
+     */
+    private static int validate(String filename, PrintStream out, PrintStream err) {
         org.apache.pdfbox.preflight.ValidationResult result = null;
 
-        if (args.length != 1) {
-            System.err.println("Require exactly one filename as command line argument");
-            System.exit(1);
-        }
-
         try
         {
-            PreflightParser parser = new PreflightParser(args[0]);
+            PreflightParser parser = new PreflightParser(filename);
 
             /* Parse the PDF file with PreflightParser that inherits from the NonSequentialParser.
              * Some additional controls are present to check a set of PDF/A requirements.
@@ -46,21 +52,80 @@ public class PdfBoxValidator {
         }
         catch (IOException e)
         {
-            System.err.println("IO error when opening " + args[0]);
-            System.exit(1);
+            err.println("IO error when opening " + filename);
+            return 1;
         }
 
         /// display validation result
         if (result.isValid())
-        {
-            System.out.println("The file '" + args[0] + "' is a valid PDF/A-1b file");
-            System.exit(0);
-        }
+            out.println("The file '" + filename + "' is a valid PDF/A-1b file");
         else
-        {
-            System.out.println("The file '" + args[0] + "' is NOT PDF/A-1b valid, " + result.getErrorsList().size() + " error(s)");
-            System.exit(0);
+            out.println("The file '" + filename + "' is NOT PDF/A-1b valid, " + result.getErrorsList().size() + " error(s)");
+        return 0;
+    }
+
+    /**
+     * Keep the JVM running and validate one file per line read from
+     * standard input. Each result is written to standard output as a
+     * header line
+     *   @@RESULT <exitcode> <stdout length> <stderr length>
+     * followed by exactly that many bytes of output and error text.
+     * The server quits once standard input is closed.
+     */
+    private static void serve() throws IOException {
+        final OutputStream frameOutput = System.out;
+        final BufferedReader input = new BufferedReader(new InputStreamReader(System.in, StandardCharsets.UTF_8));
+        final ByteArrayOutputStream outBuffer = new ByteArrayOutputStream();
+        final ByteArrayOutputStream errBuffer = new ByteArrayOutputStream();
+        final PrintStream out = new PrintStream(outBuffer, true, "UTF-8");
+        final PrintStream err = new PrintStream(errBuffer, true, "UTF-8");
+        /// Anything written by PDFBox itself ends up in the current file's error text
+        System.setOut(err);
+        System.setErr(err);
+
+        String filename;
+        while ((filename = input.readLine()) != null) {
+            if (filename.isEmpty()) continue;
+            outBuffer.reset();
+            errBuffer.reset();
+
+            int exitCode;
+            try {
+                exitCode = validate(filename, out, err);
+            } catch (Throwable e) {
+                /// Broken files must not take down the server, including
+                /// errors like StackOverflowError from deeply nested objects
+                err.println("Validation of " + filename + " failed: " + e);
+                exitCode = 1;
+            }
+
+            out.flush();
+            err.flush();
+            final byte[] outBytes = outBuffer.toByteArray();
+            final byte[] errBytes = errBuffer.toByteArray();
+            frameOutput.write(("@@RESULT " + exitCode + " " + outBytes.length + " " + errBytes.length + "\n").getBytes(StandardCharsets.UTF_8));
+            frameOutput.write(outBytes);
+            frameOutput.write(errBytes);
+            frameOutput.flush();
+        }
+    }
+
+    public static void main(String[] args) {
+        if (args.length == 1 && args[0].equals("--server")) {
+            try {
+                serve();
+                System.exit(0);
+            } catch (IOException e) {
+                System.exit(1);
+            }
         }
+
+        if (args.length != 1) {
+            System.err.println("Require exactly one filename or '--server' as command line argument");
+            System.exit(1);
+        }
+
+        System.exit(validate(args[0], System.out, System.err));
     }
 
 }
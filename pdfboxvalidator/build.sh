@@ -22,5 +22,5 @@ done
 
 jarfiles=$(ls -1 *.jar | xargs printf "%s:" ; echo ".")
 
-test -s PdfBoxValidator.class || javac -cp "${jarfiles}" PdfBoxValidator.java
+test PdfBoxValidator.class -nt PdfBoxValidator.java || javac -cp "${jarfiles}" PdfBoxValidator.java
 exit $?
@@ -0,0 +1,136 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#include "analysiscache.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QMutex>
+#include <QCryptographicHash>
+#include <QTextStream>
+#include <QDebug>
+
+#include "general.h"
+
+AnalysisCache *AnalysisCache::instance()
+{
+    static QMutex instanceMutex;
+    static AnalysisCache *cache = nullptr;
+
+    QMutexLocker locker(&instanceMutex);
+    if (cache == nullptr) {
+        /// Never deleted, lives as long as the process
+        cache = new AnalysisCache();
+    }
+    return cache;
+}
+
+AnalysisCache::AnalysisCache()
+{
+    /// nothing
+}
+
+void AnalysisCache::setDirectory(const QString &directory)
+{
+    if (!directory.isEmpty() && !QDir().mkpath(directory)) {
+        qWarning() << "Cannot create analysis cache directory" << directory;
+        m_directory.clear();
+        return;
+    }
+    m_directory = directory;
+}
+
+bool AnalysisCache::isEnabled() const
+{
+    return !m_directory.isEmpty();
+}
+
+QByteArray AnalysisCache::contentHash(const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly))
+        return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    if (!hash.addData(&file))
+        return QByteArray();
+    return hash.result();
+}
+
+QByteArray AnalysisCache::contentHash(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Md5);
+}
+
+QString AnalysisCache::key(const QByteArray &contentHash, const QString &fingerprint)
+{
+    return QString::fromLatin1(contentHash.toHex()) + QChar('-') + QString::fromLatin1(QCryptographicHash::hash(fingerprint.toUtf8(), QCryptographicHash::Md5).toHex());
+}
+
+QString AnalysisCache::lookup(const QString &key, const QString &filename) const
+{
+    if (m_directory.isEmpty()) return QString();
+
+    QFile entry(entryFilename(key));
+    if (!entry.open(QFile::ReadOnly))
+        return QString();
+    QTextStream ts(&entry);
+    ts.setCodec("utf-8");
+    /// First line holds the filename the report was created for
+    const QString cachedFilenameAttribute = QString(QStringLiteral("filename=\"%1\"")).arg(DocScan::xmlify(ts.readLine()));
+    QString report = ts.readAll();
+    entry.close();
+
+    const int p = report.indexOf(cachedFilenameAttribute);
+    if (!report.startsWith(QStringLiteral("<fileanalysis ")) || p < 0) {
+        qWarning() << "Ignoring malformed analysis cache entry" << entry.fileName();
+        return QString();
+    }
+    return report.replace(p, cachedFilenameAttribute.length(), QString(QStringLiteral("filename=\"%1\" cached=\"yes\" cachekey=\"%2\"")).arg(DocScan::xmlify(filename), key));
+}
+
+void AnalysisCache::store(const QString &key, const QString &filename, const QString &report) const
+{
+    /// Filename is stored in an entry's first line
+    if (m_directory.isEmpty() || filename.contains(QChar('\n'))) return;
+
+    const QString entryName = entryFilename(key);
+    QDir().mkpath(QFileInfo(entryName).path());
+    /// Write to a temporary file first, so that concurrent readers
+    /// or an interrupted run never see a partial entry
+    QSaveFile entry(entryName);
+    if (entry.open(QFile::WriteOnly)) {
+        QTextStream ts(&entry);
+        ts.setCodec("utf-8");
+        ts << filename << '\n' << report;
+        ts.flush();
+        if (!entry.commit())
+            qWarning() << "Failed to write analysis cache entry" << entryName;
+    }
+}
+
+QString AnalysisCache::entryFilename(const QString &key) const
+{
+    /// Spread entries over subdirectories to keep directories small
+    return m_directory + QChar('/') + key.left(2) + QChar('/') + key + QStringLiteral(".xml");
+}
@@ -0,0 +1,96 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#ifndef ANALYSISCACHE_H
+#define ANALYSISCACHE_H
+
+#include <QString>
+#include <QByteArray>
+
+/**
+ * Persistent on-disk cache of analysis reports. Reports are
+ * stored under a key made from the hash of a file's content and
+ * a fingerprint of the analyzer's configuration, so that files
+ * with identical content found under different paths or URLs
+ * are analyzed only once, even across runs.
+ * The cache is disabled unless a directory is set.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class AnalysisCache
+{
+public:
+    /**
+     * Process-wide cache instance, created on first use.
+     */
+    static AnalysisCache *instance();
+
+    /**
+     * Set the directory to store cached reports in.
+     * Should be called before any analysis is started.
+     */
+    void setDirectory(const QString &directory);
+    bool isEnabled() const;
+
+    /**
+     * Compute the hash of a file's content as used in cache keys.
+     * @return MD5 sum of the file's content, empty if the file cannot be read
+     */
+    static QByteArray contentHash(const QString &filename);
+    /**
+     * Same as above for a file's content held in memory.
+     */
+    static QByteArray contentHash(const QByteArray &data);
+
+    /**
+     * Build a cache key.
+     * @param contentHash hash as computed by contentHash(..)
+     * @param fingerprint version of the analyzer and all configuration affecting its result
+     */
+    static QString key(const QByteArray &contentHash, const QString &fingerprint);
+
+    /**
+     * Retrieve a cached report. The report's filename gets replaced
+     * by the given one and the report is marked as being cached.
+     * May be called from any thread.
+     *
+     * @param key key as returned by key(..)
+     * @param filename name of the file whose report is requested
+     * @return report as passed to store(..), empty if not cached
+     */
+    QString lookup(const QString &key, const QString &filename) const;
+
+    /**
+     * Store a report. The report has to be a single '<fileanalysis>'
+     * element for the given filename. May be called from any thread.
+     */
+    void store(const QString &key, const QString &filename, const QString &report) const;
+
+private:
+    QString m_directory;
+
+    AnalysisCache();
+
+    QString entryFilename(const QString &key) const;
+};
+
+#endif // ANALYSISCACHE_H
@@ -0,0 +1,319 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+
+#include "aspellpool.h"
+
+#include <QThread>
+#include <QProcess>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QRegExp>
+#include <QDebug>
+
+const int AspellPool::maxSampleWords = 1000;
+
+/// Time in milliseconds 'aspell' may take to start or to check a sample
+static const int aspellTimeout = 10000;
+
+/**
+ * Words to check by every dictionary, shared by all dictionaries'
+ * threads. Waits until each dictionary has reported its number of
+ * misspelled words.
+ */
+struct AspellPool::Request {
+    /// Line as written to 'aspell', including the leading '^'
+    /// which prevents words from being taken as commands
+    QByteArray line;
+    /// Misspelled words per dictionary, -1 if checking failed
+    QVector<int> misspelled;
+    int pending;
+    QMutex mutex;
+    QWaitCondition done;
+
+    Request(const QByteArray &_line, int numDictionaries)
+        : line(_line), misspelled(numDictionaries, -1), pending(numDictionaries) {
+        /// nothing
+    }
+
+    void deliver(int index, int count) {
+        QMutexLocker locker(&mutex);
+        misspelled[index] = count;
+        if (--pending == 0)
+            done.wakeAll();
+    }
+
+    void wait() {
+        QMutexLocker locker(&mutex);
+        while (pending > 0)
+            done.wait(&mutex);
+    }
+};
+
+/**
+ * Thread owning the 'aspell' process of a single dictionary.
+ * The process is started when the first request arrives and
+ * restarted if it quits or stops responding.
+ */
+class AspellPool::Speller : public QThread
+{
+private:
+    const QString m_dictionary;
+    const int m_index;
+    QMutex m_mutex;
+    QWaitCondition m_requestQueued;
+    QQueue<Request *> m_queue;
+    bool m_stopping;
+
+    QProcess *startAspell() {
+        QProcess *aspell = new QProcess();
+        const QStringList args = QStringList() << QStringLiteral("-a") << QStringLiteral("-d") << m_dictionary << QStringLiteral("--encoding=utf-8") << QStringLiteral("--sug-mode=ultra");
+        aspell->start(QStringLiteral("/usr/bin/aspell"), args);
+        QByteArray banner;
+        if (aspell->waitForStarted(aspellTimeout) && readLine(aspell, banner) && banner.startsWith("@(#)")) {
+            /// Terse mode: correctly spelled words are not reported
+            aspell->write("!\n");
+            return aspell;
+        }
+        qWarning() << "Could not start aspell for dictionary" << m_dictionary;
+        stopAspell(aspell);
+        return nullptr;
+    }
+
+    void stopAspell(QProcess *aspell) {
+        aspell->closeWriteChannel();
+        if (!aspell->waitForFinished(1000)) {
+            aspell->kill();
+            aspell->waitForFinished(1000);
+        }
+        delete aspell;
+    }
+
+    bool readLine(QProcess *aspell, QByteArray &line) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!aspell->canReadLine()) {
+            const int remaining = aspellTimeout - static_cast<int>(timer.elapsed());
+            if (remaining <= 0 || !aspell->waitForReadyRead(remaining))
+                return false;
+        }
+        line = aspell->readLine();
+        return true;
+    }
+
+    /**
+     * @return number of misspelled words, -1 if 'aspell' failed
+     */
+    int check(QProcess *aspell, const QByteArray &line) {
+        if (aspell->write(line) < 0) return -1;
+        int misspelled = 0;
+        QByteArray response;
+        while (readLine(aspell, response)) {
+            if (response == "\n")
+                return misspelled; ///< empty line ends response
+            /// '&': misspelled with suggestions, '#': without suggestions,
+            /// '?': only known as run-together words
+            if (response.startsWith('&') || response.startsWith('#') || response.startsWith('?'))
+                ++misspelled;
+        }
+        return -1;
+    }
+
+public:
+    Speller(const QString &dictionary, int index)
+        : QThread(), m_dictionary(dictionary), m_index(index), m_stopping(false) {
+        setObjectName(QString(QStringLiteral("Aspell-%1")).arg(dictionary));
+    }
+
+    void enqueue(Request *request) {
+        QMutexLocker locker(&m_mutex);
+        if (m_stopping) {
+            locker.unlock();
+            request->deliver(m_index, -1);
+            return;
+        }
+        m_queue.enqueue(request);
+        m_requestQueued.wakeOne();
+    }
+
+    void stop() {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_requestQueued.wakeOne();
+    }
+
+protected:
+    void run() {
+        /// Process has to be created inside this thread to be used from it
+        QProcess *aspell = nullptr;
+        forever {
+            m_mutex.lock();
+            while (m_queue.isEmpty() && !m_stopping)
+                m_requestQueued.wait(&m_mutex);
+            if (m_queue.isEmpty()) {
+                m_mutex.unlock();
+                break;
+            }
+            Request *request = m_queue.dequeue();
+            m_mutex.unlock();
+
+            if (aspell != nullptr && aspell->state() != QProcess::Running) {
+                stopAspell(aspell);
+                aspell = nullptr;
+            }
+            if (aspell == nullptr)
+                aspell = startAspell();
+            const int misspelled = aspell != nullptr ? check(aspell, request->line) : -1;
+            if (misspelled < 0 && aspell != nullptr) {
+                /// Process is out of step with requests, start over next time
+                qWarning() << "aspell for dictionary" << m_dictionary << "failed to check text";
+                stopAspell(aspell);
+                aspell = nullptr;
+            }
+            request->deliver(m_index, misspelled);
+        }
+
+        if (aspell != nullptr)
+            stopAspell(aspell);
+    }
+};
+
+AspellPool *AspellPool::instance()
+{
+    static QMutex instanceMutex;
+    static AspellPool *pool = nullptr;
+
+    QMutexLocker locker(&instanceMutex);
+    if (pool == nullptr) {
+        /// Never deleted, lives as long as the process
+        pool = new AspellPool();
+    }
+    return pool;
+}
+
+AspellPool::AspellPool()
+    : QObject(nullptr), m_mutex(new QMutex()), m_started(false), m_shuttingDown(false)
+{
+    /// nothing
+}
+
+void AspellPool::start()
+{
+    /// Called with m_mutex locked
+    if (m_started) return;
+    m_started = true;
+
+    const QRegExp language(QStringLiteral("^[a-z]{2}(_[A-Z]{2})?$"));
+    QProcess aspell;
+    aspell.start(QStringLiteral("/usr/bin/aspell"), QStringList() << QStringLiteral("dicts"));
+    if (aspell.waitForStarted(aspellTimeout)) {
+        aspell.closeWriteChannel();
+        if (!aspell.waitForFinished(aspellTimeout))
+            aspell.kill();
+        const QList<QByteArray> lines = aspell.readAllStandardOutput().split('\n');
+        for (const QByteArray &line : lines) {
+            const QString dictionary = QString::fromLatin1(line).simplified();
+            if (language.exactMatch(dictionary))
+                m_dictionaries << dictionary;
+        }
+    } else
+        qWarning() << "Could not start aspell to list dictionaries";
+
+    for (int i = 0; i < m_dictionaries.count(); ++i) {
+        Speller *speller = new Speller(m_dictionaries[i], i);
+        m_spellers.append(speller);
+        speller->start();
+    }
+    qDebug() << "Started aspell for dictionaries" << m_dictionaries.join(QStringLiteral(", "));
+}
+
+QStringList AspellPool::dictionaries()
+{
+    QMutexLocker locker(m_mutex);
+    start();
+    return m_dictionaries;
+}
+
+QString AspellPool::guessLanguage(const QString &text)
+{
+    m_mutex->lock();
+    if (!m_shuttingDown)
+        start();
+    const QList<Speller *> spellers = m_shuttingDown ? QList<Speller *>() : m_spellers;
+    m_mutex->unlock();
+    if (spellers.isEmpty()) return QString();
+
+    /// Tokenize text once for all dictionaries
+    QStringList words;
+    int wordStart = -1;
+    for (int i = 0; i <= text.length(); ++i) {
+        const bool isLetter = i < text.length() && text[i].isLetter();
+        if (isLetter && wordStart < 0)
+            wordStart = i;
+        else if (!isLetter && wordStart >= 0) {
+            words.append(text.mid(wordStart, i - wordStart));
+            wordStart = -1;
+        }
+    }
+    if (words.isEmpty()) return QString();
+
+    /// Pick words evenly spread over the text
+    QByteArray line("^");
+    const double step = qMax(1.0, static_cast<double>(words.count()) / maxSampleWords);
+    for (double w = 0.0; w < words.count(); w += step) {
+        if (line.length() > 1) line.append(' ');
+        line.append(words[static_cast<int>(w)].toUtf8());
+    }
+    line.append('\n');
+
+    Request request(line, spellers.count());
+    for (Speller *speller : spellers)
+        speller->enqueue(&request);
+    request.wait();
+
+    int fewestMisspelled = -1;
+    QString best;
+    for (int i = 0; i < request.misspelled.count(); ++i)
+        if (request.misspelled[i] >= 0 && (fewestMisspelled < 0 || request.misspelled[i] < fewestMisspelled)) {
+            fewestMisspelled = request.misspelled[i];
+            best = m_dictionaries[i];
+        }
+
+    return best;
+}
+
+void AspellPool::shutdown()
+{
+    m_mutex->lock();
+    m_shuttingDown = true;
+    const QList<Speller *> spellers = m_spellers;
+    m_mutex->unlock();
+
+    /// Threads serve requests still queued before quitting
+    for (Speller *speller : spellers)
+        speller->stop();
+    for (Speller *speller : spellers)
+        speller->wait();
+}
@@ -0,0 +1,93 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+
+#ifndef ASPELLPOOL_H
+#define ASPELLPOOL_H
+
+#include <QObject>
+#include <QStringList>
+
+class QMutex;
+
+/**
+ * Keeps one 'aspell' process per installed dictionary running in
+ * pipe mode ('aspell -a') for the whole run, instead of starting
+ * a process per dictionary and text.
+ * A text's language is guessed by passing a sample of its words to
+ * all dictionaries in parallel, each served by its own thread, and
+ * picking the dictionary which knows most words. Requests from
+ * several analysis threads are served one after another per
+ * dictionary.
+ * Each request is a single line of words; aspell's response to it
+ * ends with an empty line.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class AspellPool : public QObject
+{
+    Q_OBJECT
+public:
+    static AspellPool *instance();
+
+    /**
+     * Installed dictionaries as listed by 'aspell dicts', restricted
+     * to plain language codes like 'de' or 'en_GB'. Starts one
+     * 'aspell' process per dictionary on first call.
+     */
+    QStringList dictionaries();
+
+    /**
+     * Guess the language of a text as the dictionary reporting
+     * the fewest misspelled words. Blocks until all dictionaries
+     * have checked the text's sample of words.
+     *
+     * @param text text to guess the language of
+     * @return dictionary's language code, or an empty string if no dictionary could check the text
+     */
+    QString guessLanguage(const QString &text);
+
+    /// Maximum number of words, evenly spread over a text, passed to dictionaries
+    static const int maxSampleWords;
+
+public slots:
+    /**
+     * Quit all 'aspell' processes and their threads.
+     * Further requests will fail.
+     */
+    void shutdown();
+
+private:
+    class Speller;
+    struct Request;
+
+    QMutex *m_mutex;
+    bool m_started, m_shuttingDown;
+    QStringList m_dictionaries;
+    QList<Speller *> m_spellers;
+
+    AspellPool();
+
+    void start();
+};
+
+#endif // ASPELLPOOL_H
@@ -0,0 +1,307 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#include "decompressor.h"
+
+#include <cstring>
+
+#include <lzma.h>
+#include <zlib.h>
+#include <bzlib.h>
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QCryptographicHash>
+
+/// Size of input and output buffers allocated for each call
+static const int bufferSize = 1 << 18;
+
+/**
+ * Common state of a decoding run: buffers, devices, and hashes.
+ */
+class DecodingRun
+{
+public:
+    QIODevice *input, *output;
+    QCryptographicHash *compressedHash, *uncompressedHash;
+    QByteArray inputBuffer, outputBuffer;
+    bool endOfInput;
+    QString errorMessage;
+    /// Limit for uncompressed data, negative if unlimited
+    const qint64 maxOutputSize;
+    qint64 outputSize;
+    bool outputSizeExceeded;
+
+    DecodingRun(QIODevice *_input, QIODevice *_output, QCryptographicHash *_compressedHash, QCryptographicHash *_uncompressedHash, qint64 _maxOutputSize)
+        : input(_input), output(_output), compressedHash(_compressedHash), uncompressedHash(_uncompressedHash), inputBuffer(bufferSize, '\0'), outputBuffer(bufferSize, '\0'), endOfInput(false), maxOutputSize(_maxOutputSize), outputSize(0), outputSizeExceeded(false)
+    {
+        /// nothing
+    }
+
+    /**
+     * Read the next chunk of compressed data into the input buffer.
+     * @return number of bytes read, -1 on error
+     */
+    qint64 readInput() {
+        const qint64 size = input->read(inputBuffer.data(), bufferSize);
+        if (size < 0)
+            errorMessage = QStringLiteral("Reading compressed data failed: ") + input->errorString();
+        else if (size == 0)
+            endOfInput = true;
+        else if (compressedHash != nullptr)
+            compressedHash->addData(inputBuffer.constData(), static_cast<int>(size));
+        return size;
+    }
+
+    /**
+     * Write the first bytes of the output buffer to the output device.
+     * @return 'true' on success
+     */
+    bool writeOutput(qint64 size) {
+        if (size <= 0) return true;
+        /// Small files may uncompress into huge amounts of data
+        outputSize += size;
+        if (maxOutputSize >= 0 && outputSize > maxOutputSize) {
+            errorMessage = QString(QStringLiteral("Uncompressed data exceeds limit of %1 bytes")).arg(maxOutputSize);
+            outputSizeExceeded = true;
+            return false;
+        }
+        if (uncompressedHash != nullptr)
+            uncompressedHash->addData(outputBuffer.constData(), static_cast<int>(size));
+        if (output->write(outputBuffer.constData(), size) != size) {
+            errorMessage = QStringLiteral("Writing uncompressed data failed: ") + output->errorString();
+            return false;
+        }
+        return true;
+    }
+};
+
+static bool decompressLzma(DecodingRun &run, bool xzContainer)
+{
+    lzma_stream stream = LZMA_STREAM_INIT;
+    lzma_ret ret = xzContainer ? lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) : lzma_alone_decoder(&stream, UINT64_MAX);
+    if (ret != LZMA_OK) {
+        run.errorMessage = QString(QStringLiteral("Initializing liblzma failed with code %1")).arg(ret);
+        return false;
+    }
+
+    lzma_action action = LZMA_RUN;
+    bool ok = true;
+    while (ok) {
+        if (stream.avail_in == 0 && action == LZMA_RUN) {
+            const qint64 size = run.readInput();
+            if (size < 0) {
+                ok = false;
+                break;
+            }
+            stream.next_in = reinterpret_cast<const uint8_t *>(run.inputBuffer.constData());
+            stream.avail_in = static_cast<size_t>(size);
+            /// Concatenated streams can only be finished if told that no more input follows
+            if (run.endOfInput) action = LZMA_FINISH;
+        }
+
+        stream.next_out = reinterpret_cast<uint8_t *>(run.outputBuffer.data());
+        stream.avail_out = bufferSize;
+        ret = lzma_code(&stream, action);
+        ok = run.writeOutput(bufferSize - stream.avail_out);
+        if (!ok) break;
+
+        if (ret == LZMA_STREAM_END)
+            break;
+        else if (ret != LZMA_OK) {
+            run.errorMessage = ret == LZMA_BUF_ERROR ? QStringLiteral("Compressed data is truncated") : QString(QStringLiteral("Decoding with liblzma failed with code %1")).arg(ret);
+            ok = false;
+        }
+    }
+
+    lzma_end(&stream);
+    return ok;
+}
+
+static bool decompressGzip(DecodingRun &run)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    /// Window size 15 plus 32 to detect gzip or zlib header automatically
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        run.errorMessage = QStringLiteral("Initializing zlib failed");
+        return false;
+    }
+
+    bool ok = true, streamEnd = false;
+    while (ok) {
+        if (stream.avail_in == 0 && !run.endOfInput) {
+            const qint64 size = run.readInput();
+            if (size < 0) {
+                ok = false;
+                break;
+            }
+            stream.next_in = reinterpret_cast<Bytef *>(run.inputBuffer.data());
+            stream.avail_in = static_cast<uInt>(size);
+        }
+        if (stream.avail_in == 0 && run.endOfInput)
+            break;
+
+        if (streamEnd) {
+            /// More data following the end of a stream is another gzip member
+            inflateReset(&stream);
+            streamEnd = false;
+        }
+
+        stream.next_out = reinterpret_cast<Bytef *>(run.outputBuffer.data());
+        stream.avail_out = bufferSize;
+        const int ret = inflate(&stream, Z_NO_FLUSH);
+        ok = run.writeOutput(bufferSize - stream.avail_out);
+        if (!ok) break;
+
+        if (ret == Z_STREAM_END)
+            streamEnd = true;
+        else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            run.errorMessage = QString(QStringLiteral("Decoding with zlib failed: %1")).arg(QString::fromLatin1(stream.msg != nullptr ? stream.msg : "unknown error"));
+            ok = false;
+        }
+    }
+    if (ok && !streamEnd) {
+        run.errorMessage = QStringLiteral("Compressed data is truncated");
+        ok = false;
+    }
+
+    inflateEnd(&stream);
+    return ok;
+}
+
+static bool decompressBzip2(DecodingRun &run)
+{
+    bz_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK) {
+        run.errorMessage = QStringLiteral("Initializing libbz2 failed");
+        return false;
+    }
+
+    bool ok = true, streamEnd = false;
+    while (ok) {
+        if (stream.avail_in == 0 && !run.endOfInput) {
+            const qint64 size = run.readInput();
+            if (size < 0) {
+                ok = false;
+                break;
+            }
+            stream.next_in = run.inputBuffer.data();
+            stream.avail_in = static_cast<unsigned int>(size);
+        }
+        if (stream.avail_in == 0 && run.endOfInput)
+            break;
+
+        if (streamEnd) {
+            /// More data following the end of a stream is another bzip2 stream
+            BZ2_bzDecompressEnd(&stream);
+            char *nextIn = stream.next_in;
+            const unsigned int availIn = stream.avail_in;
+            memset(&stream, 0, sizeof(stream));
+            if (BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK) {
+                run.errorMessage = QStringLiteral("Initializing libbz2 failed");
+                return false;
+            }
+            stream.next_in = nextIn;
+            stream.avail_in = availIn;
+            streamEnd = false;
+        }
+
+        stream.next_out = run.outputBuffer.data();
+        stream.avail_out = bufferSize;
+        const int ret = BZ2_bzDecompress(&stream);
+        ok = run.writeOutput(bufferSize - stream.avail_out);
+        if (!ok) break;
+
+        if (ret == BZ_STREAM_END)
+            streamEnd = true;
+        else if (ret != BZ_OK) {
+            run.errorMessage = QString(QStringLiteral("Decoding with libbz2 failed with code %1")).arg(ret);
+            ok = false;
+        }
+    }
+    if (ok && !streamEnd) {
+        run.errorMessage = QStringLiteral("Compressed data is truncated");
+        ok = false;
+    }
+
+    BZ2_bzDecompressEnd(&stream);
+    return ok;
+}
+
+bool Decompressor::formatForFilename(const QString &filename, Format &format, QString &extensionWithDot)
+{
+    if (filename.endsWith(QStringLiteral(".xz"))) {
+        format = Xz;
+        extensionWithDot = QStringLiteral(".xz");
+    } else if (filename.endsWith(QStringLiteral(".lzma"))) {
+        format = Lzma;
+        extensionWithDot = QStringLiteral(".lzma");
+    } else if (filename.endsWith(QStringLiteral(".gz"))) {
+        format = Gzip;
+        extensionWithDot = QStringLiteral(".gz");
+    } else if (filename.endsWith(QStringLiteral(".bz2"))) {
+        format = Bzip2;
+        extensionWithDot = QStringLiteral(".bz2");
+    } else
+        return false;
+    return true;
+}
+
+QString Decompressor::decoderName(Format format)
+{
+    switch (format) {
+    case Xz: return QStringLiteral("liblzma (xz)");
+    case Lzma: return QStringLiteral("liblzma (lzma)");
+    case Gzip: return QStringLiteral("zlib");
+    case Bzip2: return QStringLiteral("libbz2");
+    }
+    return QString();
+}
+
+bool Decompressor::decompress(Format format, QIODevice *input, QIODevice *output, QCryptographicHash *compressedHash, QCryptographicHash *uncompressedHash, QString *errorMessage, qint64 maxOutputSize, bool *outputSizeExceeded)
+{
+    DecodingRun run(input, output, compressedHash, uncompressedHash, maxOutputSize);
+
+    bool ok = false;
+    switch (format) {
+    case Xz:
+        ok = decompressLzma(run, true);
+        break;
+    case Lzma:
+        ok = decompressLzma(run, false);
+        break;
+    case Gzip:
+        ok = decompressGzip(run);
+        break;
+    case Bzip2:
+        ok = decompressBzip2(run);
+        break;
+    }
+
+    if (!ok && errorMessage != nullptr)
+        *errorMessage = run.errorMessage;
+    if (outputSizeExceeded != nullptr)
+        *outputSizeExceeded = run.outputSizeExceeded;
+    return ok;
+}
@@ -0,0 +1,79 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#ifndef DECOMPRESSOR_H
+#define DECOMPRESSOR_H
+
+#include <QString>
+
+class QIODevice;
+class QCryptographicHash;
+
+/**
+ * Streaming decoders for compressed files, running in-process
+ * using liblzma, zlib, and libbz2. Data is read from and written
+ * to arbitrary devices, so that uncompressed data can be written
+ * to a file or kept in memory (QBuffer).
+ * All functions are thread-safe, buffers are allocated per call.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class Decompressor
+{
+public:
+    enum Format {Xz = 0, Lzma = 1, Gzip = 2, Bzip2 = 3};
+
+    /**
+     * Determine the compression format from a filename's extension.
+     *
+     * @param filename filename to test
+     * @param format compression format if recognized
+     * @param extensionWithDot extension that got recognized, e.g. '.xz'
+     * @return 'true' if the file is compressed in a supported format
+     */
+    static bool formatForFilename(const QString &filename, Format &format, QString &extensionWithDot);
+
+    /**
+     * Name of the library used to decode a format,
+     * for use in log messages.
+     */
+    static QString decoderName(Format format);
+
+    /**
+     * Decode all data from the input device and write it to the
+     * output device. Concatenated streams (e.g. from 'cat a.gz b.gz')
+     * are decoded as a whole.
+     *
+     * @param format compression format of input data
+     * @param input open device to read compressed data from
+     * @param output open device to write uncompressed data to
+     * @param compressedHash if not null, all compressed data read gets added to this hash
+     * @param uncompressedHash if not null, all uncompressed data written gets added to this hash
+     * @param errorMessage if not null, receives a description of the problem in case of failure
+     * @param maxOutputSize if not negative, decoding stops with an error once more than this many bytes would be written
+     * @param outputSizeExceeded if not null, set to 'true' if decoding stopped due to maxOutputSize
+     * @return 'true' if the input was decoded completely and without errors
+     */
+    static bool decompress(Format format, QIODevice *input, QIODevice *output, QCryptographicHash *compressedHash = nullptr, QCryptographicHash *uncompressedHash = nullptr, QString *errorMessage = nullptr, qint64 maxOutputSize = -1, bool *outputSizeExceeded = nullptr);
+};
+
+#endif // DECOMPRESSOR_H
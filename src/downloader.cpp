@@ -23,7 +23,31 @@
 #include "downloader.h"
 
 Downloader::Downloader(QObject *parent)
-    : QObject(parent)
+    : QObject(parent), m_upstreamDrained(false), m_drainedEmitted(false)
 {
     // nothing
 }
+
+void Downloader::grantCredits(int credits)
+{
+    emit creditsGranted(credits);
+}
+
+void Downloader::upstreamDrained()
+{
+    m_upstreamDrained = true;
+    checkDrained();
+}
+
+int Downloader::numPendingUrls()
+{
+    return 0;
+}
+
+void Downloader::checkDrained()
+{
+    if (m_upstreamDrained && !m_drainedEmitted && numPendingUrls() == 0) {
+        m_drainedEmitted = true;
+        emit drained();
+    }
+}
@@ -43,6 +43,30 @@ public:
 signals:
     void downloaded(QString);
 
+    /**
+     * Same as downloaded(QString), but with the file's content
+     * still held in memory, so that it can be analyzed without
+     * reading it from disk again. Only emitted by downloaders which
+     * have the content at hand, right before downloaded(QString).
+     */
+    void downloaded(QString, QByteArray);
+
+    /**
+     * Pass credits on to the upstream file finder, i.e. notify
+     * that this downloader and all components after it have capacity
+     * for further urls. See FileFinder::grantCredits(int).
+     * Urls that never get passed on to analysis (e.g. failed or
+     * duplicate downloads) return their credit immediately.
+     */
+    void creditsGranted(int);
+
+    /**
+     * Notification that the upstream file finder has completed and
+     * that every url received has either been passed on for analysis
+     * via downloaded(QString) or been dropped. Emitted only once.
+     */
+    void drained();
+
 public slots:
     /**
      * Download file as specified by the url.
@@ -55,6 +79,40 @@ public slots:
      * Request to log a summary of all download requests (e.g. success/failure rate).
      */
     virtual void finalReport() = 0;
+
+    /**
+     * Receive credits from downstream components such as a file
+     * analyzer. Default implementation passes all credits on to
+     * the upstream file finder.
+     *
+     * @param credits number of credits granted
+     */
+    virtual void grantCredits(int credits);
+
+    /**
+     * Notification that no further urls will be passed to download(..),
+     * usually connected to FileFinder::drained(). Once all pending urls
+     * are processed, drained() will be emitted.
+     */
+    void upstreamDrained();
+
+protected:
+    /**
+     * Number of urls received but neither passed on for analysis
+     * nor dropped yet. Default implementation returns 0, suitable
+     * for downloaders processing urls synchronously.
+     */
+    virtual int numPendingUrls();
+
+    /**
+     * Emit drained() if the upstream finder has completed and
+     * no urls are pending anymore. Has to be called by
+     * asynchronous downloaders whenever a pending url got processed.
+     */
+    void checkDrained();
+
+private:
+    bool m_upstreamDrained, m_drainedEmitted;
 };
 
 #endif // DOWNLOADER_H
@@ -37,11 +37,13 @@ void FakeDownloader::download(const QUrl &url)
         const QString logText = QString(QStringLiteral("<download message=\"invalid URL\" status=\"error\" url=\"%1\" />\n")).arg(url.toString());
         emit report(logText);
         ++m_counterErrors;
+        emit creditsGranted(1); ///< nothing passed on for analysis
     } else if (!url.isLocalFile()) {
         qWarning() << "Non-local URL passed to FakeDownloader: " << url.toString();
         const QString logText = QString(QStringLiteral("<download message=\"non-local URL\" status=\"error\" url=\"%1\" />\n")).arg(url.toString());
         emit report(logText);
         ++m_counterErrors;
+        emit creditsGranted(1); ///< nothing passed on for analysis
     } else {
         const QString localName = url.path();
         qDebug() << "FakeDownloader passing through: " << localName;
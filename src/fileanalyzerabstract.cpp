@@ -22,14 +22,13 @@
 
 #include "fileanalyzerabstract.h"
 
-#include <limits>
-
-#include <QProcess>
 #include <QCoreApplication>
 #include <QDate>
-#include <QTextStream>
+#include <QThread>
 
 #include "guessing.h"
+#include "languageidentifier.h"
+#include "textanalysis.h"
 #include "general.h"
 
 FileAnalyzerAbstract::FileAnalyzerAbstract(QObject *parent)
@@ -41,73 +40,129 @@ void FileAnalyzerAbstract::setTextExtraction(TextExtraction textExtraction) {
     this->textExtraction = textExtraction;
 }
 
-QStringList FileAnalyzerAbstract::runAspell(const QString &text, const QString &dictionary) const
-{
-    QStringList wordList;
-    QProcess aspell(QCoreApplication::instance());
-    QStringList args = QStringList() << QStringLiteral("-d") << dictionary << QStringLiteral("list");
-    aspell.start(QStringLiteral("/usr/bin/aspell"), args);
-    if (aspell.waitForStarted(10000)) {
-        qint64 bytesWritten = aspell.write(text.toUtf8());
-        if (bytesWritten < 0) return QStringList(); /// something went wrong
-        aspell.closeWriteChannel();
-
-        QTextStream ts(&aspell);
-        ts.setCodec("UTF-8");
-        while (aspell.waitForReadyRead(10000)) {
-            QString line;
-            while (!(line = ts.readLine()).isNull()) {
-                wordList << line;
-            }
-        }
-        if (!aspell.waitForFinished(10000))
-            aspell.kill();
-    }
-    return wordList;
+void FileAnalyzerAbstract::setLanguageIdentification(LanguageIdentification method, double minConfidence)
+{
+    s_languageIdentification = method;
+    s_minLanguageConfidence = minConfidence;
 }
 
-QString FileAnalyzerAbstract::guessLanguage(const QString &text) const
+FileAnalyzerAbstract::LanguageIdentification FileAnalyzerAbstract::languageIdentification()
 {
-    int count = std::numeric_limits<int>::max();
-    QString best;
+    return s_languageIdentification;
+}
 
-    const QStringList langs = getAspellLanguages();
-    for (const QString &lang : langs) {
-        int c = runAspell(text, lang).count();
-        if (c > 0 && c < count) { /// if c==0, no misspelled words where found, likely due to an error
-            count = c;
-            best = lang;
-        }
-    }
+double FileAnalyzerAbstract::minLanguageConfidence()
+{
+    return s_minLanguageConfidence;
+}
 
-    return best;
+void FileAnalyzerAbstract::upstreamDrained()
+{
+    m_upstreamDrained.storeRelease(1);
+    checkDrained();
+}
+
+int FileAnalyzerAbstract::numPendingFiles()
+{
+    return isAlive() ? 1 : 0;
 }
 
-QStringList FileAnalyzerAbstract::getAspellLanguages() const
-{
-    if (aspellLanguages.isEmpty()) {
-        QRegExp language(QStringLiteral("^[a-z]{2}(_[A-Z]{2})?$"));
-        QProcess aspell(qApp);
-        QStringList args = QStringList() << QStringLiteral("dicts");
-        aspell.start(QStringLiteral("/usr/bin/aspell"), args);
-        if (aspell.waitForStarted(10000)) {
-            aspell.closeWriteChannel();
-            while (aspell.waitForReadyRead(10000)) {
-                while (aspell.canReadLine()) {
-                    const QString line = aspell.readLine().simplified();
-                    if (language.indexIn(line) >= 0) {
-                        aspellLanguages << language.cap(0);
-                    }
-                }
-            }
-            if (!aspell.waitForFinished(10000))
-                aspell.kill();
-        }
-
-        //emit analysisReport(QString(QStringLiteral("<initialization source=\"aspell\" type=\"languages\">%1</initialization>\n").arg(aspellLanguages.join(","))));
+void FileAnalyzerAbstract::checkDrained()
+{
+    /// Test-and-set guarantees that drained() is emitted only once,
+    /// even if called concurrently from several worker threads
+    if (m_upstreamDrained.loadAcquire() != 0 && numPendingFiles() == 0 && m_drainedEmitted.testAndSetOrdered(0, 1))
+        emit drained();
+}
+
+/**
+ * Wraps a job submitted by an analyzer, keeping
+ * track of jobs still accessing the analyzer.
+ */
+class FileAnalyzerAbstract::TrackedJob : public TextAnalysisJob
+{
+public:
+    TrackedJob(FileAnalyzerAbstract *analyzer, TextAnalysisJob *job)
+        : m_analyzer(analyzer), m_job(job)
+    {
+        m_analyzer->m_runningTextAnalysisJobs.ref();
+    }
+
+    TextSource *textSource() {
+        return m_job->textSource();
+    }
+
+    void textAnalyzed(const QString &headerText) {
+        m_job->textAnalyzed(headerText);
+        delete m_job;
+        /// Last access to the analyzer, which may get deleted from now on
+        m_analyzer->m_runningTextAnalysisJobs.deref();
+    }
+
+private:
+    FileAnalyzerAbstract *m_analyzer;
+    TextAnalysisJob *m_job;
+};
+
+/**
+ * Emits a report once the text extracted from its file is analyzed.
+ */
+class FileAnalyzerAbstract::ReportJob : public TextAnalysisJob
+{
+public:
+    ReportJob(FileAnalyzerAbstract *analyzer, const QString &report, const QString &text)
+        : m_analyzer(analyzer), m_report(report), m_source(text)
+    {
+        /// nothing
+    }
+
+    TextSource *textSource() {
+        return &m_source;
     }
 
-    return aspellLanguages;
+    void textAnalyzed(const QString &headerText) {
+        const int p = m_report.indexOf(QStringLiteral("</header>"));
+        if (p >= 0) m_report.insert(p, headerText);
+        emit m_analyzer->analysisReport(m_report);
+        /// Analysis is complete before the credit gets granted,
+        /// so that checkDrained() finds nothing pending anymore
+        m_analyzer->m_pendingTextAnalyses.deref();
+        emit m_analyzer->creditsGranted(1);
+        m_analyzer->checkDrained();
+    }
+
+private:
+    FileAnalyzerAbstract *m_analyzer;
+    QString m_report;
+    PlainTextSource m_source;
+};
+
+void FileAnalyzerAbstract::reportAfterTextAnalysis(const QString &report, const QString &text)
+{
+    if (textExtraction < teLength || text.isEmpty() || !report.contains(QStringLiteral("</header>"))) {
+        emit analysisReport(report);
+        emit creditsGranted(1);
+        return;
+    }
+
+    m_pendingTextAnalyses.ref();
+    submitTextAnalysis(new ReportJob(this, report, text));
+}
+
+void FileAnalyzerAbstract::submitTextAnalysis(TextAnalysisJob *job)
+{
+    TextAnalysis::instance()->submit(new TrackedJob(this, job), textExtraction >= teAspell);
+}
+
+int FileAnalyzerAbstract::numPendingTextAnalyses() const
+{
+    return m_pendingTextAnalyses.loadAcquire();
+}
+
+void FileAnalyzerAbstract::waitForTextAnalyses()
+{
+    while (m_runningTextAnalysisJobs.loadAcquire() > 0)
+        QThread::msleep(10);
 }
 
 QString FileAnalyzerAbstract::guessTool(const QString &toolString, const QString &altToolString) const
@@ -115,8 +170,11 @@ QString FileAnalyzerAbstract::guessTool(const QString &toolString, const QString
     QString result;
     QString text;
 
-    if (microsoftToolRegExp.indexIn(altToolString) == 0)
-        text = microsoftToolRegExp.cap(1);
+    /// Use a private copy of the regular expression, as it keeps
+    /// its match state and analyzers may run in several threads
+    QRegExp microsoftTool(microsoftToolRegExp.pattern());
+    if (microsoftTool.indexIn(altToolString) == 0)
+        text = microsoftTool.cap(1);
     else if (!toolString.isEmpty())
         text = toolString;
     else if (!altToolString.isEmpty())
@@ -155,7 +213,8 @@ QString FileAnalyzerAbstract::evaluatePaperSize(int mmw, int mmh) const
            : QString(QStringLiteral("<papersize height=\"%1\" width=\"%2\" orientation=\"%4\">%3</papersize>\n")).arg(QString::number(mmh), QString::number(mmw), formatName, mmw > mmh ? QStringLiteral("landscape") : QStringLiteral("portrait"));
 }
 
-QStringList FileAnalyzerAbstract::aspellLanguages;
+FileAnalyzerAbstract::LanguageIdentification FileAnalyzerAbstract::s_languageIdentification = FileAnalyzerAbstract::liNGram;
+double FileAnalyzerAbstract::s_minLanguageConfidence = 0.5;
 
 const QRegExp FileAnalyzerAbstract::microsoftToolRegExp(QStringLiteral("^(Microsoft\\s(.+\\S) [ -][ ]?(\\S.*)$"));
 const QString FileAnalyzerAbstract::creationDate = QStringLiteral("creation");
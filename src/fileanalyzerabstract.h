@@ -25,10 +25,12 @@
 
 #include <QObject>
 #include <QHash>
+#include <QAtomicInt>
 
 #include "watchable.h"
 
 class QDate;
+class TextAnalysisJob;
 
 /**
  * Common class for file analyzing classes.
@@ -41,11 +43,36 @@ class FileAnalyzerAbstract : public QObject, public Watchable
 public:
     enum TextExtraction {teNone = 0, teLength = 5, teFullText = 10, teAspell = 15};
 
+    /**
+     * How the language of extracted text gets identified if
+     * text extraction is set to teAspell.
+     */
+    enum LanguageIdentification {
+        /// Compare character trigrams with built-in profiles (fast, in-process)
+        liNGram = 0,
+        /// Spell-check text with every installed aspell dictionary
+        liAspell = 1,
+        /// Like liNGram, but additionally ask aspell if unsure
+        liFallback = 2
+    };
+
     static const QString licenseCategoryProprietary, licenseCategoryFreeware, licenseCategoryOpen;
 
     explicit FileAnalyzerAbstract(QObject *parent = nullptr);
 
-    void setTextExtraction(TextExtraction textExtraction);
+    virtual void setTextExtraction(TextExtraction textExtraction);
+
+    /**
+     * Set how the language of extracted text gets identified.
+     * Applies to all analyzers; should be set before any analysis
+     * is started. Default is liNGram.
+     *
+     * @param method method to identify languages
+     * @param minConfidence for liFallback, aspell gets asked if the trigram-based identification's confidence is below this value
+     */
+    static void setLanguageIdentification(LanguageIdentification method, double minConfidence);
+    static LanguageIdentification languageIdentification();
+    static double minLanguageConfidence();
 
 signals:
     /**
@@ -53,6 +80,22 @@ signals:
      */
     void analysisReport(QString);
 
+    /**
+     * Notification that this analyzer has capacity for further
+     * files, used for credit-based flow control. One credit
+     * is granted for every file passed to analyzeFile(..) or analyzeData(..) once
+     * its analysis is complete, no matter if successful or not.
+     */
+    void creditsGranted(int);
+
+    /**
+     * Notification that the upstream downloader has completed and
+     * that the analysis of every file received is complete, i.e.
+     * the last analysisReport(QString) has been emitted.
+     * Emitted only once, possibly from a different thread.
+     */
+    void drained();
+
 public slots:
     /**
      * Requests analyzer object to analyze file.
@@ -64,22 +107,84 @@ public slots:
      */
     virtual void analyzeFile(const QString &filename) = 0;
 
+    /**
+     * Requests analyzer object to analyze a document held in memory,
+     * e.g. a download or an uncompressed file. The document is analyzed
+     * without writing it to disk unless an external program requires so.
+     * Otherwise the same as analyzeFile(..), including the credit granted.
+     *
+     * @param filename name of the document as used in the report; no such file needs to exist
+     * @param data the document's content
+     */
+    virtual void analyzeData(const QString &filename, const QByteArray &data) = 0;
+
+    /**
+     * Notification that no further files will be passed to analyzeFile(..) or analyzeData(..),
+     * usually connected to Downloader::drained(). Once all pending files
+     * are analyzed, drained() will be emitted.
+     */
+    void upstreamDrained();
+
 protected:
     static const QString creationDate, modificationDate;
     static const QRegExp microsoftToolRegExp;
 
     TextExtraction textExtraction;
 
-    QString guessLanguage(const QString &text) const;
-    QStringList runAspell(const QString &text, const QString &dictionary) const;
+    /**
+     * Emit a file's report and grant its credit once the extracted
+     * text has been analyzed by TextAnalysis, which adds its findings
+     * to the report's <header>. Analysis happens in another thread,
+     * so this function returns immediately; analyzers have to count
+     * files with pending text analysis as alive, see
+     * numPendingTextAnalyses(). Without text to analyze, the report is
+     * emitted right away.
+     *
+     * @param report the file's complete report
+     * @param text text extracted from the file
+     */
+    void reportAfterTextAnalysis(const QString &report, const QString &text);
+    int numPendingTextAnalyses() const;
+    /**
+     * Queue a job with TextAnalysis, identifying the text's language
+     * if text extraction is set to teAspell. Takes ownership of the job.
+     */
+    void submitTextAnalysis(TextAnalysisJob *job);
+    /**
+     * Block until all jobs submitted by this analyzer are done.
+     * Has to be called in destructors of analyzers submitting jobs.
+     */
+    void waitForTextAnalyses();
     QString guessTool(const QString &toolString, const QString &altToolString = QString()) const;
     QString formatDate(const QDate date, const QString &base = QString()) const;
     QString evaluatePaperSize(int mmw, int mmh) const;
 
+    /**
+     * Number of files received but whose analysis is not complete yet.
+     * Default implementation assumes synchronous analysis and
+     * returns 1 while this analyzer is alive, 0 otherwise.
+     */
+    virtual int numPendingFiles();
+
+    /**
+     * Emit drained() if the upstream downloader has completed and
+     * no files are pending anymore. Has to be called by
+     * asynchronous analyzers whenever a file's analysis is complete.
+     * May be called from any thread.
+     */
+    void checkDrained();
+
 private:
-    static QStringList aspellLanguages;
+    class TrackedJob;
+    class ReportJob;
+
+    QAtomicInt m_upstreamDrained, m_drainedEmitted;
+    /// Files whose report is pending, and jobs still accessing this analyzer;
+    /// the latter get done only after the files' credits are granted
+    QAtomicInt m_pendingTextAnalyses, m_runningTextAnalysisJobs;
 
-    QStringList getAspellLanguages() const;
+    static LanguageIdentification s_languageIdentification;
+    static double s_minLanguageConfidence;
 };
 
 #endif // FILEANALYZERABSTRACT_H
@@ -72,14 +72,19 @@ public:
 };
 
 FileAnalyzerCompoundBinary::FileAnalyzerCompoundBinary(QObject *parent)
-    : FileAnalyzerAbstract(parent), m_isAlive(false)
+    : FileAnalyzerAbstract(parent), m_isAlive(0)
 {
     // nothing
 }
 
+FileAnalyzerCompoundBinary::~FileAnalyzerCompoundBinary()
+{
+    waitForTextAnalyses();
+}
+
 bool FileAnalyzerCompoundBinary::isAlive()
 {
-    return m_isAlive;
+    return m_isAlive.loadAcquire() != 0 || numPendingTextAnalyses() > 0;
 }
 
 void FileAnalyzerCompoundBinary::analyzeFiB(wvWare::Word97::FIB &fib, ResultContainer &result)
@@ -213,9 +218,9 @@ void FileAnalyzerCompoundBinary::analyzeTable(wvWare::OLEStorage &storage, wvWar
     delete table;
 }
 
-void FileAnalyzerCompoundBinary::analyzeWithParser(std::string &filename, ResultContainer &result)
+void FileAnalyzerCompoundBinary::analyzeWithParser(const QByteArray &data, ResultContainer &result)
 {
-    wvWare::SharedPtr<wvWare::Parser> parser(wvWare::ParserFactory::createParser(filename));
+    wvWare::SharedPtr<wvWare::Parser> parser(wvWare::ParserFactory::createParser(data.constData(), data.size()));
     if (parser != nullptr) {
         if (parser->isOk()) {
             DocScanTextHandler *textHandler = new DocScanTextHandler(result);
@@ -238,31 +243,49 @@ void FileAnalyzerCompoundBinary::analyzeWithParser(std::string &filename, Result
 
 void FileAnalyzerCompoundBinary::analyzeFile(const QString &filename)
 {
-    m_isAlive = true;
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly)) {
+        m_isAlive.storeRelease(1);
+        emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"OLEStorage cannot be opened\" status=\"error\" />\n")).arg(filename));
+        m_isAlive.storeRelease(0);
+        emit creditsGranted(1);
+        return;
+    }
+    /// Documents are small enough to be held in memory, which
+    /// saves POLE and the parser from seeking around in the file
+    const QByteArray data = file.readAll();
+    file.close();
+    analyzeData(filename, data);
+}
+
+void FileAnalyzerCompoundBinary::analyzeData(const QString &filename, const QByteArray &data)
+{
+    m_isAlive.storeRelease(1);
     ResultContainer result;
     result.paperSizeWidth = 0;
     result.paperSizeHeight = 0;
 
-    if (isRTFfile(filename)) {
+    if (isRTFdata(data)) {
         emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"RTF file disguising as DOC\" status=\"error\" />\n")).arg(filename));
-        m_isAlive = false;
+        m_isAlive.storeRelease(0);
+        emit creditsGranted(1);
         return;
     }
 
-    std::string cppFilename = std::string(filename.toUtf8().constData());
-
     /// perform various file checks before starting the analysis
-    wvWare::OLEStorage storage(cppFilename);
+    wvWare::OLEStorage storage(data.constData(), data.size());
     if (!storage.open(wvWare::OLEStorage::ReadOnly)) {
         emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"OLEStorage cannot be opened\" status=\"error\" />\n")).arg(filename));
-        m_isAlive = false;
+        m_isAlive.storeRelease(0);
+        emit creditsGranted(1);
         return;
     }
     wvWare::OLEStreamReader *document = storage.createStreamReader("WordDocument");
     if (document == nullptr || !document->isValid()) {
         if (document != nullptr)  delete document;
         emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"Not a valid Word document\" status=\"error\" />\n")).arg(filename));
-        m_isAlive = false;
+        m_isAlive.storeRelease(0);
+        emit creditsGranted(1);
         return;
     }
 
@@ -279,7 +302,7 @@ void FileAnalyzerCompoundBinary::analyzeFile(const QString &filename)
     analyzeTable(storage, fib, result);
 
     /// analyze file with parser
-    analyzeWithParser(cppFilename, result);
+    analyzeWithParser(data, result);
 
     QString logText = QString(QStringLiteral("<fileanalysis filename=\"%1\" status=\"ok\">\n")).arg(DocScan::xmlify(filename));
     QString metaText = QStringLiteral("<meta>\n");
@@ -306,11 +329,10 @@ void FileAnalyzerCompoundBinary::analyzeFile(const QString &filename)
     if (!result.subject.isEmpty())
         headerText.append(QString(QStringLiteral("<subject>%1</subject>\n")).arg(DocScan::xmlify(result.subject)));
 
-    /// evaluate language
+    /// evaluate language; the text's language gets
+    /// identified by reportAfterTextAnalysis(..)
     if (!result.language.isEmpty())
         headerText.append(QString(QStringLiteral("<language origin=\"document\">%1</language>\n")).arg(result.language));
-    //if (result.plainText.length() > 1024)
-    //    headerText.append(QString(QStringLiteral("<language origin=\"aspell\">%1</language>\n")).arg(guessLanguage(result.plainText)));
 
     /// evaluate dates
     if (result.dateCreation.isValid())
@@ -340,9 +362,8 @@ void FileAnalyzerCompoundBinary::analyzeFile(const QString &filename)
 
     delete document;
 
-    emit analysisReport(logText);
-
-    m_isAlive = false;
+    m_isAlive.storeRelease(0);
+    reportAfterTextAnalysis(logText, result.plainText);
 }
 
 /**
@@ -353,16 +374,21 @@ void FileAnalyzerCompoundBinary::analyzeFile(const QString &filename)
  */
 bool FileAnalyzerCompoundBinary::isRTFfile(const QString &filename)
 {
-    const char *rtfHeader = "{\\rtf";
     QFile file(filename);
     if (file.open(QFile::ReadOnly)) {
         QByteArray head = file.read(16);
         file.close();
-        return head.contains(rtfHeader);
+        return isRTFdata(head);
     }
     return false;
 }
 
+bool FileAnalyzerCompoundBinary::isRTFdata(const QByteArray &data)
+{
+    const char *rtfHeader = "{\\rtf";
+    return data.left(16).contains(rtfHeader);
+}
+
 QString FileAnalyzerCompoundBinary::langCodeToISOCode(int lid)
 {
     switch (lid) {
@@ -24,6 +24,7 @@
 #define FILEANALYZERCOMPOUNDBINARY_H
 
 #include <QDate>
+#include <QAtomicInt>
 
 #include <word_helper.h>
 #include <word97_generated.h>
@@ -40,6 +41,7 @@ class FileAnalyzerCompoundBinary : public FileAnalyzerAbstract
     Q_OBJECT
 public:
     explicit FileAnalyzerCompoundBinary(QObject *parent = nullptr);
+    ~FileAnalyzerCompoundBinary();
 
     virtual bool isAlive();
 
@@ -52,11 +54,16 @@ public:
      * @return 'true' if the file is an RTF file, otherwise 'false'
      */
     static bool isRTFfile(const QString &filename);
+    /**
+     * Same as isRTFfile(..), but for a document held in memory.
+     */
+    static bool isRTFdata(const QByteArray &data);
 
     static QString langCodeToISOCode(int lid);
 
 public slots:
     virtual void analyzeFile(const QString &filename);
+    virtual void analyzeData(const QString &filename, const QByteArray &data);
 
 private:
     typedef struct {
@@ -73,11 +80,12 @@ private:
         int paperSizeWidth, paperSizeHeight;
     } ResultContainer;
 
-    bool m_isAlive;
+    /// Read by text analysis threads via isAlive()
+    QAtomicInt m_isAlive;
 
     void analyzeFiB(wvWare::Word97::FIB &fib, ResultContainer &result);
     void analyzeTable(wvWare::OLEStorage &storage, wvWare::Word97::FIB &fib, ResultContainer &result);
-    void analyzeWithParser(std::string &filename, ResultContainer &result);
+    void analyzeWithParser(const QByteArray &data, ResultContainer &result);
 
     bool getVersion(unsigned short nFib, int &versionNumber, QString &versionText);
     bool getEditor(unsigned short wMagic, QString &editorText);
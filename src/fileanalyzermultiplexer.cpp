@@ -24,24 +24,40 @@
 
 #include <QRegExp>
 #include <QDebug>
-#include <QProcess>
 #include <QFile>
 #include <QFileInfo>
+#include <QBuffer>
 #include <QCryptographicHash>
+#include <QAtomicInt>
 
 #include "general.h"
+#include "decompressor.h"
+#include "stagetiming.h"
+
+/// Uncompressed data is kept in a QByteArray, which cannot grow beyond 2 GiB
+const qint64 FileAnalyzerMultiplexer::maxUncompressedSizeLimit = Q_INT64_C(2047) * 1024 * 1024;
+qint64 FileAnalyzerMultiplexer::s_maxUncompressedSize = Q_INT64_C(1024) * 1024 * 1024;
+
+/// Shared by all multiplexers, which may run in several threads
+static QAtomicInt uncompressedFileCounter;
 
 FileAnalyzerMultiplexer::FileAnalyzerMultiplexer(const QStringList &filters, QObject *parent)
     : FileAnalyzerAbstract(parent), m_filters(filters)
 {
     qsrand(QTime::currentTime().msec());
+    /// Specialized analyzers may report from other threads (e.g. the PDF
+    /// analyzer once all validators are done), so forward reports directly
 #ifdef HAVE_QUAZIP5
-    connect(&m_fileAnalyzerOpenXML, SIGNAL(analysisReport(QString)), this, SIGNAL(analysisReport(QString)));
-    connect(&m_fileAnalyzerODF, SIGNAL(analysisReport(QString)), this, SIGNAL(analysisReport(QString)));
+    connect(&m_fileAnalyzerOpenXML, SIGNAL(analysisReport(QString)), this, SIGNAL(analysisReport(QString)), Qt::DirectConnection);
+    connect(&m_fileAnalyzerODF, SIGNAL(analysisReport(QString)), this, SIGNAL(analysisReport(QString)), Qt::DirectConnection);
+    connect(&m_fileAnalyzerOpenXML, SIGNAL(creditsGranted(int)), this, SLOT(forwardCredits(int)), Qt::DirectConnection);
+    connect(&m_fileAnalyzerODF, SIGNAL(creditsGranted(int)), this, SLOT(forwardCredits(int)), Qt::DirectConnection);
 #endif // HAVE_QUAZIP5
-    connect(&m_fileAnalyzerPDF, SIGNAL(analysisReport(QString)), this, SIGNAL(analysisReport(QString)));
+    connect(&m_fileAnalyzerPDF, SIGNAL(analysisReport(QString)), this, SIGNAL(analysisReport(QString)), Qt::DirectConnection);
+    connect(&m_fileAnalyzerPDF, SIGNAL(creditsGranted(int)), this, SLOT(forwardCredits(int)), Qt::DirectConnection);
 #ifdef HAVE_WV2
-    connect(&m_fileAnalyzerCompoundBinary, SIGNAL(analysisReport(QString)), this, SIGNAL(analysisReport(QString)));
+    connect(&m_fileAnalyzerCompoundBinary, SIGNAL(analysisReport(QString)), this, SIGNAL(analysisReport(QString)), Qt::DirectConnection);
+    connect(&m_fileAnalyzerCompoundBinary, SIGNAL(creditsGranted(int)), this, SLOT(forwardCredits(int)), Qt::DirectConnection);
 #endif // HAVE_WV2
 }
 
@@ -57,6 +73,29 @@ bool FileAnalyzerMultiplexer::isAlive()
     return result;
 }
 
+void FileAnalyzerMultiplexer::setTextExtraction(TextExtraction textExtraction)
+{
+    FileAnalyzerAbstract::setTextExtraction(textExtraction);
+#ifdef HAVE_QUAZIP5
+    m_fileAnalyzerOpenXML.setTextExtraction(textExtraction);
+    m_fileAnalyzerODF.setTextExtraction(textExtraction);
+#endif // HAVE_QUAZIP5
+    m_fileAnalyzerPDF.setTextExtraction(textExtraction);
+#ifdef HAVE_WV2
+    m_fileAnalyzerCompoundBinary.setTextExtraction(textExtraction);
+#endif // HAVE_WV2
+}
+
+void FileAnalyzerMultiplexer::setMaxUncompressedSize(qint64 maxSize)
+{
+    s_maxUncompressedSize = qBound(Q_INT64_C(0), maxSize, maxUncompressedSizeLimit);
+}
+
+qint64 FileAnalyzerMultiplexer::maxUncompressedSize()
+{
+    return s_maxUncompressedSize;
+}
+
 void FileAnalyzerMultiplexer::setupJhove(const QString &shellscript)
 {
     m_fileAnalyzerPDF.setupJhove(shellscript);
@@ -74,137 +113,152 @@ void FileAnalyzerMultiplexer::setupCallasPdfAPilotCLI(const QString &callasPdfAP
     m_fileAnalyzerPDF.setupCallasPdfAPilotCLI(callasPdfAPilotCLI);
 }
 
-void FileAnalyzerMultiplexer::uncompressAnalyzefile(const QString &filename, const QString &extensionWithDot, const QString &uncompressTool)
+void FileAnalyzerMultiplexer::setPdfDepth(FileAnalyzerPDF::Depth depth) {
+    m_fileAnalyzerPDF.setDepth(depth);
+}
+
+void FileAnalyzerMultiplexer::setPdfValidatorPolicy(FileAnalyzerPDF::ValidatorPolicy policy) {
+    m_fileAnalyzerPDF.setValidatorPolicy(policy);
+}
+
+void FileAnalyzerMultiplexer::setupPopplerWorker(int timeout, int cpuLimitSeconds, int memoryLimitMiB) {
+    m_fileAnalyzerPDF.setupPopplerWorker(timeout, cpuLimitSeconds, memoryLimitMiB);
+}
+
+void FileAnalyzerMultiplexer::forwardCredits(int credits)
+{
+    emit creditsGranted(credits);
+    /// Analysis of a file is complete, maybe the last one
+    checkDrained();
+}
+
+bool FileAnalyzerMultiplexer::uncompressAnalyzefile(const QString &filename, const QByteArray &data, const QString &extensionWithDot, Decompressor::Format format)
 {
-    /// Default prefix for temporary file is a large random number
-    const QString randomPrefix = QString::number(qrand());
     /// Create QFileInfo object to extract the 'basename'
     const QFileInfo fi(filename.left(filename.length() - extensionWithDot.length()));
-    /// Build temporary filename
-    const QString randomTempFilename = QStringLiteral("/tmp/.docscan-") + randomPrefix + QStringLiteral("-") + fi.fileName();
 
     /// Keep track of time
     const qint64 startTime = QDateTime::currentMSecsSinceEpoch();
-    /// Keep track of success
-    bool success = true;
 
-    /// QFile objects for input and output
-    QFile inputFile(filename), outputFile(randomTempFilename);
-    QString md5prefix; ///< Recording MD5 checksums of compressed and uncompressed PDF data
+    /// Compressed data comes from either a file or memory,
+    /// uncompressed data is kept in memory only
+    QFile inputFile(filename);
+    QBuffer inputBuffer;
+    inputBuffer.setData(data);
+    QIODevice *input = data.isNull() ? static_cast<QIODevice *>(&inputFile) : static_cast<QIODevice *>(&inputBuffer);
+    QBuffer output;
     QCryptographicHash compressedMd5(QCryptographicHash::Md5), uncompressedMd5(QCryptographicHash::Md5);
-    if (inputFile.open(QFile::ReadOnly) && outputFile.open(QFile::WriteOnly)) {
-        static const qint64 buffer_size = 1 << 20; ///< 1 MB buffer size
-        static char buffer[buffer_size];
-
-        QProcess uncompressProcess(this);
-        uncompressProcess.start(uncompressTool);
-        qint64 size = 0;
-        while ((size = inputFile.read(buffer, buffer_size)) > 0) {
-            compressedMd5.addData(buffer, size); ///< Use read compressed data to compute MD5 sum
-            uncompressProcess.write(buffer, size); ///< Pipe compressed data into uncompression process
-            if (!uncompressProcess.waitForBytesWritten()) {
-                success = false;
-                break;
-            };
-
-            /// Read uncompressed data from uncompression process
-            size = qMin(uncompressProcess.bytesAvailable(), buffer_size);
-            if (size > 0) {
-                size = uncompressProcess.read(buffer, size);
-                uncompressedMd5.addData(buffer, size); ///< Use uncompressed data to compute MD5 sum
-                if (outputFile.write(buffer, size) != size) {
-                    success = false;
-                    break;
-                };
-            }
-        }
-        uncompressProcess.closeWriteChannel();
-        inputFile.close();
-        success &= uncompressProcess.waitForBytesWritten();
-
-        /// Process remaining uncompressed data after piping compressed data
-        /// to uncompression process is done
-        uncompressProcess.waitForReadyRead(500);
-        size = qMin(uncompressProcess.bytesAvailable(), buffer_size);
-        while (success && size > 0) {
-            size = uncompressProcess.read(buffer, size);
-            if (size <= 0 || outputFile.write(buffer, size) != size) {
-                success = false;
-                break;
-            };
-            uncompressProcess.waitForReadyRead(500);
-            size = qMin(uncompressProcess.bytesAvailable(), buffer_size);
-        }
-        outputFile.close();
-
-        /// Retrieve MD5 sums of compressed and uncompressed PDF data
-        md5prefix = QString::fromUtf8(compressedMd5.result().toHex()) + QChar('-') + QString::fromUtf8(uncompressedMd5.result().toHex());
-
-        /// No data may have been written to stderr by uncompression process
-        uncompressProcess.setReadChannel(QProcess::StandardError);
-        success &= uncompressProcess.read(buffer, 1) < 1;
-        /// Check if uncompression process exited ok.
-        success &= uncompressProcess.state() == QProcess::NotRunning || uncompressProcess.waitForFinished();
-        success &= uncompressProcess.exitStatus() == QProcess::NormalExit && uncompressProcess.exitCode() == 0;
+    bool success = false, sizeExceeded = false;
+    if (input->open(QIODevice::ReadOnly) && output.open(QIODevice::WriteOnly)) {
+        /// Decode in-process, computing MD5 sums on the fly
+        QString errorMessage;
+        StageTimer timer(QStringLiteral("decompress"));
+        success = Decompressor::decompress(format, input, &output, &compressedMd5, &uncompressedMd5, &errorMessage, s_maxUncompressedSize, &sizeExceeded);
+        timer.stop();
+        if (!success)
+            qWarning() << "Uncompressing" << filename << "failed:" << errorMessage;
+        input->close();
+        output.close();
     }
 
-    QString uncompressedFilename = randomTempFilename;
-    if (success && !md5prefix.isEmpty()) {
-        /// If there is a valid MD5 sum prefix, rename temporary file accordingly
-        uncompressedFilename = QStringLiteral("/tmp/.docscan-") + md5prefix + QStringLiteral("-") + fi.fileName();
-        QFile::rename(randomTempFilename, uncompressedFilename);
-    }
+    /// The uncompressed document never hits the disk, but gets a name
+    /// for reports like a temporary file, made unique by a counter, as
+    /// archives with identical content and name may occur in different
+    /// places; reports refer to the original file by this name
+    QString uniquePrefix = QString::number(uncompressedFileCounter.fetchAndAddOrdered(1));
+    if (success)
+        uniquePrefix.append(QChar('-')).append(QString::fromUtf8(compressedMd5.result().toHex())).append(QChar('-')).append(QString::fromUtf8(uncompressedMd5.result().toHex()));
+    const QString uncompressedFilename = QStringLiteral("/tmp/.docscan-") + uniquePrefix + QStringLiteral("-") + fi.fileName();
 
-    const QString logText = QString(QStringLiteral("<uncompress status=\"%1\" tool=\"%2\" time=\"%3\">\n<origin md5sum=\"%5\">%4</origin>\n<destination md5sum=\"%7\">%6</destination>\n</uncompress>")).arg(success ? QStringLiteral("success") : QStringLiteral("error"), DocScan::xmlify(uncompressTool), QString::number(QDateTime::currentMSecsSinceEpoch() - startTime), DocScan::xmlify(filename), QString::fromUtf8(compressedMd5.result().toHex()), DocScan::xmlify(uncompressedFilename), QString::fromUtf8(uncompressedMd5.result().toHex()));
+    const QString logText = QString(QStringLiteral("<uncompress status=\"%1\" tool=\"%2\" time=\"%3\">\n<origin md5sum=\"%5\">%4</origin>\n<destination md5sum=\"%7\">%6</destination>\n</uncompress>")).arg(success ? QStringLiteral("success") : QStringLiteral("error"), DocScan::xmlify(Decompressor::decoderName(format)), QString::number(QDateTime::currentMSecsSinceEpoch() - startTime), DocScan::xmlify(filename), QString::fromUtf8(compressedMd5.result().toHex()), DocScan::xmlify(uncompressedFilename), QString::fromUtf8(uncompressedMd5.result().toHex()));
     emit analysisReport(logText);
-    analyzeFile(uncompressedFilename);
-    QFile::remove(uncompressedFilename); ///< Remove uncompressed file after analysis
+    if (sizeExceeded) {
+        /// Partially uncompressed data is not worth analyzing
+        emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"uncompressed-size-limit\" status=\"error\" />\n")).arg(DocScan::xmlify(uncompressedFilename)));
+        return false;
+    }
+    /// Even if nothing could be uncompressed, the (empty) data must not be null,
+    /// otherwise the specialized analyzers would look for a file on disk
+    const QByteArray uncompressedData = output.data().isNull() ? QByteArray("") : output.data();
+    /// The uncompressed data's MD5 sum saves the PDF analyzer
+    /// from hashing the data again for its cache
+    return delegateAnalysis(uncompressedFilename, uncompressedData, success ? uncompressedMd5.result() : QByteArray());
 }
 
 void FileAnalyzerMultiplexer::analyzeFile(const QString &filename)
+{
+    if (!delegateAnalysis(filename, QByteArray(), QByteArray()))
+        emit creditsGranted(1);
+}
+
+void FileAnalyzerMultiplexer::analyzeData(const QString &filename, const QByteArray &data)
+{
+    if (!delegateAnalysis(filename, data, QByteArray()))
+        emit creditsGranted(1);
+}
+
+bool FileAnalyzerMultiplexer::delegateAnalysis(const QString &filename, const QByteArray &data, const QByteArray &contentHash)
 {
 #ifdef HAVE_QUAZIP5
-    static const QRegExp odfExtension(QStringLiteral("[.]od[pst]$"));
-    static const QRegExp openXMLExtension(QStringLiteral("[.](doc|ppt|xls)x$"));
+    const QRegExp odfExtension(QStringLiteral("[.]od[pst]$"));
+    const QRegExp openXMLExtension(QStringLiteral("[.](doc|ppt|xls)x$"));
 #endif // HAVE_QUAZIP5
 #ifdef HAVE_WV2
-    static const QRegExp compoundBinaryExtension(QStringLiteral("[.](doc|ppt|xls)$"));
+    const QRegExp compoundBinaryExtension(QStringLiteral("[.](doc|ppt|xls)$"));
 #endif // HAVE_WV2
 
     qDebug() << "Analyzing file" << filename;
 
-    if (filename.endsWith(QStringLiteral(".xz"))) {
-        uncompressAnalyzefile(filename, QStringLiteral(".xz"), QStringLiteral("unxz"));
-    } else if (filename.endsWith(QStringLiteral(".gz"))) {
-        uncompressAnalyzefile(filename, QStringLiteral(".gz"), QStringLiteral("gunzip"));
-    } else if (filename.endsWith(QStringLiteral(".bz2"))) {
-        uncompressAnalyzefile(filename, QStringLiteral(".bz2"), QStringLiteral("bunzip2"));
-    } else if (filename.endsWith(QStringLiteral(".lzma"))) {
-        uncompressAnalyzefile(filename, QStringLiteral(".lzma"), QStringLiteral("unlzma"));
+    /// Documents held in memory are passed on as they are,
+    /// without writing them to disk first
+    const bool inMemory = !data.isNull();
+    bool delegated = false;
+    Decompressor::Format compressionFormat;
+    QString compressionExtension;
+    if (Decompressor::formatForFilename(filename, compressionFormat, compressionExtension)) {
+        delegated = uncompressAnalyzefile(filename, data, compressionExtension, compressionFormat);
     } else if (filename.endsWith(QStringLiteral(".pdf"))) {
-        if (m_filters.contains(QStringLiteral("*.pdf")))
-            m_fileAnalyzerPDF.analyzeFile(filename);
-        else
+        if (m_filters.contains(QStringLiteral("*.pdf"))) {
+            if (inMemory)
+                m_fileAnalyzerPDF.analyzeData(filename, data, contentHash);
+            else
+                m_fileAnalyzerPDF.analyzeFile(filename);
+            delegated = true;
+        } else
             qDebug() << "Skipping unmatched extension \".pdf\"";
 #ifdef HAVE_QUAZIP5
     } else if (odfExtension.indexIn(filename) >= 0) {
-        if (m_filters.contains(QChar('*') + odfExtension.cap(0)))
-            m_fileAnalyzerODF.analyzeFile(filename);
-        else
+        if (m_filters.contains(QChar('*') + odfExtension.cap(0))) {
+            if (inMemory)
+                m_fileAnalyzerODF.analyzeData(filename, data);
+            else
+                m_fileAnalyzerODF.analyzeFile(filename);
+            delegated = true;
+        } else
             qDebug() << "Skipping unmatched extension" << odfExtension.cap(0);
     } else if (openXMLExtension.indexIn(filename) >= 0) {
-        if (m_filters.contains(QChar('*') + openXMLExtension.cap(0)))
-            m_fileAnalyzerOpenXML.analyzeFile(filename);
-        else
+        if (m_filters.contains(QChar('*') + openXMLExtension.cap(0))) {
+            if (inMemory)
+                m_fileAnalyzerOpenXML.analyzeData(filename, data);
+            else
+                m_fileAnalyzerOpenXML.analyzeFile(filename);
+            delegated = true;
+        } else
             qDebug() << "Skipping unmatched extension" << openXMLExtension.cap(0);
 #endif // HAVE_QUAZIP5
 #ifdef HAVE_WV2
     } else if (compoundBinaryExtension.indexIn(filename) >= 0) {
         if (m_filters.contains(QChar('*') + compoundBinaryExtension.cap(0))) {
-            m_fileAnalyzerCompoundBinary.analyzeFile(filename);
+            if (inMemory)
+                m_fileAnalyzerCompoundBinary.analyzeData(filename, data);
+            else
+                m_fileAnalyzerCompoundBinary.analyzeFile(filename);
+            delegated = true;
         } else
             qDebug() << "Skipping unmatched extension" << compoundBinaryExtension.cap(0);
 #endif // HAVE_WV2
     } else
         qWarning() << "Unknown filename extension for file " << filename;
+
+    return delegated;
 }
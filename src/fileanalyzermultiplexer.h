@@ -24,6 +24,7 @@
 #define FILEANALYZERMULTIPLEXER_H
 
 #include "fileanalyzerabstract.h"
+#include "decompressor.h"
 #ifdef HAVE_QUAZIP5
 #include "fileanalyzerodf.h"
 #include "fileanalyzeropenxml.h"
@@ -47,13 +48,35 @@ public:
 
     virtual bool isAlive();
 
+    /**
+     * Set text extraction for all specialized analyzers.
+     */
+    virtual void setTextExtraction(TextExtraction textExtraction);
+
+    /**
+     * Set the maximum size in bytes of a compressed file's uncompressed
+     * data, which is kept in memory. Files exceeding it are reported as
+     * error without being analyzed. Applies to all multiplexers; should
+     * be set before any analysis is started. Default is 1 GiB, at most
+     * 2047 MiB are possible.
+     */
+    static void setMaxUncompressedSize(qint64 maxSize);
+    static qint64 maxUncompressedSize();
+
     void setupJhove(const QString &shellscript);
     void setupVeraPDF(const QString &cliTool);
     void setupPdfBoXValidator(const QString &pdfboxValidatorJavaClass);
     void setupCallasPdfAPilotCLI(const QString &callasPdfAPilotCLI);
+    void setPdfDepth(FileAnalyzerPDF::Depth depth);
+    void setPdfValidatorPolicy(FileAnalyzerPDF::ValidatorPolicy policy);
+    void setupPopplerWorker(int timeout, int cpuLimitSeconds, int memoryLimitMiB);
 
 public slots:
     virtual void analyzeFile(const QString &filename);
+    virtual void analyzeData(const QString &filename, const QByteArray &data);
+
+private slots:
+    void forwardCredits(int credits);
 
 private:
 #ifdef HAVE_QUAZIP5
@@ -66,7 +89,23 @@ private:
 #endif // HAVE_WV2
     const QStringList &m_filters;
 
-    void uncompressAnalyzefile(const QString &filename, const QString &extension, const QString &uncompressTool);
+    static const qint64 maxUncompressedSizeLimit;
+    static qint64 s_maxUncompressedSize;
+
+    /**
+     * Pass file on to the specialized analyzer matching the file's
+     * extension. Compressed files get uncompressed into memory first.
+     * Credits granted by the specialized analyzer are forwarded,
+     * so if the file was not passed on, the caller has to grant
+     * the file's credit itself.
+     *
+     * @param filename file to analyze, or name of the document held in memory
+     * @param data the document's content, or a null array to read the file from disk
+     * @param contentHash MD5 sum of the file's content if already known, empty otherwise
+     * @return 'true' if the file was passed on to a specialized analyzer
+     */
+    bool delegateAnalysis(const QString &filename, const QByteArray &data, const QByteArray &contentHash);
+    bool uncompressAnalyzefile(const QString &filename, const QByteArray &data, const QString &extension, Decompressor::Format format);
 };
 
 #endif // FILEANALYZERMULTIPLEXER_H
@@ -31,7 +31,8 @@
 #include <QXmlDefaultHandler>
 #include <QXmlSimpleReader>
 #include <QStack>
-#include <QFileInfo>
+#include <QFile>
+#include <QBuffer>
 
 #include "watchdog.h"
 #include "general.h"
@@ -206,19 +207,37 @@ public:
 };
 
 FileAnalyzerODF::FileAnalyzerODF(QObject *parent)
-    : FileAnalyzerAbstract(parent), m_isAlive(false)
+    : FileAnalyzerAbstract(parent), m_isAlive(0)
 {
 }
 
+FileAnalyzerODF::~FileAnalyzerODF()
+{
+    waitForTextAnalyses();
+}
+
 bool FileAnalyzerODF::isAlive()
 {
-    return m_isAlive;
+    return m_isAlive.loadAcquire() != 0 || numPendingTextAnalyses() > 0;
 }
 
 void FileAnalyzerODF::analyzeFile(const QString &filename)
 {
-    m_isAlive = true;
-    QuaZip zipFile(filename);
+    QFile file(filename);
+    analyzeZipArchive(filename, file);
+}
+
+void FileAnalyzerODF::analyzeData(const QString &filename, const QByteArray &data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    analyzeZipArchive(filename, buffer);
+}
+
+void FileAnalyzerODF::analyzeZipArchive(const QString &filename, QIODevice &device)
+{
+    m_isAlive.storeRelease(1);
+    QuaZip zipFile(&device);
 
     if (zipFile.open(QuaZip::mdUnzip)) {
         ResultContainer result;
@@ -233,6 +252,8 @@ void FileAnalyzerODF::analyzeFile(const QString &filename)
             analyzeMetaXML(metaXML, result);
         } else {
             emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"invalid-meta\" status=\"error\" />\n")).arg(DocScan::xmlify(filename)));
+            m_isAlive.storeRelease(0);
+            emit creditsGranted(1);
             return;
         }
 
@@ -242,6 +263,8 @@ void FileAnalyzerODF::analyzeFile(const QString &filename)
             analyzeStylesXML(stylesXML, result);
         } else {
             emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"invalid-styles\" status=\"error\" />\n")).arg(DocScan::xmlify(filename)));
+            m_isAlive.storeRelease(0);
+            emit creditsGranted(1);
             return;
         }
 
@@ -251,6 +274,8 @@ void FileAnalyzerODF::analyzeFile(const QString &filename)
             text(contentXML, result);
         } else {
             emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"invalid-content\" status=\"error\" />\n")).arg(DocScan::xmlify(filename)));
+            m_isAlive.storeRelease(0);
+            emit creditsGranted(1);
             return;
         }
 
@@ -278,8 +303,7 @@ void FileAnalyzerODF::analyzeFile(const QString &filename)
         metaText.append(QStringLiteral("</fileformat>"));
 
         /// file information including size
-        QFileInfo fi = QFileInfo(filename);
-        metaText.append(QString(QStringLiteral("<file size=\"%1\" />")).arg(fi.size()));
+        metaText.append(QString(QStringLiteral("<file size=\"%1\" />")).arg(device.size()));
 
         /// evaluate used tool
         if (!result.toolGenerator.isEmpty())
@@ -299,13 +323,10 @@ void FileAnalyzerODF::analyzeFile(const QString &filename)
         if (!result.subject.isEmpty())
             headerText.append(result.subject);
 
-        /// evaluate language
+        /// evaluate language; the text's language gets
+        /// identified by reportAfterTextAnalysis(..)
         if (!result.language.isEmpty())
             headerText.append(result.language);
-        /* Disabling aspell, computationally expensive
-        if (result.plainText.length() > 1024)
-            headerText.append(QString(QStringLiteral("<language origin=\"aspell\">%1</language>\n")).arg(guessLanguage(result.plainText)));
-         */
 
         /// evaluate paper size
         if (result.paperSizeHeight > 0 && result.paperSizeWidth > 0)
@@ -335,12 +356,15 @@ void FileAnalyzerODF::analyzeFile(const QString &filename)
         logText.append(bodyText);
         logText += QStringLiteral("</fileanalysis>\n");
 
-        emit analysisReport(logText);
         zipFile.close();
+        m_isAlive.storeRelease(0);
+        reportAfterTextAnalysis(logText, result.plainText);
+        return;
     } else
         emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"invalid-fileformat\" status=\"error\" />\n")).arg(DocScan::xmlify(filename)));
 
-    m_isAlive = false;
+    m_isAlive.storeRelease(0);
+    emit creditsGranted(1);
 }
 
 void FileAnalyzerODF::analyzeMetaXML(QIODevice &device, ResultContainer &result)
@@ -25,6 +25,7 @@
 
 #include <QStringList>
 #include <QDate>
+#include <QAtomicInt>
 
 #include "fileanalyzerabstract.h"
 
@@ -40,11 +41,13 @@ class FileAnalyzerODF : public FileAnalyzerAbstract
     Q_OBJECT
 public:
     explicit FileAnalyzerODF(QObject *parent = nullptr);
+    ~FileAnalyzerODF();
 
     virtual bool isAlive();
 
 public slots:
     virtual void analyzeFile(const QString &filename);
+    virtual void analyzeData(const QString &filename, const QByteArray &data);
 
 private:
     enum PageCountOrigin {pcoDocument = 1, pcoOwnCount = 2};
@@ -65,8 +68,17 @@ private:
     class ODFMetaFileHandler;
     class ODFStylesFileHandler;
 
-    bool m_isAlive;
-
+    /// Read by text analysis threads via isAlive()
+    QAtomicInt m_isAlive;
+
+    /**
+     * Analyze an ODF document's ZIP archive, read through QuaZip from
+     * either a file or a buffer in memory.
+     *
+     * @param filename file name to use in the report
+     * @param device device to read the archive from, not open yet
+     */
+    void analyzeZipArchive(const QString &filename, QIODevice &device);
     void analyzeMetaXML(QIODevice &device, ResultContainer &result);
     void analyzeStylesXML(QIODevice &device, ResultContainer &result);
     void text(QIODevice &contentFile, ResultContainer &result);
@@ -30,7 +30,8 @@
 #include <QXmlDefaultHandler>
 #include <QStack>
 #include <QDebug>
-#include <QFileInfo>
+#include <QFile>
+#include <QBuffer>
 
 #include "general.h"
 
@@ -233,24 +234,42 @@ public:
 };
 
 FileAnalyzerOpenXML::FileAnalyzerOpenXML(QObject *parent)
-    : FileAnalyzerAbstract(parent), m_isAlive(false)
+    : FileAnalyzerAbstract(parent), m_isAlive(0)
 {
 }
 
+FileAnalyzerOpenXML::~FileAnalyzerOpenXML()
+{
+    waitForTextAnalyses();
+}
+
 bool FileAnalyzerOpenXML::isAlive()
 {
-    return m_isAlive;
+    return m_isAlive.loadAcquire() != 0 || numPendingTextAnalyses() > 0;
 }
 
 void FileAnalyzerOpenXML::analyzeFile(const QString &filename)
+{
+    QFile file(filename);
+    analyzeZipArchive(filename, file);
+}
+
+void FileAnalyzerOpenXML::analyzeData(const QString &filename, const QByteArray &data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    analyzeZipArchive(filename, buffer);
+}
+
+void FileAnalyzerOpenXML::analyzeZipArchive(const QString &filename, QIODevice &device)
 {
     ResultContainer result;
     result.characterCount = 0;
     result.pageCount = 0;
     result.paperSizeHeight = result.paperSizeWidth = 0;
 
-    m_isAlive = true;
-    QuaZip zipFile(filename);
+    m_isAlive.storeRelease(1);
+    QuaZip zipFile(&device);
 
     if (zipFile.open(QuaZip::mdUnzip)) {
 
@@ -271,23 +290,31 @@ void FileAnalyzerOpenXML::analyzeFile(const QString &filename)
         if (mimetype == QStringLiteral("application/vnd.openxmlformats-officedocument.wordprocessingml.document")) {
             if (!processWordFile(zipFile, result)) {
                 emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"invalid-document\" status=\"error\" />\n")).arg(DocScan::xmlify(filename)));
+                m_isAlive.storeRelease(0);
+                emit creditsGranted(1);
                 return;
             }
         }
 
         if (!processCore(zipFile, result)) {
             emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"invalid-corefile\" status=\"error\" />\n")).arg(DocScan::xmlify(filename)));
+            m_isAlive.storeRelease(0);
+            emit creditsGranted(1);
             return;
         }
 
         if (!processApp(zipFile, result)) {
             emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"invalid-appfile\" status=\"error\" />\n")).arg(DocScan::xmlify(filename)));
+            m_isAlive.storeRelease(0);
+            emit creditsGranted(1);
             return;
         }
 
         if (!processSettings(zipFile, result)) {
             if (!processSlides(zipFile, result)) {
                 emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" status=\"error\" />\n")).arg(DocScan::xmlify(filename)));
+                m_isAlive.storeRelease(0);
+                emit creditsGranted(1);
                 return;
             }
         }
@@ -303,8 +330,7 @@ void FileAnalyzerOpenXML::analyzeFile(const QString &filename)
         metaText.append(QStringLiteral("</fileformat>"));
 
         /// file information including size
-        QFileInfo fi = QFileInfo(filename);
-        metaText.append(QString(QStringLiteral("<file size=\"%1\" />")).arg(fi.size()));
+        metaText.append(QString(QStringLiteral("<file size=\"%1\" />")).arg(device.size()));
 
         /// evaluate used tool
         if (!result.toolGenerator.isEmpty())
@@ -324,11 +350,10 @@ void FileAnalyzerOpenXML::analyzeFile(const QString &filename)
         if (!result.subject.isEmpty())
             headerText.append(result.subject);
 
-        /// evaluate language
+        /// evaluate language; the text's language gets
+        /// identified by reportAfterTextAnalysis(..)
         if (!result.languageDocument.isEmpty())
             headerText.append(QString(QStringLiteral("<language origin=\"document\">%1</language>\n")).arg(result.languageDocument));
-        if (!result.languageAspell.isEmpty())
-            headerText.append(QString(QStringLiteral("<language origin=\"aspell\">%1</language>\n")).arg(result.languageAspell));
 
         /// evaluate paper size
         if (result.paperSizeHeight > 0 && result.paperSizeWidth > 0)
@@ -356,13 +381,15 @@ void FileAnalyzerOpenXML::analyzeFile(const QString &filename)
         logText.append(bodyText);
         logText += QStringLiteral("</fileanalysis>\n");
 
-        emit analysisReport(logText);
-
         zipFile.close();
+        m_isAlive.storeRelease(0);
+        reportAfterTextAnalysis(logText, result.plainText);
+        return;
     } else
         emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"invalid-fileformat\" status=\"error\" />\n")).arg(DocScan::xmlify(filename)));
 
-    m_isAlive = false;
+    m_isAlive.storeRelease(0);
+    emit creditsGranted(1);
 }
 
 bool FileAnalyzerOpenXML::processWordFile(QuaZip &zipFile, ResultContainer &result)
@@ -371,10 +398,6 @@ bool FileAnalyzerOpenXML::processWordFile(QuaZip &zipFile, ResultContainer &resu
         QuaZipFile documentFile(&zipFile, parent());
         if (documentFile.open(QIODevice::ReadOnly)) {
             text(documentFile, result);
-            /* Disabling aspell, computationally expensive
-            if (result.plainText.length() > 1024)
-                result.languageAspell = guessLanguage(result.plainText);
-             */
             documentFile.close();
             return true;
         }
@@ -24,6 +24,7 @@
 #define FILEANALYZEROPENXML_H
 
 #include <QStringList>
+#include <QAtomicInt>
 
 #include "fileanalyzerabstract.h"
 
@@ -40,11 +41,13 @@ class FileAnalyzerOpenXML : public FileAnalyzerAbstract
     Q_OBJECT
 public:
     explicit FileAnalyzerOpenXML(QObject *parent = nullptr);
+    ~FileAnalyzerOpenXML();
 
     virtual bool isAlive();
 
 public slots:
     virtual void analyzeFile(const QString &filename);
+    virtual void analyzeData(const QString &filename, const QByteArray &data);
 
 private:
     typedef struct {
@@ -52,7 +55,7 @@ private:
         QString formatVersion;
         QString authorInitial, authorLast;
         QString title, subject;
-        QString languageAspell, languageDocument;
+        QString languageDocument;
         QString dateCreation, dateModification;
         int pageCount;
         QString plainText;
@@ -66,8 +69,17 @@ private:
     class OpenXMLSettingsHandler;
     class OpenXMLSlideHandler;
 
-    bool m_isAlive;
-
+    /// Read by text analysis threads via isAlive()
+    QAtomicInt m_isAlive;
+
+    /**
+     * Analyze an Office Open XML document's ZIP archive, read through
+     * QuaZip from either a file or a buffer in memory.
+     *
+     * @param filename file name to use in the report
+     * @param device device to read the archive from, not open yet
+     */
+    void analyzeZipArchive(const QString &filename, QIODevice &device);
     bool processWordFile(QuaZip &zipFile, ResultContainer &result);
     bool processCore(QuaZip &zipFile, ResultContainer &result);
     bool processApp(QuaZip &zipFile, ResultContainer &result);
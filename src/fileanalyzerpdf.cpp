@@ -22,17 +22,35 @@
 
 #include "fileanalyzerpdf.h"
 
+#include <climits>
+
+#include <unistd.h>
+#include <sys/resource.h>
+
 #include <QFileInfo>
+#include <QFile>
 #include <QDebug>
 #include <QDateTime>
-#include <QProcess>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
 #include <QCoreApplication>
 #include <QDir>
+#include <QTemporaryFile>
 #include <QRegularExpression>
+#include <QXmlStreamReader>
+#include <QHash>
+#include <QMap>
 
 #include "popplerwrapper.h"
+#include "analysiscache.h"
+#include "textstore.h"
+#include "validatorscheduler.h"
+#include "stagetiming.h"
 #include "watchdog.h"
 #include "guessing.h"
+#include "languageidentifier.h"
+#include "textanalysis.h"
 #include "general.h"
 
 static const int oneMinuteInMillisec = 60000;
@@ -40,246 +58,680 @@ static const int twoMinutesInMillisec = oneMinuteInMillisec * 2;
 static const int fourMinutesInMillisec = oneMinuteInMillisec * 4;
 static const int sixMinutesInMillisec = oneMinuteInMillisec * 6;
 
-FileAnalyzerPDF::FileAnalyzerPDF(QObject *parent)
-    : FileAnalyzerAbstract(parent), m_isAlive(false)
+/// Assumed run time in microseconds of validators not measured yet,
+/// used to order validators for FileAnalyzerPDF::vpCostAware
+static qint64 assumedRunTime(ValidatorScheduler::Tool tool)
 {
-    // nothing
+    switch (tool) {
+    case ValidatorScheduler::JHove: return 2000000;
+    case ValidatorScheduler::PdfBoxValidator: return 3000000;
+    case ValidatorScheduler::CallasPdfAPilot: return 10000000;
+    default: return 30000000;
+    }
 }
 
-bool FileAnalyzerPDF::isAlive()
+/// External programs should be both CPU and I/O 'nice'
+static const QStringList defaultArgumentsForNice = QStringList() << QStringLiteral("-n") << QStringLiteral("17") << QStringLiteral("ionice") << QStringLiteral("-c") << QStringLiteral("3");
+
+/**
+ * Extracts veraPDF's verdicts from its XML report while veraPDF is
+ * still running, so that the report itself does not have to be kept
+ * in memory in its entirety.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class VeraPDFOutputParser : public ValidatorOutputParser
 {
-    return m_isAlive;
-}
+public:
+    /// Set once the closing 'rawResults' or 'ns2:cliReport' tag has been
+    /// read, or the closing 'job' tag of a file validated in a batch
+    bool complete;
+    /// Set if the report is not well-formed XML
+    bool malformed;
+    /// First validation profile flavour reported, e.g. 'PDFA_1_B'
+    QString firstFlavour;
+    /// Flavour mapped to whether the file is compliant to it
+    QHash<QString, bool> compliance;
+    long itemSize;
 
-void FileAnalyzerPDF::setupJhove(const QString &shellscript)
+    VeraPDFOutputParser()
+        : complete(false), malformed(false), itemSize(0)
+    {
+        /// nothing
+    }
+
+    void addData(const QByteArray &data) override {
+        if (malformed) return;
+        m_reader.addData(data);
+        while (!m_reader.atEnd()) {
+            const QXmlStreamReader::TokenType token = m_reader.readNext();
+            if (token == QXmlStreamReader::StartElement) {
+                const QXmlStreamAttributes attributes = m_reader.attributes();
+                if (attributes.hasAttribute(QStringLiteral("flavour"))) {
+                    m_pendingFlavour = attributes.value(QStringLiteral("flavour")).toString();
+                    if (firstFlavour.isEmpty()) firstFlavour = m_pendingFlavour;
+                }
+                /// Verdict is either an attribute of the element naming
+                /// the flavour or of an element following it
+                if (!m_pendingFlavour.isEmpty() && (attributes.hasAttribute(QStringLiteral("isCompliant")) || attributes.hasAttribute(QStringLiteral("recordPasses")))) {
+                    compliance.insert(m_pendingFlavour, attributes.value(QStringLiteral("isCompliant")) == QStringLiteral("true") || attributes.value(QStringLiteral("recordPasses")) == QStringLiteral("true"));
+                    m_pendingFlavour.clear();
+                }
+                if (itemSize == 0 && m_reader.name() == QStringLiteral("item") && attributes.hasAttribute(QStringLiteral("size"))) {
+                    bool ok = false;
+                    itemSize = attributes.value(QStringLiteral("size")).toString().toLong(&ok);
+                    if (!ok) itemSize = 0;
+                }
+            } else if (token == QXmlStreamReader::EndElement) {
+                if (m_reader.qualifiedName() == QStringLiteral("rawResults") || m_reader.qualifiedName() == QStringLiteral("ns2:cliReport") || m_reader.qualifiedName() == QStringLiteral("job"))
+                    complete = true;
+            }
+        }
+        /// Running out of data is expected until veraPDF is done
+        if (m_reader.hasError() && m_reader.error() != QXmlStreamReader::PrematureEndOfDocumentError)
+            malformed = true;
+    }
+
+    void reset() override {
+        m_reader.clear();
+        m_pendingFlavour.clear();
+        complete = malformed = false;
+        firstFlavour.clear();
+        compliance.clear();
+        itemSize = 0;
+    }
+
+    bool isCompliant(const QString &flavour) const {
+        return compliance.value(flavour, false);
+    }
+
+private:
+    QXmlStreamReader m_reader;
+    QString m_pendingFlavour;
+};
+
+/**
+ * Picks jHove's findings from its text output line by line while
+ * jHove is still running.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class JHoveOutputParser : public ValidatorOutputParser
 {
-    m_jhoveShellscript = shellscript;
-}
+public:
+    bool hasOutput;
+    bool formatIsPDF, hasErrorMessage;
+    /// First values reported for the respective keys
+    QString status, version, profile;
 
-void FileAnalyzerPDF::setupVeraPDF(const QString &cliTool)
+    JHoveOutputParser()
+        : hasOutput(false), formatIsPDF(false), hasErrorMessage(false)
+    {
+        /// nothing
+    }
+
+    void addData(const QByteArray &data) override {
+        hasOutput = true;
+        m_buffer.append(data);
+        int start = 0, eol;
+        while ((eol = m_buffer.indexOf('\n', start)) >= 0) {
+            parseLine(QString::fromUtf8(m_buffer.constData() + start, eol - start));
+            start = eol + 1;
+        }
+        m_buffer.remove(0, start);
+    }
+
+    void finish() override {
+        if (!m_buffer.isEmpty())
+            parseLine(QString::fromUtf8(m_buffer));
+        m_buffer.clear();
+    }
+
+    void reset() override {
+        m_buffer.clear();
+        hasOutput = formatIsPDF = hasErrorMessage = false;
+        status.clear();
+        version.clear();
+        profile.clear();
+    }
+
+private:
+    QByteArray m_buffer;
+
+    void parseLine(const QString &line) {
+        if (line.contains(QStringLiteral("Format: PDF"))) formatIsPDF = true;
+        if (line.contains(QStringLiteral("ErrorMessage:"))) hasErrorMessage = true;
+        if (status.isEmpty()) status = valueForKey(line, QStringLiteral("Status: "));
+        if (version.isEmpty()) version = valueForKey(line, QStringLiteral("Version: "));
+        if (profile.isEmpty()) profile = valueForKey(line, QStringLiteral("Profile: "));
+    }
+
+    /// Text following the key in this line, where the key has to start a word
+    static QString valueForKey(const QString &line, const QString &key) {
+        int p = line.indexOf(key);
+        while (p > 0 && line.at(p - 1).isLetterOrNumber())
+            p = line.indexOf(key, p + 1);
+        return p >= 0 ? line.mid(p + key.length()).trimmed() : QString();
+    }
+};
+
+/**
+ * Keeps the end of callas pdfaPilot's output, where its summary is
+ * printed, no matter how long the output is.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class CallasPdfAPilotOutputParser : public ValidatorOutputParser
 {
-    m_veraPDFcliTool = cliTool;
-}
+public:
+    QByteArray tail;
 
-void FileAnalyzerPDF::setupPdfBoXValidator(const QString &pdfboxValidatorJavaClass) {
-    m_pdfboxValidatorJavaClass = pdfboxValidatorJavaClass;
-}
+    void addData(const QByteArray &data) override {
+        tail.append(data);
+        if (tail.length() > 512)
+            tail = tail.right(512);
+    }
 
-void FileAnalyzerPDF::setupCallasPdfAPilotCLI(const QString &callasPdfAPilotCLI) {
-    m_callasPdfAPilotCLI = callasPdfAPilotCLI;
-}
+    void reset() override {
+        tail.clear();
+    }
+};
 
-void FileAnalyzerPDF::analyzeFile(const QString &filename)
+/**
+ * Splits veraPDF's report on several files into one 'job'
+ * element per file.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class VeraPDFBatchSplitter : public ValidatorBatchSplitter
 {
-    if (filename.endsWith(QStringLiteral(".xz")) || filename.endsWith(QStringLiteral(".gz")) || filename.endsWith(QStringLiteral(".bz2")) || filename.endsWith(QStringLiteral(".lzma"))) {
-        /// File is compressed
-        qWarning() << "Compressed files like " << filename << " should not directly send through this analyzer, but rather be uncompressed by FileAnalyzerMultiplexer first";
-        m_isAlive = false;
-        return;
+public:
+    static ValidatorBatchSplitter *create() {
+        return new VeraPDFBatchSplitter();
+    }
+
+    QList<Segment> addData(const QByteArray &data) override {
+        static const QByteArray jobEnd("</job>");
+        QList<Segment> segments;
+        m_buffer.append(data);
+        forever {
+            if (m_file.isNull()) {
+                /// Skip anything before the next 'job' element
+                const int start = indexOfJobStart();
+                if (start < 0) {
+                    /// Keep what may be the beginning of a start tag
+                    m_buffer = m_buffer.right(4);
+                    break;
+                }
+                m_buffer.remove(0, start);
+                /// File's name has to be known before passing on its report
+                const int p1 = m_buffer.indexOf("<name>");
+                const int p2 = p1 >= 0 ? m_buffer.indexOf("</name>", p1) : -1;
+                if (p2 < 0) break;
+                m_file = unescape(QString::fromUtf8(m_buffer.mid(p1 + 6, p2 - p1 - 6)));
+            }
+
+            Segment segment;
+            segment.file = m_file;
+            const int end = m_buffer.indexOf(jobEnd);
+            segment.complete = end >= 0;
+            if (segment.complete) {
+                segment.data = m_buffer.left(end + jobEnd.length());
+                m_buffer.remove(0, end + jobEnd.length());
+                m_file = QString();
+            } else {
+                /// Keep what may be the beginning of the end tag
+                const int length = qMax(0, m_buffer.length() - jobEnd.length());
+                segment.data = m_buffer.left(length);
+                m_buffer.remove(0, length);
+            }
+            if (!segment.data.isEmpty() || segment.complete)
+                segments.append(segment);
+            if (!segment.complete) break;
+        }
+        return segments;
+    }
+
+    QList<Segment> finish() override {
+        QList<Segment> segments;
+        if (!m_file.isNull() && !m_buffer.isEmpty()) {
+            /// Incomplete report, file will be validated again
+            Segment segment;
+            segment.file = m_file;
+            segment.data = m_buffer;
+            segment.complete = false;
+            segments.append(segment);
+        }
+        m_buffer.clear();
+        return segments;
+    }
+
+private:
+    QByteArray m_buffer;
+    QString m_file;
+
+    int indexOfJobStart() const {
+        int p = m_buffer.indexOf("<job");
+        /// Skip the enclosing 'jobs' element
+        while (p >= 0 && p + 4 < m_buffer.length() && m_buffer.at(p + 4) != '>' && m_buffer.at(p + 4) != ' ')
+            p = m_buffer.indexOf("<job", p + 4);
+        return p + 4 < m_buffer.length() ? p : -1;
+    }
+
+    static QString unescape(QString text) {
+        return text.replace(QStringLiteral("&lt;"), QStringLiteral("<")).replace(QStringLiteral("&gt;"), QStringLiteral(">")).replace(QStringLiteral("&quot;"), QStringLiteral("\"")).replace(QStringLiteral("&apos;"), QStringLiteral("'")).replace(QStringLiteral("&amp;"), QStringLiteral("&"));
+    }
+};
+
+/**
+ * Splits jHove's text output on several files at the
+ * 'RepInfo' lines starting each file's section.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class JHoveBatchSplitter : public ValidatorBatchSplitter
+{
+public:
+    static ValidatorBatchSplitter *create() {
+        return new JHoveBatchSplitter();
+    }
+
+    QList<Segment> addData(const QByteArray &data) override {
+        QList<Segment> segments;
+        m_buffer.append(data);
+        int start = 0, eol;
+        while ((eol = m_buffer.indexOf('\n', start)) >= 0) {
+            addLine(m_buffer.mid(start, eol + 1 - start), segments);
+            start = eol + 1;
+        }
+        m_buffer.remove(0, start);
+        flush(segments, false);
+        return segments;
+    }
+
+    QList<Segment> finish() override {
+        QList<Segment> segments;
+        if (!m_buffer.isEmpty())
+            addLine(m_buffer, segments);
+        m_buffer.clear();
+        /// Last file's section ends with the output
+        flush(segments, true);
+        return segments;
+    }
+
+private:
+    QByteArray m_buffer;
+    QString m_file;
+    /// Lines of the current file's section not yet passed on
+    QByteArray m_pending;
+
+    void addLine(const QByteArray &line, QList<Segment> &segments) {
+        static const QByteArray repInfo("RepInfo: ");
+        const QByteArray trimmedLine = line.trimmed();
+        if (trimmedLine.startsWith(repInfo)) {
+            /// Section of the previous file is complete
+            flush(segments, true);
+            m_file = QString::fromUtf8(trimmedLine.mid(repInfo.length()));
+        }
+        /// Lines before the first file's section are dropped
+        if (!m_file.isNull())
+            m_pending.append(line);
+    }
+
+    void flush(QList<Segment> &segments, bool complete) {
+        if (m_file.isNull() || (m_pending.isEmpty() && !complete)) return;
+        Segment segment;
+        segment.file = m_file;
+        segment.data = m_pending;
+        segment.complete = complete;
+        segments.append(segment);
+        m_pending.clear();
+        if (complete)
+            m_file = QString();
+    }
+};
+
+/**
+ * Pages of a PDF document, whose text gets extracted
+ * only if sampled for identifying the document's language.
+ */
+class PdfPageTextSource : public TextSource
+{
+public:
+    explicit PdfPageTextSource(const PopplerWrapper *wrapper)
+        : m_wrapper(wrapper) {
+        /// nothing
+    }
+
+    int numParts() {
+        return m_wrapper->numPages();
+    }
+
+    QString part(int index) {
+        return m_wrapper->pagePlainText(index);
     }
 
+private:
+    const PopplerWrapper *m_wrapper;
+};
+
+/**
+ * State of a PDF file's analysis while waiting for its validators.
+ * Results of each validator are evaluated as soon as the validator
+ * is done; the report is assembled by FileAnalyzerPDF once all
+ * validators are done.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class PdfValidationJob : public ValidatorJob
+{
+public:
+    FileAnalyzerPDF *analyzer;
+    /// Name of the file as used in the report
+    const QString filename;
+    /// File passed to validators, a temporary copy for documents held in memory
+    const QString validatorFilename;
+    const qint64 fileSize;
+    /// Set if validatorFilename is a temporary copy to be removed
+    const bool removeAfterAnalysis;
+    /// Key for the analysis cache, empty if the cache is not used
+    const QString cacheKey;
+    const qint64 startTime;
+    /// Set if a validator failed for reasons that may not apply next time,
+    /// in which case the report must not be cached
+    bool transientFailure;
+    /// Set if runs got dropped as the validator scheduler was shut down
+    bool validationAborted;
+    qint64 externalProgramsEndTime;
+
+    /// Results from poppler, set before the job gets released
+    /// or, if analyzed in a worker process, once the worker is done
+    bool popplerWrapperOk;
     QString logText, metaText;
-    m_isAlive = true;
-    const qint64 startTime = QDateTime::currentMSecsSinceEpoch();
+    /// Set if the worker process analyzing this file was killed
+    bool popplerWorkerTimedOut, popplerWorkerAborted;
 
-    /// External programs should be both CPU and I/O 'nice'
-    static const QStringList defaultArgumentsForNice = QStringList() << QStringLiteral("-n") << QStringLiteral("17") << QStringLiteral("ionice") << QStringLiteral("-c") << QStringLiteral("3");
+    /// Validators yet to start if run one after another, cheapest first
+    QList<ValidatorScheduler::Tool> remainingValidators;
+    /// Set while a further run of the current validator is pending
+    bool followUpPending;
+    /// Reason why a validator was not run, by tool
+    QHash<int, QString> skippedValidators;
 
-    bool veraPDFStartedRun1 = false, veraPDFStartedRun2 = false;
-    bool veraPDFIsPDFA1B = false, veraPDFIsPDFA1A = false;
+    bool veraPDFIsPDFA1B, veraPDFIsPDFA1A;
+    /// Output of both runs is parsed while veraPDF is running,
+    /// keeping only an excerpt of limited size
+    VeraPDFOutputParser veraPDFParser[2];
     QString veraPDFStandardOutput;
     QString veraPDFErrorOutput;
-    long veraPDFfilesize = 0;
-    int veraPDFExitCode = INT_MIN;
-    QProcess veraPDF(this);
-    if (!m_veraPDFcliTool.isEmpty()) {
-        const QStringList arguments = QStringList(defaultArgumentsForNice) << m_veraPDFcliTool << QStringLiteral("-x") << QStringLiteral("-f") /** Chooses built-in Validation Profile flavour, e.g. '1b'. */ << QStringLiteral("1b") << QStringLiteral("--maxfailures") << QStringLiteral("1") << QStringLiteral("--format") << QStringLiteral("xml") << filename;
-        veraPDF.start(QStringLiteral("/usr/bin/nice"), arguments, QIODevice::ReadOnly);
-        veraPDFStartedRun1 = veraPDF.waitForStarted(twoMinutesInMillisec);
-        if (!veraPDFStartedRun1)
-            qWarning() << "Failed to start veraPDF for file " << filename << " and " << veraPDF.program() << veraPDF.arguments().join(' ') << " in directory " << veraPDF.workingDirectory();
-    }
-
-    bool callasPdfAPilotStartedRun1 = false, callasPdfAPilotStartedRun2 = false;
+    long veraPDFfilesize;
+    int veraPDFExitCode;
+
+    CallasPdfAPilotOutputParser callasPdfAPilotParser[2];
     QString callasPdfAPilotStandardOutput;
     QString callasPdfAPilotErrorOutput;
-    int callasPdfAPilotExitCode = INT_MIN;
-    int callasPdfAPilotCountErrors = -1;
-    int callasPdfAPilotCountWarnings = -1;
-    char callasPdfAPilotPDFA1letter = '\0';
-    QProcess callasPdfAPilot(this);
-    if (!m_callasPdfAPilotCLI.isEmpty()) {
-        const QStringList arguments = QStringList() << defaultArgumentsForNice << m_callasPdfAPilotCLI << QStringLiteral("--quickpdfinfo") << filename;
-        callasPdfAPilot.start(QStringLiteral("/usr/bin/nice"), arguments, QIODevice::ReadOnly);
-        callasPdfAPilotStartedRun1 = callasPdfAPilot.waitForStarted(oneMinuteInMillisec);
-        if (!callasPdfAPilotStartedRun1)
-            qWarning() << "Failed to start callas PDF/A Pilot for file " << filename << " and " << callasPdfAPilot.program() << callasPdfAPilot.arguments().join(' ') << " in directory " << callasPdfAPilot.workingDirectory();
-    }
-
-    bool jhoveStarted = false;
-    bool jhoveIsPDF = false;
-    bool jhovePDFWellformed = false, jhovePDFValid = false;
+    int callasPdfAPilotExitCode;
+    int callasPdfAPilotCountErrors;
+    int callasPdfAPilotCountWarnings;
+    char callasPdfAPilotPDFA1letter;
+
+    JHoveOutputParser jhoveParser;
+    bool jhoveIsPDF;
+    bool jhovePDFWellformed, jhovePDFValid;
     QString jhovePDFversion;
     QString jhovePDFprofile;
     QString jhoveStandardOutput;
     QString jhoveErrorOutput;
-    int jhoveExitCode = INT_MIN;
-    QProcess jhove(this);
-    if (!m_jhoveShellscript.isEmpty()) {
-        const QStringList arguments = QStringList(defaultArgumentsForNice) << QStringLiteral("/bin/bash") << m_jhoveShellscript << QStringLiteral("-m") << QStringLiteral("PDF-hul") << QStringLiteral("-t") << QStringLiteral("/tmp") << QStringLiteral("-b") << QStringLiteral("131072") << filename;
-        jhove.start(QStringLiteral("/usr/bin/nice"), arguments, QIODevice::ReadOnly);
-        jhoveStarted = jhove.waitForStarted(oneMinuteInMillisec);
-        if (!jhoveStarted)
-            qWarning() << "Failed to start jhove for file " << filename << " and " << jhove.program() << jhove.arguments().join(' ') << " in directory " << jhove.workingDirectory();
-    }
-
-    bool pdfboxValidatorStarted = false;
-    bool pdfboxValidatorValidPdf = false;
+    int jhoveExitCode;
+
+    bool pdfboxValidatorValidPdf;
     QString pdfboxValidatorStandardOutput;
     QString pdfboxValidatorErrorOutput;
-    int pdfboxValidatorExitCode = INT_MIN;
-    QProcess pdfboxValidator(this);
-    if (!m_pdfboxValidatorJavaClass.isEmpty()) {
-        const QFileInfo fi(m_pdfboxValidatorJavaClass);
-        const QDir dir = fi.dir();
-        const QStringList jarFiles = dir.entryList(QStringList() << QStringLiteral("*.jar"), QDir::Files, QDir::Name);
-        pdfboxValidator.setWorkingDirectory(dir.path());
-        const QStringList arguments = QStringList(defaultArgumentsForNice) << QStringLiteral("java") << QStringLiteral("-cp") << QStringLiteral(".:") + jarFiles.join(':') << fi.fileName().remove(QStringLiteral(".class")) << filename;
-        pdfboxValidator.start(QStringLiteral("/usr/bin/nice"), arguments, QIODevice::ReadOnly);
-        pdfboxValidatorStarted = pdfboxValidator.waitForStarted(oneMinuteInMillisec);
-        if (!pdfboxValidatorStarted)
-            qWarning() << "Failed to start pdfbox Validator for file " << filename << " and " << pdfboxValidator.program() << pdfboxValidator.arguments().join(' ') << " in directory " << pdfboxValidator.workingDirectory() << ": " << pdfboxValidatorErrorOutput;
-    }
-
-    if (veraPDFStartedRun1) {
-        if (!veraPDF.waitForFinished(sixMinutesInMillisec))
-            qWarning() << "Waiting for veraPDF failed or exceeded time limit for file " << filename << " and " << veraPDF.program() << veraPDF.arguments().join(' ') << " in directory " << veraPDF.workingDirectory();
-        veraPDFExitCode = veraPDF.exitCode();
-        veraPDFStandardOutput = QString::fromUtf8(veraPDF.readAllStandardOutput().constData());
-        /// Sometimes veraPDF does not return complete and valid XML code. veraPDF's bug or DocScan's bug?
-        if ((!veraPDFStandardOutput.contains(QStringLiteral("<rawResults>")) || !veraPDFStandardOutput.contains(QStringLiteral("</rawResults>"))) && (!veraPDFStandardOutput.contains(QStringLiteral("<ns2:cliReport")) || !veraPDFStandardOutput.contains(QStringLiteral("</ns2:cliReport>"))))
-            veraPDFStandardOutput = QStringLiteral("<error>No matching opening and closing 'rawResults' or 'ns2:cliReport' tags found in output:\n") + DocScan::xmlify(veraPDFStandardOutput) + QStringLiteral("</error>");
-        veraPDFErrorOutput = QString::fromUtf8(veraPDF.readAllStandardError().constData());
-        if (veraPDFExitCode == 0 && !veraPDFStandardOutput.isEmpty()) {
-            const QString startOfOutput = veraPDFStandardOutput.left(8192);
-            const int p1 = startOfOutput.indexOf(QStringLiteral(" flavour=\"PDF"));
-            const int p2 = startOfOutput.indexOf(QStringLiteral(" flavour=\"PDFA_1_B\""), p1);
-            const int p3a = startOfOutput.indexOf(QStringLiteral(" isCompliant=\"true\""), p2 - 64);
-            const int p3b = startOfOutput.indexOf(QStringLiteral(" recordPasses=\"true\""), p2 - 64);
-            veraPDFIsPDFA1B = p1 == p2 && ((p3a > 0 && p3a < p2 + 64) || (p3b > 0 && p3b < p2 + 64));
-            const int p4 = startOfOutput.indexOf(QStringLiteral("item size=\""));
-            if (p4 > 1) {
-                const int p5 = startOfOutput.indexOf(QStringLiteral("\""), p4 + 11);
-                if (p5 > p4) {
-                    bool ok = false;
-                    veraPDFfilesize = startOfOutput.mid(p4 + 11, p5 - p4 - 11).toLong(&ok);
-                    if (!ok) veraPDFfilesize = 0;
-                }
+    int pdfboxValidatorExitCode;
+
+    PdfValidationJob(FileAnalyzerPDF *_analyzer, const QString &_filename, const QString &_validatorFilename, qint64 _fileSize, bool _removeAfterAnalysis, const QString &_cacheKey)
+        : analyzer(_analyzer), filename(_filename), validatorFilename(_validatorFilename), fileSize(_fileSize), removeAfterAnalysis(_removeAfterAnalysis), cacheKey(_cacheKey), startTime(QDateTime::currentMSecsSinceEpoch()), transientFailure(false), validationAborted(false), externalProgramsEndTime(startTime), popplerWrapperOk(false), popplerWorkerTimedOut(false), popplerWorkerAborted(false), followUpPending(false),
+          veraPDFIsPDFA1B(false), veraPDFIsPDFA1A(false), veraPDFfilesize(0), veraPDFExitCode(INT_MIN),
+          callasPdfAPilotExitCode(INT_MIN), callasPdfAPilotCountErrors(-1), callasPdfAPilotCountWarnings(-1), callasPdfAPilotPDFA1letter('\0'),
+          jhoveIsPDF(false), jhovePDFWellformed(false), jhovePDFValid(false), jhoveExitCode(INT_MIN),
+          pdfboxValidatorValidPdf(false), pdfboxValidatorExitCode(INT_MIN)
+    {
+        /// nothing
+    }
+
+    void toolFinished(int tool, int tag, const ValidatorResult &result) {
+        externalProgramsEndTime = QDateTime::currentMSecsSinceEpoch();
+        if (!result.started || result.timedOut)
+            transientFailure = true;
+        if (result.aborted) {
+            /// Report whatever is known so far, submitting further runs is pointless
+            validationAborted = true;
+            return;
+        }
+
+        followUpPending = false;
+        switch (tool) {
+        case ValidatorScheduler::VeraPDF:
+            if (tag == 1) veraPDFRun1Finished(result); else veraPDFRun2Finished(result);
+            break;
+        case ValidatorScheduler::CallasPdfAPilot:
+            if (tag == 1) callasPdfAPilotRun1Finished(result); else callasPdfAPilotRun2Finished(result);
+            break;
+        case ValidatorScheduler::JHove:
+            jhoveFinished(result);
+            break;
+        case ValidatorScheduler::PdfBoxValidator:
+            pdfboxValidatorFinished(result);
+            break;
+        case ValidatorScheduler::PopplerWorker:
+            popplerWorkerFinished(result);
+            break;
+        }
+
+        if (analyzer->m_validatorPolicy == FileAnalyzerPDF::vpCostAware && !followUpPending)
+            submitNextValidator();
+    }
+
+    void allToolsFinished() {
+        analyzer->analysisComplete(this);
+    }
+
+    /**
+     * Queue the first run of a validator for this file.
+     */
+    void submitValidator(ValidatorScheduler::Tool tool) {
+        ValidatorScheduler *scheduler = ValidatorScheduler::instance();
+        switch (tool) {
+        case ValidatorScheduler::VeraPDF: {
+            const QStringList arguments = QStringList(defaultArgumentsForNice) << analyzer->m_veraPDFcliTool << QStringLiteral("-x") << QStringLiteral("-f") /** Chooses built-in Validation Profile flavour, e.g. '1b'. */ << QStringLiteral("1b") << QStringLiteral("--maxfailures") << QStringLiteral("1") << QStringLiteral("--format") << QStringLiteral("xml");
+            scheduler->submitBatchable(this, ValidatorScheduler::VeraPDF, 1, QStringLiteral("/usr/bin/nice"), arguments, validatorFilename, QString(), sixMinutesInMillisec, &veraPDFParser[0]);
+            break;
+        }
+        case ValidatorScheduler::CallasPdfAPilot: {
+            const QStringList arguments = QStringList() << defaultArgumentsForNice << analyzer->m_callasPdfAPilotCLI << QStringLiteral("--quickpdfinfo") << validatorFilename;
+            scheduler->submit(this, ValidatorScheduler::CallasPdfAPilot, 1, QStringLiteral("/usr/bin/nice"), arguments, QString(), twoMinutesInMillisec, &callasPdfAPilotParser[0]);
+            break;
+        }
+        case ValidatorScheduler::JHove: {
+            const QStringList arguments = QStringList(defaultArgumentsForNice) << QStringLiteral("/bin/bash") << analyzer->m_jhoveShellscript << QStringLiteral("-m") << QStringLiteral("PDF-hul") << QStringLiteral("-t") << QStringLiteral("/tmp") << QStringLiteral("-b") << QStringLiteral("131072");
+            scheduler->submitBatchable(this, ValidatorScheduler::JHove, 1, QStringLiteral("/usr/bin/nice"), arguments, validatorFilename, QString(), fourMinutesInMillisec, &jhoveParser);
+            break;
+        }
+        case ValidatorScheduler::PdfBoxValidator: {
+            const QFileInfo fi(analyzer->m_pdfboxValidatorJavaClass);
+            const QDir dir = fi.dir();
+            const QStringList jarFiles = dir.entryList(QStringList() << QStringLiteral("*.jar"), QDir::Files, QDir::Name);
+            const QStringList arguments = QStringList(defaultArgumentsForNice) << QStringLiteral("java") << QStringLiteral("-cp") << QStringLiteral(".:") + jarFiles.join(':') << fi.fileName().remove(QStringLiteral(".class"));
+            if (scheduler->serverMode(ValidatorScheduler::PdfBoxValidator) && !validatorFilename.contains(QLatin1Char('\n')))
+                /// Pass filename to an already running JVM instead of starting a new one
+                scheduler->submitToServer(this, ValidatorScheduler::PdfBoxValidator, 1, QStringLiteral("/usr/bin/nice"), QStringList(arguments) << QStringLiteral("--server"), dir.path(), QFileInfo(validatorFilename).absoluteFilePath().toUtf8(), twoMinutesInMillisec);
+            else
+                scheduler->submit(this, ValidatorScheduler::PdfBoxValidator, 1, QStringLiteral("/usr/bin/nice"), QStringList(arguments) << validatorFilename, dir.path(), twoMinutesInMillisec);
+            break;
+        }
+        case ValidatorScheduler::PopplerWorker:
+            /// No validator
+            break;
+        }
+    }
+
+    /**
+     * Start the next validator in order of cost whose result is not
+     * settled yet by previous results, skipping the others.
+     */
+    void submitNextValidator() {
+        /// If poppler could not make sense of the file, let
+        /// jHove tell first if it is a PDF file at all
+        if (!popplerWrapperOk && remainingValidators.removeOne(ValidatorScheduler::JHove))
+            remainingValidators.prepend(ValidatorScheduler::JHove);
+
+        while (!remainingValidators.isEmpty()) {
+            const ValidatorScheduler::Tool tool = remainingValidators.takeFirst();
+            const QString reason = skipReason(tool);
+            if (reason.isEmpty()) {
+                submitValidator(tool);
+                return;
             }
+            qDebug() << "Skipping validator" << tool << "for file" << filename << "as" << reason;
+            skippedValidators.insert(tool, reason);
+        }
+    }
+
+private:
+    /**
+     * Reason why running a validator is pointless given the results
+     * so far, or an empty string if it has to run.
+     */
+    QString skipReason(ValidatorScheduler::Tool tool) const {
+        if (jhoveExitCode == 0 && !jhoveIsPDF)
+            return QStringLiteral("not-pdf");
+        if (tool != ValidatorScheduler::JHove && !popplerWrapperOk && !jhoveIsPDF)
+            /// Includes files making poppler exceed its limits in a worker process
+            return QStringLiteral("unreadable");
+        if (tool != ValidatorScheduler::JHove && metaText.contains(QStringLiteral(" encrypted=\"yes\"")))
+            /// PDF/A does not permit encryption
+            return QStringLiteral("encrypted");
+        return QString();
+    }
+
+    void popplerWorkerFinished(const ValidatorResult &result) {
+        if (!result.started) {
+            qWarning() << "Failed to start worker process for file " << filename << " and " << result.commandLine;
+            popplerWorkerAborted = true;
+        } else if (result.timedOut) {
+            qWarning() << "Worker process exceeded time limit for file " << filename;
+            popplerWorkerTimedOut = true;
+        } else if (result.terminated) {
+            /// Worker crashed or exceeded its resource limits
+            qWarning() << "Worker process terminated while analyzing file " << filename;
+            popplerWorkerAborted = true;
+        } else {
+            popplerWrapperOk = result.exitCode == 0;
+            metaText = QString::fromUtf8(result.standardOutput);
+            logText = QString::fromUtf8(result.standardError);
+        }
+    }
+
+    /**
+     * Report of one veraPDF run to be embedded in the log: the XML
+     * as it is if complete, otherwise as escaped text
+     */
+    static QString veraPDFReport(const ValidatorResult &result, const VeraPDFOutputParser &parser) {
+        const QString output = QString::fromUtf8(result.standardOutput.constData());
+        if (result.outputTruncated)
+            /// Parsed completely, but only the beginning was kept
+            return QString(QStringLiteral("<excerpt truncated=\"yes\">%1</excerpt>")).arg(DocScan::xmlify(output));
+        else if (!parser.complete || parser.malformed)
+            /// Sometimes veraPDF does not return complete and valid XML code. veraPDF's bug or DocScan's bug?
+            return QStringLiteral("<error>No matching opening and closing 'rawResults' or 'ns2:cliReport' tags found in output:\n") + DocScan::xmlify(output) + QStringLiteral("</error>");
+        else {
+            /// Skip '<?xml version="1.0" encoding="UTF-8" standalone="yes"?>'
+            const int p = output.indexOf(QStringLiteral("?>"));
+            return p > 1 ? output.mid(output.indexOf(QLatin1Char('<'), p)) : output;
+        }
+    }
+
+    void veraPDFRun1Finished(const ValidatorResult &result) {
+        if (!result.started) {
+            qWarning() << "Failed to start veraPDF for file " << filename << " and " << result.commandLine;
+            return;
+        }
+        if (result.timedOut)
+            qWarning() << "Waiting for veraPDF failed or exceeded time limit for file " << filename << " and " << result.commandLine;
+        veraPDFExitCode = result.exitCode;
+        const VeraPDFOutputParser &parser = veraPDFParser[0];
+        veraPDFStandardOutput = veraPDFReport(result, parser);
+        veraPDFErrorOutput = QString::fromUtf8(result.standardError.constData());
+        if (veraPDFExitCode == 0 && !result.standardOutput.isEmpty()) {
+            veraPDFIsPDFA1B = parser.firstFlavour == QStringLiteral("PDFA_1_B") && parser.isCompliant(parser.firstFlavour);
+            veraPDFfilesize = parser.itemSize;
 
             if (veraPDFIsPDFA1B) {
                 /// So, it is PDF-A/1b, then test for PDF-A/1a
-                const QStringList arguments = QStringList(defaultArgumentsForNice) << m_veraPDFcliTool << QStringLiteral("-x") /** Extracts and reports PDF features. */ << QStringLiteral("-f") /** Chooses built-in Validation Profile flavour, e.g. '1b'. */ << QStringLiteral("1a") << QStringLiteral("--maxfailures") << QStringLiteral("1") << QStringLiteral("--format") << QStringLiteral("xml") << filename;
-                veraPDF.start(QStringLiteral("/usr/bin/nice"), arguments, QIODevice::ReadOnly);
-                veraPDFStartedRun2 = veraPDF.waitForStarted(twoMinutesInMillisec);
-                if (!veraPDFStartedRun2)
-                    qWarning() << "Failed to start veraPDF for file " << filename << " and " << veraPDF.program() << veraPDF.arguments().join(' ') << " in directory " << veraPDF.workingDirectory();
+                const QStringList arguments = QStringList(defaultArgumentsForNice) << analyzer->m_veraPDFcliTool << QStringLiteral("-x") /** Extracts and reports PDF features. */ << QStringLiteral("-f") /** Chooses built-in Validation Profile flavour, e.g. '1b'. */ << QStringLiteral("1a") << QStringLiteral("--maxfailures") << QStringLiteral("1") << QStringLiteral("--format") << QStringLiteral("xml");
+                followUpPending = true;
+                ValidatorScheduler::instance()->submitBatchable(this, ValidatorScheduler::VeraPDF, 2, QStringLiteral("/usr/bin/nice"), arguments, validatorFilename, QString(), sixMinutesInMillisec, &veraPDFParser[1]);
             } else
                 qDebug() << "Skipping second run of veraPDF as file " << filename << "is not PDF/A-1b";
         } else
-            qWarning() << "Execution of veraPDF failed for file " << filename << " and " << veraPDF.program() << veraPDF.arguments().join(' ') << " in directory " << veraPDF.workingDirectory() << ": " << veraPDFErrorOutput;
+            qWarning() << "Execution of veraPDF failed for file " << filename << " and " << result.commandLine << ": " << veraPDFErrorOutput;
+    }
+
+    void veraPDFRun2Finished(const ValidatorResult &result) {
+        if (!result.started) {
+            qWarning() << "Failed to start veraPDF for file " << filename << " and " << result.commandLine;
+            return;
+        }
+        if (result.timedOut)
+            qWarning() << "Waiting for veraPDF failed or exceeded time limit for file " << filename << " and " << result.commandLine;
+        veraPDFExitCode = result.exitCode;
+        veraPDFStandardOutput.append(QStringLiteral("\n") + veraPDFReport(result, veraPDFParser[1]));
+        veraPDFErrorOutput = veraPDFErrorOutput + QStringLiteral("\n") + QString::fromUtf8(result.standardError.constData());
+        if (veraPDFExitCode == 0)
+            veraPDFIsPDFA1A = veraPDFParser[1].isCompliant(QStringLiteral("PDFA_1_A"));
+        else
+            qWarning() << "Execution of veraPDF failed for file " << filename << " and " << result.commandLine << ": " << veraPDFErrorOutput;
     }
 
-    if (callasPdfAPilotStartedRun1) {
-        if (!callasPdfAPilot.waitForFinished(twoMinutesInMillisec))
-            qWarning() << "Waiting for callas PDF/A Pilot failed or exceeded time limit for file " << filename << " and " << callasPdfAPilot.program() << callasPdfAPilot.arguments().join(' ') << " in directory " << callasPdfAPilot.workingDirectory();
-        callasPdfAPilotExitCode = callasPdfAPilot.exitCode();
-        callasPdfAPilotStandardOutput = QString::fromUtf8(callasPdfAPilot.readAllStandardOutput().constData());
-        callasPdfAPilotErrorOutput = QString::fromUtf8(callasPdfAPilot.readAllStandardError().constData());
+    void callasPdfAPilotRun1Finished(const ValidatorResult &result) {
+        if (!result.started) {
+            qWarning() << "Failed to start callas PDF/A Pilot for file " << filename << " and " << result.commandLine;
+            return;
+        }
+        if (result.timedOut)
+            qWarning() << "Waiting for callas PDF/A Pilot failed or exceeded time limit for file " << filename << " and " << result.commandLine;
+        callasPdfAPilotExitCode = result.exitCode;
+        callasPdfAPilotStandardOutput = QString::fromUtf8(result.standardOutput.constData());
+        callasPdfAPilotErrorOutput = QString::fromUtf8(result.standardError.constData());
 
         if (callasPdfAPilotExitCode == 0 && !callasPdfAPilotStandardOutput.isEmpty()) {
             static const QRegularExpression rePDFA(QStringLiteral("\\bInfo\\s+PDFA\\s+PDF/A-1([ab])"));
-            const QRegularExpressionMatch match = rePDFA.match(callasPdfAPilotStandardOutput.right(512));
+            const QRegularExpressionMatch match = rePDFA.match(QString::fromUtf8(callasPdfAPilotParser[0].tail));
             callasPdfAPilotPDFA1letter = match.hasMatch() ? match.captured(1).at(0).toLatin1() : '\0';
             if (callasPdfAPilotPDFA1letter == 'a' || callasPdfAPilotPDFA1letter == 'b') {
                 /// Document claims to be PDF/A-1a or PDF/A-1b, so test for errors
-                const QStringList arguments = QStringList(defaultArgumentsForNice) << m_callasPdfAPilotCLI << QStringLiteral("-a") << filename;
-                callasPdfAPilot.start(QStringLiteral("/usr/bin/nice"), arguments, QIODevice::ReadOnly);
-                callasPdfAPilotStartedRun2 = callasPdfAPilot.waitForStarted(oneMinuteInMillisec);
-                if (!callasPdfAPilotStartedRun2)
-                    qWarning() << "Failed to start callas PDF/A Pilot for file " << filename << " and " << callasPdfAPilot.program() << callasPdfAPilot.arguments().join(' ') << " in directory " << callasPdfAPilot.workingDirectory();
+                const QStringList arguments = QStringList(defaultArgumentsForNice) << analyzer->m_callasPdfAPilotCLI << QStringLiteral("-a") << validatorFilename;
+                followUpPending = true;
+                ValidatorScheduler::instance()->submit(this, ValidatorScheduler::CallasPdfAPilot, 2, QStringLiteral("/usr/bin/nice"), arguments, QString(), fourMinutesInMillisec, &callasPdfAPilotParser[1]);
             } else
                 qDebug() << "Skipping second run of callas PDF/A Pilot as file " << filename << "is not PDF/A-1";
         } else
-            qWarning() << "Execution of callas PDF/A Pilot failed for file " << filename << " and " << callasPdfAPilot.program() << callasPdfAPilot.arguments().join(' ') << " in directory " << callasPdfAPilot.workingDirectory() << ": " << callasPdfAPilotErrorOutput;
-    }
-
-    if (jhoveStarted) {
-        if (!jhove.waitForFinished(fourMinutesInMillisec))
-            qWarning() << "Waiting for jHove failed or exceeded time limit for file " << filename << " and " << jhove.program() << jhove.arguments().join(' ') << " in directory " << jhove.workingDirectory();
-        jhoveExitCode = jhove.exitCode();
-        jhoveStandardOutput = QString::fromUtf8(jhove.readAllStandardOutput().constData()).replace(QLatin1Char('\n'), QStringLiteral("###"));
-        jhoveErrorOutput = QString::fromUtf8(jhove.readAllStandardError().constData()).replace(QLatin1Char('\n'), QStringLiteral("###"));
-        if (jhoveExitCode == 0 && !jhoveStandardOutput.isEmpty()) {
-            jhoveIsPDF = jhoveStandardOutput.contains(QStringLiteral("Format: PDF")) && !jhoveStandardOutput.contains(QStringLiteral("ErrorMessage:"));
-            static const QRegExp pdfStatusRegExp(QStringLiteral("\\bStatus: ([^#]+)"));
-            if (pdfStatusRegExp.indexIn(jhoveStandardOutput) >= 0) {
-                jhovePDFWellformed = pdfStatusRegExp.cap(1).startsWith(QStringLiteral("Well-Formed"), Qt::CaseInsensitive);
-                jhovePDFValid = pdfStatusRegExp.cap(1).endsWith(QStringLiteral("and valid"));
-            }
-            static const QRegExp pdfVersionRegExp(QStringLiteral("\\bVersion: ([^#]+)#"));
-            jhovePDFversion = pdfVersionRegExp.indexIn(jhoveStandardOutput) >= 0 ? pdfVersionRegExp.cap(1) : QString();
-            static const QRegExp pdfProfileRegExp(QStringLiteral("\\bProfile: ([^#]+)(#|$)"));
-            jhovePDFprofile = pdfProfileRegExp.indexIn(jhoveStandardOutput) >= 0 ? pdfProfileRegExp.cap(1) : QString();
-        } else
-            qWarning() << "Execution of jHove failed for file " << filename << " and " << jhove.program() << jhove.arguments().join(' ') << " in directory " << jhove.workingDirectory() << ": " << jhoveErrorOutput;
+            qWarning() << "Execution of callas PDF/A Pilot failed for file " << filename << " and " << result.commandLine << ": " << callasPdfAPilotErrorOutput;
     }
 
-    if (pdfboxValidatorStarted) {
-        if (!pdfboxValidator.waitForFinished(twoMinutesInMillisec))
-            qWarning() << "Waiting for pdfbox Validator failed or exceeded time limit for file " << filename << " and " << pdfboxValidator.program() << pdfboxValidator.arguments().join(' ') << " in directory " << pdfboxValidator.workingDirectory();
-        pdfboxValidatorExitCode = pdfboxValidator.exitCode();
-        pdfboxValidatorStandardOutput = QString::fromUtf8(pdfboxValidator.readAllStandardOutput().constData());
-        pdfboxValidatorErrorOutput = QString::fromUtf8(pdfboxValidator.readAllStandardError().constData());
-        if (pdfboxValidatorExitCode == 0 && !pdfboxValidatorStandardOutput.isEmpty())
-            pdfboxValidatorValidPdf = pdfboxValidatorStandardOutput.contains(QStringLiteral("is a valid PDF/A-1b file"));
-        else
-            qWarning() << "Execution of pdfbox Validator failed for file " << filename << " and " << pdfboxValidator.program() << pdfboxValidator.arguments().join(' ') << " in directory " << pdfboxValidator.workingDirectory() << ": " << pdfboxValidatorErrorOutput;
-    }
-
-    if (veraPDFStartedRun2) {
-        if (!veraPDF.waitForFinished(sixMinutesInMillisec))
-            qWarning() << "Waiting for veraPDF failed or exceeded time limit for file " << filename << " and " << veraPDF.program() << veraPDF.arguments().join(' ') << " in directory " << veraPDF.workingDirectory();
-        veraPDFExitCode = veraPDF.exitCode();
-        /// Some string magic to skip '<?xml version="1.0" encoding="UTF-8" standalone="yes"?>' from second output
-        const QString newStdOut = QString::fromUtf8(veraPDF.readAllStandardOutput().constData());
-        const int p = newStdOut.indexOf(QStringLiteral("?>"));
-        /// Sometimes veraPDF does not return complete and valid XML code. veraPDF's bug or DocScan's bug?
-        if ((newStdOut.contains(QStringLiteral("<rawResults>")) && newStdOut.contains(QStringLiteral("</rawResults>"))) || (newStdOut.contains(QStringLiteral("<ns2:cliReport")) && newStdOut.contains(QStringLiteral("</ns2:cliReport>"))))
-            veraPDFStandardOutput.append(QStringLiteral("\n") + (p > 1 ? newStdOut.mid(veraPDFStandardOutput.indexOf(QStringLiteral("<"), p)) : newStdOut));
-        else
-            veraPDFStandardOutput.append(QStringLiteral("<error>No matching opening and closing 'rawResults' or 'ns2:cliReport' tags found in output:\n") + DocScan::xmlify(newStdOut) + QStringLiteral("</error>"));
-
-        veraPDFErrorOutput = veraPDFErrorOutput + QStringLiteral("\n") + QString::fromUtf8(veraPDF.readAllStandardError().constData());
-        if (veraPDFExitCode == 0) {
-            const QString startOfOutput = newStdOut.left(8192);
-            const int p1 = startOfOutput.indexOf(QStringLiteral(" flavour=\"PDFA_1_A\""));
-            const int p2a = startOfOutput.indexOf(QStringLiteral(" isCompliant=\"true\""), p1 - 64);
-            const int p2b = startOfOutput.indexOf(QStringLiteral(" recordPasses=\"true\""), p1 - 64);
-            veraPDFIsPDFA1A = p1 > 0 && ((p2a > 0 && p2a < p1 + 64) || (p2b > 0 && p2b < p1 + 64));
-        } else
-            qWarning() << "Execution of veraPDF failed for file " << filename << " and " << veraPDF.program() << veraPDF.arguments().join(' ') << " in directory " << veraPDF.workingDirectory() << ": " << veraPDFErrorOutput;
-    }
-
-    if (callasPdfAPilotStartedRun2) {
-        if (!callasPdfAPilot.waitForFinished(fourMinutesInMillisec))
-            qWarning() << "Waiting for callas PDF/A Pilot failed or exceeded time limit for file " << filename << " and " << callasPdfAPilot.program() << callasPdfAPilot.arguments().join(' ') << " in directory " << callasPdfAPilot.workingDirectory();
-        callasPdfAPilotExitCode = callasPdfAPilot.exitCode();
-        callasPdfAPilotStandardOutput = callasPdfAPilotStandardOutput + QStringLiteral("\n") + QString::fromUtf8(callasPdfAPilot.readAllStandardOutput().constData());
-        callasPdfAPilotErrorOutput = callasPdfAPilotErrorOutput + QStringLiteral("\n") + QString::fromUtf8(callasPdfAPilot.readAllStandardError().constData());
+    void callasPdfAPilotRun2Finished(const ValidatorResult &result) {
+        if (!result.started) {
+            qWarning() << "Failed to start callas PDF/A Pilot for file " << filename << " and " << result.commandLine;
+            return;
+        }
+        if (result.timedOut)
+            qWarning() << "Waiting for callas PDF/A Pilot failed or exceeded time limit for file " << filename << " and " << result.commandLine;
+        callasPdfAPilotExitCode = result.exitCode;
+        callasPdfAPilotStandardOutput = callasPdfAPilotStandardOutput + QStringLiteral("\n") + QString::fromUtf8(result.standardOutput.constData());
+        callasPdfAPilotErrorOutput = callasPdfAPilotErrorOutput + QStringLiteral("\n") + QString::fromUtf8(result.standardError.constData());
         if (callasPdfAPilotExitCode == 0) {
             static const QRegularExpression reSummary(QStringLiteral("\\bSummary\\t(Errors|Warnings)\\t(0|[1-9][0-9]*)\\b"));
-            QRegularExpressionMatchIterator reIter = reSummary.globalMatch(callasPdfAPilotStandardOutput.right(512));
+            QRegularExpressionMatchIterator reIter = reSummary.globalMatch(QString::fromUtf8(callasPdfAPilotParser[1].tail));
             while (reIter.hasNext()) {
                 const QRegularExpressionMatch match = reIter.next();
                 if (match.captured(1) == QStringLiteral("Errors")) {
@@ -293,12 +745,410 @@ void FileAnalyzerPDF::analyzeFile(const QString &filename)
                 }
             }
         } else
-            qWarning() << "Execution of callas PDF/A Pilot failed for file " << filename << " and " << callasPdfAPilot.program() << callasPdfAPilot.arguments().join(' ') << " in directory " << callasPdfAPilot.workingDirectory() << ": " << callasPdfAPilotErrorOutput;
+            qWarning() << "Execution of callas PDF/A Pilot failed for file " << filename << " and " << result.commandLine << ": " << callasPdfAPilotErrorOutput;
+    }
+
+    void jhoveFinished(const ValidatorResult &result) {
+        if (!result.started) {
+            qWarning() << "Failed to start jhove for file " << filename << " and " << result.commandLine;
+            return;
+        }
+        if (result.timedOut)
+            qWarning() << "Waiting for jHove failed or exceeded time limit for file " << filename << " and " << result.commandLine;
+        jhoveExitCode = result.exitCode;
+        jhoveStandardOutput = QString::fromUtf8(result.standardOutput.constData());
+        jhoveErrorOutput = QString::fromUtf8(result.standardError.constData());
+        if (jhoveExitCode == 0 && jhoveParser.hasOutput) {
+            jhoveIsPDF = jhoveParser.formatIsPDF && !jhoveParser.hasErrorMessage;
+            jhovePDFWellformed = jhoveParser.status.startsWith(QStringLiteral("Well-Formed"), Qt::CaseInsensitive);
+            jhovePDFValid = jhoveParser.status.endsWith(QStringLiteral("and valid"));
+            jhovePDFversion = jhoveParser.version;
+            jhovePDFprofile = jhoveParser.profile;
+        } else
+            qWarning() << "Execution of jHove failed for file " << filename << " and " << result.commandLine << ": " << jhoveErrorOutput;
+    }
+
+    void pdfboxValidatorFinished(const ValidatorResult &result) {
+        if (!result.started) {
+            qWarning() << "Failed to start pdfbox Validator for file " << filename << " and " << result.commandLine;
+            return;
+        }
+        if (result.timedOut)
+            qWarning() << "Waiting for pdfbox Validator failed or exceeded time limit for file " << filename << " and " << result.commandLine;
+        pdfboxValidatorExitCode = result.exitCode;
+        pdfboxValidatorStandardOutput = QString::fromUtf8(result.standardOutput.constData());
+        pdfboxValidatorErrorOutput = QString::fromUtf8(result.standardError.constData());
+        if (pdfboxValidatorExitCode == 0 && !pdfboxValidatorStandardOutput.isEmpty())
+            pdfboxValidatorValidPdf = pdfboxValidatorStandardOutput.contains(QStringLiteral("is a valid PDF/A-1b file"));
+        else
+            qWarning() << "Execution of pdfbox Validator failed for file " << filename << " and " << result.commandLine << ": " << pdfboxValidatorErrorOutput;
+    }
+};
+
+/**
+ * Identifies a PDF document's language while its validators are
+ * running, taking over poppler's document from the analysis.
+ * The validation job gets released once done.
+ */
+class PdfTextAnalysisJob : public TextAnalysisJob
+{
+public:
+    PdfTextAnalysisJob(PdfValidationJob *job, PopplerWrapper *wrapper)
+        : m_job(job), m_wrapper(wrapper), m_pages(wrapper) {
+        /// nothing
+    }
+
+    ~PdfTextAnalysisJob() {
+        delete m_wrapper;
     }
 
-    const qint64 externalProgramsEndTime = QDateTime::currentMSecsSinceEpoch();
+    TextSource *textSource() {
+        return &m_pages;
+    }
+
+    void textAnalyzed(const QString &headerText) {
+        delete m_wrapper;
+        m_wrapper = nullptr;
+
+        /// Validators do not touch the log text of files analyzed in-process
+        QString &logText = m_job->logText;
+        const int p = logText.indexOf(QStringLiteral("</header>"));
+        if (p >= 0) logText.insert(p, headerText);
+        /// If all validators are done already, the report is emitted right now
+        ValidatorScheduler::instance()->release(m_job);
+    }
+
+private:
+    PdfValidationJob *m_job;
+    PopplerWrapper *m_wrapper;
+    PdfPageTextSource m_pages;
+};
+
+const char *FileAnalyzerPDF::workerArgument = "--pdf-worker";
+
+FileAnalyzerPDF::FileAnalyzerPDF(QObject *parent)
+    : FileAnalyzerAbstract(parent), m_depth(dFull), m_validatorPolicy(vpRunAll), m_workerTimeout(0), m_workerCpuLimitSeconds(0), m_workerMemoryLimitMiB(0)
+{
+    m_pendingFilesMutex = new QMutex();
+    m_pendingFileCompleted = new QWaitCondition();
+}
 
-    PopplerWrapper *wrapper = PopplerWrapper::createPopplerWrapper(filename);
+FileAnalyzerPDF::~FileAnalyzerPDF()
+{
+    /// Pending jobs refer to this analyzer, so wait for them;
+    /// all jobs complete, even if the validator scheduler got shut down
+    m_pendingFilesMutex->lock();
+    while (m_numPendingFiles.load() > 0 || m_numCompletingFiles.load() > 0)
+        m_pendingFileCompleted->wait(m_pendingFilesMutex);
+    m_pendingFilesMutex->unlock();
+    waitForTextAnalyses();
+
+    delete m_pendingFileCompleted;
+    delete m_pendingFilesMutex;
+}
+
+bool FileAnalyzerPDF::isAlive()
+{
+    return m_numPendingFiles.load() > 0;
+}
+
+int FileAnalyzerPDF::numPendingFiles()
+{
+    return m_numPendingFiles.load();
+}
+
+void FileAnalyzerPDF::setupJhove(const QString &shellscript)
+{
+    m_jhoveShellscript = shellscript;
+}
+
+void FileAnalyzerPDF::setupVeraPDF(const QString &cliTool)
+{
+    m_veraPDFcliTool = cliTool;
+}
+
+void FileAnalyzerPDF::setupVeraPDFBatching(int maxFiles, int maxWait)
+{
+    ValidatorScheduler::instance()->setBatching(ValidatorScheduler::VeraPDF, maxFiles, maxWait, &VeraPDFBatchSplitter::create);
+}
+
+void FileAnalyzerPDF::setupJhoveBatching(int maxFiles, int maxWait)
+{
+    ValidatorScheduler::instance()->setBatching(ValidatorScheduler::JHove, maxFiles, maxWait, &JHoveBatchSplitter::create);
+}
+
+void FileAnalyzerPDF::setupPdfBoXValidator(const QString &pdfboxValidatorJavaClass) {
+    m_pdfboxValidatorJavaClass = pdfboxValidatorJavaClass;
+}
+
+void FileAnalyzerPDF::setupCallasPdfAPilotCLI(const QString &callasPdfAPilotCLI) {
+    m_callasPdfAPilotCLI = callasPdfAPilotCLI;
+}
+
+void FileAnalyzerPDF::setDepth(Depth depth)
+{
+    m_depth = depth;
+}
+
+void FileAnalyzerPDF::setValidatorPolicy(ValidatorPolicy policy)
+{
+    m_validatorPolicy = policy;
+}
+
+void FileAnalyzerPDF::setupPopplerWorker(int timeout, int cpuLimitSeconds, int memoryLimitMiB)
+{
+    m_workerTimeout = timeout;
+    m_workerCpuLimitSeconds = cpuLimitSeconds;
+    m_workerMemoryLimitMiB = memoryLimitMiB;
+}
+
+int FileAnalyzerPDF::runWorker(const QStringList &arguments)
+{
+    if (arguments.count() != 10) {
+        fprintf(stderr, "Invalid arguments for worker process\n");
+        return 1;
+    }
+    const int workerTextExtraction = arguments[0].toInt();
+    const int depth = arguments[1].toInt();
+    const int pageLogLimit = arguments[2].toInt();
+    const int imageInventory = arguments[3].toInt();
+    const int textExtractionThreads = arguments[4].toInt();
+    const int cpuLimitSeconds = arguments[5].toInt();
+    const int memoryLimitMiB = arguments[6].toInt();
+    const int languageIdentification = arguments[7].toInt();
+    const double minLanguageConfidence = arguments[8].toDouble();
+    const QString textStoreFilename = arguments[9];
+
+    /// Results are written to the original standard output only, anything
+    /// else like debug messages goes to standard error which is discarded
+    QFile output;
+    if (!output.open(::dup(STDOUT_FILENO), QIODevice::WriteOnly, QFileDevice::AutoCloseHandle))
+        return 1;
+    ::dup2(STDERR_FILENO, STDOUT_FILENO);
+
+    if (memoryLimitMiB > 0) {
+        struct rlimit limit;
+        limit.rlim_cur = limit.rlim_max = static_cast<rlim_t>(memoryLimitMiB) * 1024 * 1024;
+        if (::setrlimit(RLIMIT_AS, &limit) != 0)
+            qWarning() << "Cannot limit address space of worker process";
+    }
+
+    FileAnalyzerPDF analyzer;
+    analyzer.setTextExtraction(static_cast<TextExtraction>(workerTextExtraction));
+    analyzer.setDepth(static_cast<Depth>(depth));
+    PopplerWrapper::setPageLogLimit(pageLogLimit);
+    PopplerWrapper::setImageInventory(static_cast<PopplerWrapper::ImageInventory>(imageInventory));
+    PopplerWrapper::setTextExtractionThreads(textExtractionThreads);
+    setLanguageIdentification(static_cast<LanguageIdentification>(languageIdentification), minLanguageConfidence);
+    TextStore::instance()->setFilename(textStoreFilename);
+
+    QFile input;
+    if (!input.open(stdin, QIODevice::ReadOnly))
+        return 1;
+
+    /// Worker quits once its input is closed
+    QByteArray line;
+    while (!(line = input.readLine()).isEmpty()) {
+        if (line.endsWith('\n')) line.chop(1);
+        if (line.isEmpty()) continue;
+
+        if (cpuLimitSeconds > 0) {
+            /// CPU time limit applies to the whole process, so
+            /// extend it by the time granted for this file
+            struct rusage usage;
+            struct rlimit limit;
+            if (::getrusage(RUSAGE_SELF, &usage) == 0 && ::getrlimit(RLIMIT_CPU, &limit) == 0) {
+                limit.rlim_cur = static_cast<rlim_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + 1 + cpuLimitSeconds);
+                if (limit.rlim_max != RLIM_INFINITY && limit.rlim_cur > limit.rlim_max)
+                    limit.rlim_cur = limit.rlim_max;
+                ::setrlimit(RLIMIT_CPU, &limit);
+            }
+        }
+
+        QString logText, metaText;
+        const bool ok = analyzer.analyzeWithPoppler(QString::fromUtf8(line), QByteArray(), logText, metaText);
+        const QByteArray metaData = metaText.toUtf8(), logData = logText.toUtf8();
+        /// Same framing as used by validator servers, with poppler's
+        /// meta and log text in place of standard output and error
+        output.write(QByteArrayLiteral("@@RESULT ") + (ok ? '0' : '1') + ' ' + QByteArray::number(metaData.size()) + ' ' + QByteArray::number(logData.size()) + '\n');
+        output.write(metaData);
+        output.write(logData);
+        output.flush();
+    }
+
+    return 0;
+}
+
+void FileAnalyzerPDF::analyzeFile(const QString &filename)
+{
+    startAnalysis(filename, QByteArray(), QByteArray());
+}
+
+void FileAnalyzerPDF::analyzeData(const QString &filename, const QByteArray &data)
+{
+    startAnalysis(filename, data, QByteArray());
+}
+
+void FileAnalyzerPDF::analyzeData(const QString &filename, const QByteArray &data, const QByteArray &contentHash)
+{
+    startAnalysis(filename, data, contentHash);
+}
+
+QString FileAnalyzerPDF::cacheFingerprint() const
+{
+    /// Increase version whenever the report's content changes
+    QString fingerprint = QStringLiteral("FileAnalyzerPDF/4|textextraction=") + QString::number(textExtraction) + QStringLiteral("|depth=") + QString::number(m_depth);
+    /// Reports where validators got skipped differ from those of running all
+    if (m_validatorPolicy != vpRunAll)
+        fingerprint.append(QStringLiteral("|validatorpolicy=")).append(QString::number(m_validatorPolicy));
+    if (textExtraction >= teAspell) {
+        fingerprint.append(QStringLiteral("|language=")).append(QString::number(languageIdentification()));
+        if (languageIdentification() == liFallback)
+            fingerprint.append(QChar(',')).append(QString::number(minLanguageConfidence()));
+    }
+    if (textExtraction >= teFullText) {
+        fingerprint.append(QStringLiteral("|pagelog=")).append(QString::number(PopplerWrapper::pageLogLimit())).append(QStringLiteral("|images=")).append(QString::number(PopplerWrapper::imageInventory()));
+        /// Cached reports refer to texts in a particular store, which
+        /// may have been replaced by a new one under the same name
+        if (TextStore::instance()->isEnabled())
+            fingerprint.append(QStringLiteral("|textstore=")).append(TextStore::instance()->filename()).append(QChar('#')).append(TextStore::instance()->identity());
+    }
+    /// Tools are identified by their location and last modification,
+    /// so that an updated installation invalidates cached reports
+    const QStringList tools = QStringList() << m_jhoveShellscript << m_veraPDFcliTool << m_pdfboxValidatorJavaClass << m_callasPdfAPilotCLI;
+    for (const QString &tool : tools) {
+        fingerprint.append(QChar('|')).append(tool);
+        if (!tool.isEmpty())
+            fingerprint.append(QChar('@')).append(QString::number(QFileInfo(tool).lastModified().toMSecsSinceEpoch()));
+    }
+    return fingerprint;
+}
+
+void FileAnalyzerPDF::startAnalysis(const QString &filename, const QByteArray &data, const QByteArray &knownContentHash)
+{
+    if (filename.endsWith(QStringLiteral(".xz")) || filename.endsWith(QStringLiteral(".gz")) || filename.endsWith(QStringLiteral(".bz2")) || filename.endsWith(QStringLiteral(".lzma"))) {
+        /// File is compressed
+        qWarning() << "Compressed files like " << filename << " should not directly send through this analyzer, but rather be uncompressed by FileAnalyzerMultiplexer first";
+        emit creditsGranted(1);
+        return;
+    }
+
+    QString cacheKey;
+    AnalysisCache *cache = AnalysisCache::instance();
+    /// Hashing reads the whole file, which is more than a metadata-only analysis does
+    if (cache->isEnabled() && m_depth > dMetadata) {
+        const QByteArray contentHash = !knownContentHash.isEmpty() ? knownContentHash : (data.isNull() ? AnalysisCache::contentHash(filename) : AnalysisCache::contentHash(data));
+        if (!contentHash.isEmpty()) {
+            cacheKey = AnalysisCache::key(contentHash, cacheFingerprint());
+            const QString cachedReport = cache->lookup(cacheKey, filename);
+            if (!cachedReport.isEmpty()) {
+                /// Identical file has been analyzed before, neither poppler nor validators needed
+                qDebug() << "Using cached analysis for" << filename;
+                emit analysisReport(cachedReport);
+                emit creditsGranted(1);
+                checkDrained();
+                return;
+            }
+        }
+    }
+
+    /// External validators can only read files, so documents held
+    /// in memory get written to disk only if any validator will run
+    /// Validators read the whole file, so they only run for a full analysis
+    const bool runValidators = m_depth >= dFull && hasValidators();
+    const bool usePopplerWorker = m_workerTimeout > 0;
+    QString validatorFilename = runValidators || usePopplerWorker ? filename : QString();
+    bool removeAfterAnalysis = false;
+    if (!data.isNull() && (runValidators || usePopplerWorker)) {
+        validatorFilename = writeTemporaryFile(filename, data);
+        removeAfterAnalysis = !validatorFilename.isEmpty();
+    }
+    const qint64 fileSize = data.isNull() ? QFileInfo(filename).size() : data.size();
+
+    ValidatorScheduler *scheduler = ValidatorScheduler::instance();
+    /// Limit the number of files waiting for their validators
+    scheduler->waitForCapacity();
+
+    m_numPendingFiles.ref();
+    PdfValidationJob *job = new PdfValidationJob(this, filename, validatorFilename, fileSize, removeAfterAnalysis, cacheKey);
+    scheduler->addJob(job);
+    if ((runValidators || usePopplerWorker) && validatorFilename.isEmpty()) {
+        /// Temporary copy could not be written, validator results may differ next time
+        qWarning() << "Cannot run validators for" << filename;
+        job->transientFailure = true;
+    }
+
+    if (runValidators && !validatorFilename.isEmpty()) {
+        QList<ValidatorScheduler::Tool> validators;
+        if (!m_veraPDFcliTool.isEmpty()) validators.append(ValidatorScheduler::VeraPDF);
+        if (!m_callasPdfAPilotCLI.isEmpty()) validators.append(ValidatorScheduler::CallasPdfAPilot);
+        if (!m_jhoveShellscript.isEmpty()) validators.append(ValidatorScheduler::JHove);
+        if (!m_pdfboxValidatorJavaClass.isEmpty()) validators.append(ValidatorScheduler::PdfBoxValidator);
+        if (m_validatorPolicy == vpCostAware) {
+            /// Validators run one after another once poppler is done,
+            /// cheapest first as measured so far
+            QMap<qint64, ValidatorScheduler::Tool> validatorsByCost;
+            for (ValidatorScheduler::Tool tool : const_cast<const QList<ValidatorScheduler::Tool> &>(validators)) {
+                const qint64 measured = scheduler->averageRunTime(tool);
+                validatorsByCost.insertMulti(measured > 0 ? measured : assumedRunTime(tool), tool);
+            }
+            job->remainingValidators = validatorsByCost.values();
+        } else
+            /// All validators run in parallel, while poppler analyzes the file
+            for (ValidatorScheduler::Tool tool : const_cast<const QList<ValidatorScheduler::Tool> &>(validators))
+                job->submitValidator(tool);
+    }
+
+    if (usePopplerWorker && !validatorFilename.isEmpty() && !validatorFilename.contains(QLatin1Char('\n'))) {
+        /// Worker processes run with the same settings as this analyzer
+        const QStringList arguments = QStringList() << QString::fromLatin1(workerArgument) << QString::number(textExtraction) << QString::number(m_depth) << QString::number(PopplerWrapper::pageLogLimit()) << QString::number(PopplerWrapper::imageInventory()) << QString::number(PopplerWrapper::textExtractionThreads()) << QString::number(m_workerCpuLimitSeconds) << QString::number(m_workerMemoryLimitMiB) << QString::number(languageIdentification()) << QString::number(minLanguageConfidence()) << TextStore::instance()->filename();
+        scheduler->submitToServer(job, ValidatorScheduler::PopplerWorker, 1, QCoreApplication::applicationFilePath(), arguments, QString(), QFileInfo(validatorFilename).absoluteFilePath().toUtf8(), m_workerTimeout);
+    } else {
+        /// While validators are running, analyze file using poppler
+        PopplerWrapper *textAnalysisWrapper = nullptr;
+        job->popplerWrapperOk = analyzeWithPoppler(filename, data, job->logText, job->metaText, &textAnalysisWrapper);
+        if (m_validatorPolicy == vpCostAware)
+            /// Poppler's results decide on validators; if analyzed in a
+            /// worker process, this happens once the worker is done
+            job->submitNextValidator();
+        if (textAnalysisWrapper != nullptr) {
+            /// Text gets analyzed alongside the validators, so that this
+            /// thread can continue with the next file; the job gets
+            /// released once done
+            submitTextAnalysis(new PdfTextAnalysisJob(job, textAnalysisWrapper));
+            return;
+        }
+    }
+
+    /// If all validators are done already, the report is emitted right now
+    scheduler->release(job);
+}
+
+bool FileAnalyzerPDF::hasValidators() const
+{
+    return !m_jhoveShellscript.isEmpty() || !m_veraPDFcliTool.isEmpty() || !m_pdfboxValidatorJavaClass.isEmpty() || !m_callasPdfAPilotCLI.isEmpty();
+}
+
+QString FileAnalyzerPDF::writeTemporaryFile(const QString &filename, const QByteArray &data) const
+{
+    /// Keep the original file name as suffix, some validators mention it in their output
+    QTemporaryFile file(QDir::tempPath() + QStringLiteral("/.docscan-XXXXXX-") + QFileInfo(filename).fileName());
+    file.setAutoRemove(false);
+    if (!file.open())
+        return QString();
+    if (file.write(data) != data.size()) {
+        file.remove();
+        return QString();
+    }
+    file.close();
+    return file.fileName();
+}
+
+bool FileAnalyzerPDF::analyzeWithPoppler(const QString &filename, const QByteArray &data, QString &logText, QString &metaText, PopplerWrapper **textAnalysisWrapper)
+{
+    StageTimer loadTimer(QStringLiteral("poppler-load"));
+    PopplerWrapper *wrapper = data.isNull() ? PopplerWrapper::createPopplerWrapper(filename) : PopplerWrapper::createPopplerWrapper(data, filename);
+    loadTimer.stop();
     const bool popplerWrapperOk = wrapper != nullptr;
     if (popplerWrapperOk) {
         QString guess, headerText;
@@ -326,28 +1176,16 @@ void FileAnalyzerPDF::analyzeFile(const QString &filename)
         if (!toolXMLtext.isEmpty())
             metaText.append(QStringLiteral("<tools>\n")).append(toolXMLtext).append(QStringLiteral("</tools>\n"));
 
-        if (!wrapper->isLocked()) {
+        if (!wrapper->isLocked() && m_depth >= dFonts) {
             /// some functions are sensitive if PDF is locked
 
             /// retrieve font information
-            const QStringList fontNames = wrapper->fontNames();
-            static QRegExp fontNameNormalizer(QStringLiteral("^[A-Z]+\\+"), Qt::CaseInsensitive);
-            QSet<QString> knownFonts;
+            StageTimer fontTimer(QStringLiteral("fonts"));
+            const QVector<PopplerWrapper::FontInfo> fonts = wrapper->fonts();
+            fontTimer.stop();
             QString fontXMLtext;
-            for (const QString &fi : fontNames) {
-                QStringList fields = fi.split(QLatin1Char('|'), QString::KeepEmptyParts);
-                if (fields.length() < 2) continue;
-                const QString fontName = fields[0].remove(fontNameNormalizer);
-                QString fontFilename;
-                const int p1 = fi.indexOf(QStringLiteral("|FONTFILENAME:"));
-                if (p1 > 0) {
-                    const int p2 = fi.indexOf(QStringLiteral("|"), p1 + 4);
-                    fontFilename = fi.mid(p1 + 15, p2 - p1 - 15).replace(QStringLiteral("#20"), QStringLiteral(" "));
-                }
-                if (fontName.isEmpty()) continue;
-                if (knownFonts.contains(fontName)) continue; else knownFonts.insert(fontName);
-                fontXMLtext.append(QString(QStringLiteral("<font embedded=\"%2\" subset=\"%3\"%4>\n%1</font>\n")).arg(Guessing::fontToXML(fontName, fields[1]), fi.contains(QStringLiteral("|EMBEDDED:1")) ? QStringLiteral("yes") : QStringLiteral("no"), fi.contains(QStringLiteral("|SUBSET:1")) ? QStringLiteral("yes") : QStringLiteral("no"), fontFilename.isEmpty() ? QString() : QString(QStringLiteral(" filename=\"%1\"")).arg(fontFilename)));
-            }
+            for (const PopplerWrapper::FontInfo &fi : fonts)
+                fontXMLtext.append(QString(QStringLiteral("<font embedded=\"%2\" subset=\"%3\"%4>\n%1</font>\n")).arg(Guessing::fontToXML(fi.name, fi.typeName()), fi.embedded ? QStringLiteral("yes") : QStringLiteral("no"), fi.subset ? QStringLiteral("yes") : QStringLiteral("no"), fi.filename.isEmpty() ? QString() : QString(QStringLiteral(" filename=\"%1\"")).arg(DocScan::xmlify(fi.filename))));
             if (!fontXMLtext.isEmpty())
                 /// Wrap multiple <font> tags into one <fonts> tag
                 metaText.append(QStringLiteral("<fonts>\n")).append(fontXMLtext).append(QStringLiteral("</fonts>\n"));
@@ -370,8 +1208,9 @@ void FileAnalyzerPDF::analyzeFile(const QString &filename)
         /// retrieve title
         QString title = wrapper->info(QStringLiteral("Title")).simplified();
         /// clean-up title
-        if (microsoftToolRegExp.indexIn(title) == 0)
-            title = microsoftToolRegExp.cap(3);
+        QRegExp microsoftTool(microsoftToolRegExp.pattern());
+        if (microsoftTool.indexIn(title) == 0)
+            title = microsoftTool.cap(3);
         if (!title.isEmpty())
             headerText.append(QString(QStringLiteral("<title>%1</title>\n")).arg(DocScan::xmlify(title)));
 
@@ -389,19 +1228,45 @@ void FileAnalyzerPDF::analyzeFile(const QString &filename)
             /// some functions are sensitive if PDF is locked
 
             QString bodyText;
-            if (textExtraction > teNone) {
+            if (textExtraction > teNone && m_depth >= dFull) {
                 int length = 0;
-                const QString text = wrapper->plainText(&length);
-                QString language;
+                StageTimer textTimer(QStringLiteral("text-extraction"));
+                wrapper->plainText(&length);
+                textTimer.stop();
                 if (textExtraction >= teAspell) {
-                    language = guessLanguage(text);
-                    if (!language.isEmpty())
-                        headerText.append(QString(QStringLiteral("<language origin=\"aspell\">%1</language>\n")).arg(language));
+                    /// Pages get sampled from all over the document, not
+                    /// only from the first pages extracted above
+                    if (textAnalysisWrapper != nullptr)
+                        *textAnalysisWrapper = wrapper;
+                    else {
+                        PdfPageTextSource pages(wrapper);
+                        headerText.append(TextAnalysis::analyze(pages, true));
+                    }
                 }
                 bodyText = QString(QStringLiteral("<body length=\"%1\"")).arg(length);
-                if (textExtraction >= teFullText)
-                    bodyText.append(QStringLiteral(">\n")).append(wrapper->popplerLog()).append(QStringLiteral("</body>\n"));
-                else
+                if (textExtraction >= teFullText) {
+                    bool textStored = false;
+                    if (TextStore::instance()->isEnabled()) {
+                        /// Keep the log small by storing the pages' text
+                        /// in compressed form next to it; unlike the page
+                        /// log, the store receives every page's text
+                        StageTimer textStoreTimer(QStringLiteral("text-store"));
+                        QStringList pageTexts;
+                        const int numPages = wrapper->numPages();
+                        for (int i = 0; i < numPages; ++i)
+                            pageTexts.append(wrapper->pagePlainText(i));
+                        qint64 offset = 0;
+                        int size = 0;
+                        const qint64 id = TextStore::instance()->append(pageTexts, &offset, &size);
+                        if (id >= 0) {
+                            bodyText.append(QString(QStringLiteral(" textstore-id=\"%1\" textstore-offset=\"%2\" textstore-size=\"%3\" textstore-pages=\"%4\"")).arg(QString::number(id), QString::number(offset), QString::number(size), QString::number(numPages)));
+                            textStored = true;
+                        }
+                    }
+                    /// Page-wise text and image log, timed separately from plain text
+                    StageTimer pageLogTimer(QStringLiteral("page-log"));
+                    bodyText.append(QStringLiteral(">\n")).append(wrapper->popplerLog(!textStored)).append(QStringLiteral("</body>\n"));
+                } else
                     bodyText.append(QStringLiteral("/>\n"));
             }
             if (!bodyText.isEmpty())
@@ -424,95 +1289,138 @@ void FileAnalyzerPDF::analyzeFile(const QString &filename)
         if (!headerText.isEmpty())
             logText.append(QStringLiteral("<header>\n")).append(headerText).append(QStringLiteral("</header>\n"));
 
-        delete wrapper;
+        /// Wrapper handed over for text analysis gets deleted once that is done
+        if (textAnalysisWrapper == nullptr || *textAnalysisWrapper != wrapper)
+            delete wrapper;
     }
 
-    if (jhoveExitCode > INT_MIN) {
+    return popplerWrapperOk;
+}
+
+void FileAnalyzerPDF::analysisComplete(PdfValidationJob *job)
+{
+    QString &logText = job->logText;
+    QString &metaText = job->metaText;
+    const QString &filename = job->filename;
+
+    if (job->jhoveExitCode > INT_MIN) {
         /// insert data from jHove
-        metaText.append(QString(QStringLiteral("<jhove exitcode=\"%1\" wellformed=\"%2\" valid=\"%3\" pdf=\"%4\"")).arg(QString::number(jhoveExitCode), jhovePDFWellformed ? QStringLiteral("yes") : QStringLiteral("no"), jhovePDFValid ? QStringLiteral("yes") : QStringLiteral("no"), jhoveIsPDF ? QStringLiteral("yes") : QStringLiteral("no")));
-        if (jhovePDFversion.isEmpty() && jhovePDFprofile.isEmpty() && jhoveStandardOutput.isEmpty() && jhoveErrorOutput.isEmpty())
+        metaText.append(QString(QStringLiteral("<jhove exitcode=\"%1\" wellformed=\"%2\" valid=\"%3\" pdf=\"%4\"")).arg(QString::number(job->jhoveExitCode), job->jhovePDFWellformed ? QStringLiteral("yes") : QStringLiteral("no"), job->jhovePDFValid ? QStringLiteral("yes") : QStringLiteral("no"), job->jhoveIsPDF ? QStringLiteral("yes") : QStringLiteral("no")));
+        if (job->jhovePDFversion.isEmpty() && job->jhovePDFprofile.isEmpty() && job->jhoveStandardOutput.isEmpty() && job->jhoveErrorOutput.isEmpty())
             metaText.append(QStringLiteral(" />\n"));
         else {
             metaText.append(QStringLiteral(">\n"));
-            if (!jhovePDFversion.isEmpty())
-                metaText.append(QString(QStringLiteral("<version>%1</version>\n")).arg(DocScan::xmlify(jhovePDFversion)));
-            if (!jhovePDFprofile.isEmpty()) {
-                const bool isPDFA1a = jhovePDFprofile.contains(QStringLiteral("ISO PDF/A-1, Level A"));
-                const bool isPDFA1b = isPDFA1a || jhovePDFprofile.contains(QStringLiteral("ISO PDF/A-1, Level B"));
-                metaText.append(QString(QStringLiteral("<profile linear=\"%2\" tagged=\"%3\" pdfa1a=\"%4\" pdfa1b=\"%5\" pdfx3=\"%6\">%1</profile>\n")).arg(DocScan::xmlify(jhovePDFprofile), jhovePDFprofile.contains(QStringLiteral("Linearized PDF")) ? QStringLiteral("yes") : QStringLiteral("no"), jhovePDFprofile.contains(QStringLiteral("Tagged PDF")) ? QStringLiteral("yes") : QStringLiteral("no"), isPDFA1a ? QStringLiteral("yes") : QStringLiteral("no"), isPDFA1b ? QStringLiteral("yes") : QStringLiteral("no"), jhovePDFprofile.contains(QStringLiteral("ISO PDF/X-3")) ? QStringLiteral("yes") : QStringLiteral("no")));
+            if (!job->jhovePDFversion.isEmpty())
+                metaText.append(QString(QStringLiteral("<version>%1</version>\n")).arg(DocScan::xmlify(job->jhovePDFversion)));
+            if (!job->jhovePDFprofile.isEmpty()) {
+                const bool isPDFA1a = job->jhovePDFprofile.contains(QStringLiteral("ISO PDF/A-1, Level A"));
+                const bool isPDFA1b = isPDFA1a || job->jhovePDFprofile.contains(QStringLiteral("ISO PDF/A-1, Level B"));
+                metaText.append(QString(QStringLiteral("<profile linear=\"%2\" tagged=\"%3\" pdfa1a=\"%4\" pdfa1b=\"%5\" pdfx3=\"%6\">%1</profile>\n")).arg(DocScan::xmlify(job->jhovePDFprofile), job->jhovePDFprofile.contains(QStringLiteral("Linearized PDF")) ? QStringLiteral("yes") : QStringLiteral("no"), job->jhovePDFprofile.contains(QStringLiteral("Tagged PDF")) ? QStringLiteral("yes") : QStringLiteral("no"), isPDFA1a ? QStringLiteral("yes") : QStringLiteral("no"), isPDFA1b ? QStringLiteral("yes") : QStringLiteral("no"), job->jhovePDFprofile.contains(QStringLiteral("ISO PDF/X-3")) ? QStringLiteral("yes") : QStringLiteral("no")));
             }
             /*
-            if (!jhoveStandardOutput.isEmpty())
-                metaText.append(QString(QStringLiteral("<output>%1</output>\n")).arg(DocScan::xmlify(jhoveStandardOutput.replace(QStringLiteral("###"), QStringLiteral("\n")))));
+            if (!job->jhoveStandardOutput.isEmpty())
+                metaText.append(QString(QStringLiteral("<output>%1</output>\n")).arg(DocScan::xmlify(job->jhoveStandardOutput)));
             */
-            if (!jhoveErrorOutput.isEmpty())
-                metaText.append(QString(QStringLiteral("<error>%1</error>\n")).arg(DocScan::xmlify(jhoveErrorOutput.replace(QStringLiteral("###"), QStringLiteral("\n")))));
+            if (!job->jhoveErrorOutput.isEmpty())
+                metaText.append(QString(QStringLiteral("<error>%1</error>\n")).arg(DocScan::xmlify(job->jhoveErrorOutput)));
             metaText.append(QStringLiteral("</jhove>\n"));
         }
-    } else if (!m_jhoveShellscript.isEmpty())
+    } else if (job->skippedValidators.contains(ValidatorScheduler::JHove))
+        metaText.append(QString(QStringLiteral("<jhove skipped=\"%1\" />\n")).arg(job->skippedValidators.value(ValidatorScheduler::JHove)));
+    else if (!m_jhoveShellscript.isEmpty())
         metaText.append(QStringLiteral("<jhove><error>jHove failed to start or was never started</error></jhove>\n"));
     else
         metaText.append(QStringLiteral("<jhove><info>jHove not configured to run</info></jhove>\n"));
 
-    if (veraPDFExitCode > INT_MIN) {
+    if (job->veraPDFExitCode > INT_MIN) {
         /// insert XML data from veraPDF
-        metaText.append(QString(QStringLiteral("<verapdf exitcode=\"%1\" filesize=\"%2\" pdfa1b=\"%3\" pdfa1a=\"%4\">\n")).arg(QString::number(veraPDFExitCode), QString::number(veraPDFfilesize), veraPDFIsPDFA1B ? QStringLiteral("yes") : QStringLiteral("no"), veraPDFIsPDFA1A ? QStringLiteral("yes") : QStringLiteral("no")));
-        if (!veraPDFStandardOutput.isEmpty()) {
+        metaText.append(QString(QStringLiteral("<verapdf exitcode=\"%1\" filesize=\"%2\" pdfa1b=\"%3\" pdfa1a=\"%4\">\n")).arg(QString::number(job->veraPDFExitCode), QString::number(job->veraPDFfilesize), job->veraPDFIsPDFA1B ? QStringLiteral("yes") : QStringLiteral("no"), job->veraPDFIsPDFA1A ? QStringLiteral("yes") : QStringLiteral("no")));
+        if (!job->veraPDFStandardOutput.isEmpty()) {
             /// Check for and omit XML header if it exists
-            const int p = veraPDFStandardOutput.indexOf(QStringLiteral("?>"));
-            metaText.append(p > 1 ? veraPDFStandardOutput.mid(veraPDFStandardOutput.indexOf(QStringLiteral("<"), p)) : veraPDFStandardOutput);
-        } else if (!veraPDFErrorOutput.isEmpty())
-            metaText.append(QString(QStringLiteral("<error>%1</error>\n")).arg(DocScan::xmlify(veraPDFErrorOutput)));
+            const int p = job->veraPDFStandardOutput.indexOf(QStringLiteral("?>"));
+            metaText.append(p > 1 ? job->veraPDFStandardOutput.mid(job->veraPDFStandardOutput.indexOf(QStringLiteral("<"), p)) : job->veraPDFStandardOutput);
+        } else if (!job->veraPDFErrorOutput.isEmpty())
+            metaText.append(QString(QStringLiteral("<error>%1</error>\n")).arg(DocScan::xmlify(job->veraPDFErrorOutput)));
         metaText.append(QStringLiteral("</verapdf>\n"));
-    } else if (!m_veraPDFcliTool.isEmpty())
+    } else if (job->skippedValidators.contains(ValidatorScheduler::VeraPDF))
+        metaText.append(QString(QStringLiteral("<verapdf skipped=\"%1\" />\n")).arg(job->skippedValidators.value(ValidatorScheduler::VeraPDF)));
+    else if (!m_veraPDFcliTool.isEmpty())
         metaText.append(QStringLiteral("<verapdf><error>veraPDF failed to start or was never started</error></verapdf>\n"));
     else
         metaText.append(QStringLiteral("<verapdf><info>veraPDF not configured to run</info></verapdf>\n"));
 
-    if (pdfboxValidatorExitCode > INT_MIN) {
+    if (job->pdfboxValidatorExitCode > INT_MIN) {
         /// insert result from Apache's PDFBox
-        metaText.append(QString(QStringLiteral("<pdfboxvalidator exitcode=\"%1\" pdfa1b=\"%2\">\n")).arg(QString::number(pdfboxValidatorExitCode), pdfboxValidatorValidPdf ? QStringLiteral("yes") : QStringLiteral("no")));
-        if (!pdfboxValidatorStandardOutput.isEmpty())
-            metaText.append(QString(QStringLiteral("<output>%1</output>\n")).arg(DocScan::xmlify(pdfboxValidatorStandardOutput)));
-        else if (!pdfboxValidatorErrorOutput.isEmpty())
-            metaText.append(QString(QStringLiteral("<error>%1</error>\n")).arg(DocScan::xmlify(pdfboxValidatorErrorOutput)));
+        metaText.append(QString(QStringLiteral("<pdfboxvalidator exitcode=\"%1\" pdfa1b=\"%2\">\n")).arg(QString::number(job->pdfboxValidatorExitCode), job->pdfboxValidatorValidPdf ? QStringLiteral("yes") : QStringLiteral("no")));
+        if (!job->pdfboxValidatorStandardOutput.isEmpty())
+            metaText.append(QString(QStringLiteral("<output>%1</output>\n")).arg(DocScan::xmlify(job->pdfboxValidatorStandardOutput)));
+        else if (!job->pdfboxValidatorErrorOutput.isEmpty())
+            metaText.append(QString(QStringLiteral("<error>%1</error>\n")).arg(DocScan::xmlify(job->pdfboxValidatorErrorOutput)));
         metaText.append(QStringLiteral("</pdfboxvalidator>\n"));
-    } else if (!m_pdfboxValidatorJavaClass.isEmpty())
+    } else if (job->skippedValidators.contains(ValidatorScheduler::PdfBoxValidator))
+        metaText.append(QString(QStringLiteral("<pdfboxvalidator skipped=\"%1\" />\n")).arg(job->skippedValidators.value(ValidatorScheduler::PdfBoxValidator)));
+    else if (!m_pdfboxValidatorJavaClass.isEmpty())
         metaText.append(QStringLiteral("<pdfboxvalidator><error>pdfbox Validator failed to start or was never started</error></pdfboxvalidator>\n"));
     else
         metaText.append(QStringLiteral("<pdfboxvalidator><info>pdfbox Validator not configured to run</info></pdfboxvalidator>\n"));
 
-    if (callasPdfAPilotExitCode > INT_MIN) {
-        const bool isPDFA1a = callasPdfAPilotPDFA1letter == 'a' && callasPdfAPilotCountErrors == 0 && callasPdfAPilotCountWarnings == 0;
-        const bool isPDFA1b = isPDFA1a || (callasPdfAPilotPDFA1letter == 'b' && callasPdfAPilotCountErrors == 0 && callasPdfAPilotCountWarnings == 0);
-        metaText.append(QString(QStringLiteral("<callaspdfapilot exitcode=\"%1\" pdfa1b=\"%2\" pdfa1a=\"%3\">\n")).arg(QString::number(callasPdfAPilotExitCode), isPDFA1b ? QStringLiteral("yes") : QStringLiteral("no"), isPDFA1a ? QStringLiteral("yes") : QStringLiteral("no")));
-        if (!callasPdfAPilotStandardOutput.isEmpty())
-            metaText.append(DocScan::xmlify(callasPdfAPilotStandardOutput));
-        else if (!callasPdfAPilotErrorOutput.isEmpty())
-            metaText.append(QString(QStringLiteral("<error>%1</error>\n")).arg(DocScan::xmlify(callasPdfAPilotErrorOutput)));
+    if (job->callasPdfAPilotExitCode > INT_MIN) {
+        const bool isPDFA1a = job->callasPdfAPilotPDFA1letter == 'a' && job->callasPdfAPilotCountErrors == 0 && job->callasPdfAPilotCountWarnings == 0;
+        const bool isPDFA1b = isPDFA1a || (job->callasPdfAPilotPDFA1letter == 'b' && job->callasPdfAPilotCountErrors == 0 && job->callasPdfAPilotCountWarnings == 0);
+        metaText.append(QString(QStringLiteral("<callaspdfapilot exitcode=\"%1\" pdfa1b=\"%2\" pdfa1a=\"%3\">\n")).arg(QString::number(job->callasPdfAPilotExitCode), isPDFA1b ? QStringLiteral("yes") : QStringLiteral("no"), isPDFA1a ? QStringLiteral("yes") : QStringLiteral("no")));
+        if (!job->callasPdfAPilotStandardOutput.isEmpty())
+            metaText.append(DocScan::xmlify(job->callasPdfAPilotStandardOutput));
+        else if (!job->callasPdfAPilotErrorOutput.isEmpty())
+            metaText.append(QString(QStringLiteral("<error>%1</error>\n")).arg(DocScan::xmlify(job->callasPdfAPilotErrorOutput)));
         metaText.append(QStringLiteral("</callaspdfapilot>"));
-    } else if (!m_callasPdfAPilotCLI.isEmpty())
+    } else if (job->skippedValidators.contains(ValidatorScheduler::CallasPdfAPilot))
+        metaText.append(QString(QStringLiteral("<callaspdfapilot skipped=\"%1\" />\n")).arg(job->skippedValidators.value(ValidatorScheduler::CallasPdfAPilot)));
+    else if (!m_callasPdfAPilotCLI.isEmpty())
         metaText.append(QStringLiteral("<callaspdfapilot><error>callas PDF/A Pilot failed to start or was never started</error></callaspdfapilot>\n"));
     else
         metaText.append(QStringLiteral("<callaspdfapilot><info>callas PDF/A Pilot not configured to run</info></callaspdfapilot>\n"));
 
     /// file information including size
-    const QFileInfo fi = QFileInfo(filename);
-    metaText.append(QString(QStringLiteral("<file size=\"%1\" />\n")).arg(fi.size()));
+    metaText.append(QString(QStringLiteral("<file size=\"%1\" />\n")).arg(job->fileSize));
 
     if (!metaText.isEmpty())
         logText.append(QStringLiteral("<meta>\n")).append(metaText).append(QStringLiteral("</meta>\n"));
     const qint64 endTime = QDateTime::currentMSecsSinceEpoch();
 
-    logText.prepend(QString(QStringLiteral("<fileanalysis filename=\"%1\" status=\"ok\" time=\"%2\" external_time=\"%3\">\n")).arg(DocScan::xmlify(filename), QString::number(endTime - startTime), QString::number(externalProgramsEndTime - startTime)));
+    /// A file that made its worker process exceed the time limit is
+    /// reported as such, including whatever validators found out
+    /// A file whose validators got dropped at shutdown is reported as
+    /// aborted, as tools not having run cannot tell if its format is valid
+    logText.prepend(QString(QStringLiteral("<fileanalysis filename=\"%1\" status=\"%4\" time=\"%2\" external_time=\"%3\">\n")).arg(DocScan::xmlify(filename), QString::number(endTime - job->startTime), QString::number(job->externalProgramsEndTime - job->startTime), job->validationAborted ? QStringLiteral("aborted") : (job->popplerWorkerTimedOut ? QStringLiteral("timeout") : QStringLiteral("ok"))));
     logText += QStringLiteral("</fileanalysis>\n");
 
-    if (popplerWrapperOk || jhoveIsPDF || pdfboxValidatorValidPdf)
-        /// At least one tool thought the file was ok
-        emit analysisReport(logText);
-    else
+    if (job->validationAborted)
+        qWarning() << "Analysis of file" << filename << "incomplete as validator scheduler got shut down";
+    else if (job->popplerWorkerAborted && !(job->jhoveIsPDF || job->pdfboxValidatorValidPdf))
+        /// Worker crashed or exceeded its resource limits
+        logText = QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"analysis-aborted\" status=\"error\" external_time=\"%2\"><meta><file size=\"%3\" /></meta></fileanalysis>\n")).arg(DocScan::xmlify(filename), QString::number(job->externalProgramsEndTime - job->startTime)).arg(job->fileSize);
+    else if (!(job->popplerWrapperOk || job->popplerWorkerTimedOut || job->jhoveIsPDF || job->pdfboxValidatorValidPdf))
         /// No tool could handle this file, so give error message
-        emit analysisReport(QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"invalid-fileformat\" status=\"error\" external_time=\"%2\"><meta><file size=\"%3\" /></meta></fileanalysis>\n")).arg(filename, QString::number(externalProgramsEndTime - startTime)).arg(fi.size()));
+        logText = QString(QStringLiteral("<fileanalysis filename=\"%1\" message=\"invalid-fileformat\" status=\"error\" external_time=\"%2\"><meta><file size=\"%3\" /></meta></fileanalysis>\n")).arg(DocScan::xmlify(filename), QString::number(job->externalProgramsEndTime - job->startTime)).arg(job->fileSize);
+    /// else: at least one tool thought the file was ok
+    emit analysisReport(logText);
+
+    if (!job->cacheKey.isEmpty() && !job->transientFailure)
+        AnalysisCache::instance()->store(job->cacheKey, filename, logText);
+
+    if (job->removeAfterAnalysis)
+        QFile::remove(job->validatorFilename);
+
+    /// The destructor must not finish before this function is done,
+    /// but no lock may be held while granting credits, as that may
+    /// start the analysis of another file in this very thread
+    m_numCompletingFiles.ref();
+    m_numPendingFiles.deref();
+    emit creditsGranted(1);
+    checkDrained();
 
-    m_isAlive = false;
+    m_pendingFilesMutex->lock();
+    m_numCompletingFiles.deref();
+    m_pendingFileCompleted->wakeAll();
+    m_pendingFilesMutex->unlock();
 }
@@ -24,9 +24,16 @@
 #define FILEANALYZERPDF_H
 
 #include <QObject>
+#include <QAtomicInt>
 
 #include "fileanalyzerabstract.h"
 
+class QMutex;
+class QWaitCondition;
+
+class PdfValidationJob;
+class PopplerWrapper;
+
 namespace Poppler
 {
 class Document;
@@ -34,6 +41,12 @@ class Document;
 
 /**
  * Analyzing code for Portable Document File documents.
+ * External validators are run asynchronously by the
+ * ValidatorScheduler while the file is analyzed using poppler;
+ * the report for a file is emitted once all validators are done,
+ * usually after analyzeFile(..) has returned and from a different
+ * thread. Documents held in memory are analyzed without touching
+ * the disk unless validators are configured.
  *
  * @author Thomas Fischer <thomas.fischer@his.se>
  */
@@ -41,7 +54,38 @@ class FileAnalyzerPDF : public FileAnalyzerAbstract
 {
     Q_OBJECT
 public:
+    /**
+     * How thoroughly files get analyzed. Each depth includes
+     * everything done at the depths before it.
+     */
+    enum Depth {
+        /// Version, security flags, document information, number of pages, and first page's size only
+        dMetadata = 0,
+        /// Additionally enumerate all fonts
+        dFonts = 1,
+        /// Additionally extract text as configured and run validators
+        dFull = 2
+    };
+
+    /**
+     * Which validators run for a file.
+     */
+    enum ValidatorPolicy {
+        /// All configured validators run in parallel for every file, e.g. for compliance studies
+        vpRunAll = 0,
+        /// Validators run one after another, cheapest as measured so far first,
+        /// skipping those whose outcome is settled by earlier results, e.g. if
+        /// the file is no PDF file according to jHove, cannot be opened by
+        /// poppler, or is encrypted (which PDF/A does not permit)
+        vpCostAware = 1
+    };
+
     explicit FileAnalyzerPDF(QObject *parent = nullptr);
+    /**
+     * Waits until the analysis of all files passed to
+     * this analyzer is complete.
+     */
+    ~FileAnalyzerPDF();
 
     virtual bool isAlive();
 
@@ -50,15 +94,105 @@ public:
     void setupPdfBoXValidator(const QString &pdfboxValidatorJavaClass);
     void setupCallasPdfAPilotCLI(const QString &callasPdfAPilotCLI);
 
+    /**
+     * Let veraPDF or jHove, respectively, validate up to maxFiles
+     * files per invocation, saving the start-up cost (e.g. of a JVM)
+     * for all but the first file. Applies to all analyzers.
+     *
+     * @param maxFiles maximum number of files per invocation; 1 disables batching
+     * @param maxWait time in milliseconds a file may wait for others to fill its batch
+     */
+    static void setupVeraPDFBatching(int maxFiles, int maxWait);
+    static void setupJhoveBatching(int maxFiles, int maxWait);
+
+    /**
+     * Set how thoroughly files get analyzed. Default is dFull.
+     */
+    void setDepth(Depth depth);
+
+    /**
+     * Set which validators run for a file. Default is vpRunAll.
+     */
+    void setValidatorPolicy(ValidatorPolicy policy);
+
+    /**
+     * Analyze files with poppler in separate worker processes instead
+     * of the calling thread, so that malformed files making poppler
+     * loop or exhaust memory affect neither this process nor other
+     * files. Worker processes are kept running for many files and are
+     * scheduled like validator servers by the ValidatorScheduler.
+     *
+     * @param timeout time in milliseconds to analyze a single file before the worker gets killed; 0 disables worker processes
+     * @param cpuLimitSeconds CPU time per file after which the worker gets terminated by the system; 0 for no limit
+     * @param memoryLimitMiB address space limit for each worker process in MiB; 0 for no limit
+     */
+    void setupPopplerWorker(int timeout, int cpuLimitSeconds, int memoryLimitMiB);
+
+    /// Command line argument making DocScan run as a worker process
+    static const char *workerArgument;
+
+    /**
+     * Run as a worker process started by an analyzer configured
+     * via setupPopplerWorker(..): read filenames from standard input
+     * and write each file's results to standard output.
+     *
+     * @param arguments command line arguments following workerArgument
+     * @return exit code for this process
+     */
+    static int runWorker(const QStringList &arguments);
+
 public slots:
     virtual void analyzeFile(const QString &filename);
+    virtual void analyzeData(const QString &filename, const QByteArray &data);
+
+    /**
+     * Same as analyzeData(..), but with the hash of the data
+     * already known, e.g. computed while uncompressing it.
+     *
+     * @param filename name of the document as used in the report
+     * @param data the document's content
+     * @param contentHash hash of the data, see AnalysisCache::contentHash
+     */
+    void analyzeData(const QString &filename, const QByteArray &data, const QByteArray &contentHash);
+
+protected:
+    virtual int numPendingFiles();
 
 private:
-    bool m_isAlive;
+    friend class PdfValidationJob;
+
+    /// Number of files whose analysis is not complete yet
+    QAtomicInt m_numPendingFiles;
+    /// Number of files whose completion still accesses this analyzer
+    QAtomicInt m_numCompletingFiles;
+    /// Signalled whenever a file's analysis is complete
+    QMutex *m_pendingFilesMutex;
+    QWaitCondition *m_pendingFileCompleted;
     QString m_jhoveShellscript;
     QString m_veraPDFcliTool;
     QString m_pdfboxValidatorJavaClass;
     QString m_callasPdfAPilotCLI;
+    Depth m_depth;
+    ValidatorPolicy m_validatorPolicy;
+    int m_workerTimeout, m_workerCpuLimitSeconds, m_workerMemoryLimitMiB;
+
+    void startAnalysis(const QString &filename, const QByteArray &data, const QByteArray &contentHash);
+    QString cacheFingerprint() const;
+    bool hasValidators() const;
+    /**
+     * Write a document held in memory to a temporary file
+     * for validators to read.
+     * @return name of the temporary file, empty on failure
+     */
+    QString writeTemporaryFile(const QString &filename, const QByteArray &data) const;
+    /**
+     * Analyze a file using poppler in the calling thread.
+     *
+     * @param textAnalysisWrapper if not null and the text's language is to be identified, receives poppler's document for TextAnalysis, which has to delete it; otherwise the language gets identified in the calling thread
+     * @return 'true' if poppler could load the file
+     */
+    bool analyzeWithPoppler(const QString &filename, const QByteArray &data, QString &logText, QString &metaText, PopplerWrapper **textAnalysisWrapper = nullptr);
+    void analysisComplete(PdfValidationJob *job);
 };
 
 #endif // FILEANALYZERPDF_H
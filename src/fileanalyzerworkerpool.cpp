@@ -0,0 +1,245 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#include "fileanalyzerworkerpool.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QTime>
+#include <QDebug>
+
+#include "fileanalyzermultiplexer.h"
+
+class FileAnalyzerWorkerPool::Worker : public QThread
+{
+private:
+    FileAnalyzerWorkerPool *p;
+    const int m_index;
+
+public:
+    Worker(FileAnalyzerWorkerPool *parent, int index)
+        : QThread(), p(parent), m_index(index) {
+        setObjectName(QString(QStringLiteral("FileAnalyzerWorker%1")).arg(index));
+    }
+
+protected:
+    void run() {
+        /// The analyzer has to be created inside this thread, so that
+        /// objects like QProcess created by the analyzer belong to this thread
+        FileAnalyzerMultiplexer analyzer(p->m_filters);
+        analyzer.setTextExtraction(p->textExtraction);
+        if (!p->m_jhoveShellscript.isEmpty())
+            analyzer.setupJhove(p->m_jhoveShellscript);
+        if (!p->m_veraPDFcliTool.isEmpty())
+            analyzer.setupVeraPDF(p->m_veraPDFcliTool);
+        if (!p->m_pdfboxValidatorJavaClass.isEmpty())
+            analyzer.setupPdfBoXValidator(p->m_pdfboxValidatorJavaClass);
+        if (!p->m_callasPdfAPilotCLI.isEmpty())
+            analyzer.setupCallasPdfAPilotCLI(p->m_callasPdfAPilotCLI);
+        analyzer.setPdfDepth(p->m_pdfDepth);
+        analyzer.setPdfValidatorPolicy(p->m_pdfValidatorPolicy);
+        analyzer.setupPopplerWorker(p->m_workerTimeout, p->m_workerCpuLimitSeconds, p->m_workerMemoryLimitMiB);
+        /// Reports are passed on by the pool; as the pool lives in the main thread,
+        /// the final connection to the log collector will be a queued one
+        connect(&analyzer, SIGNAL(analysisReport(QString)), p, SIGNAL(analysisReport(QString)), Qt::DirectConnection);
+        connect(&analyzer, SIGNAL(creditsGranted(int)), p, SLOT(workerCreditsGranted(int)), Qt::DirectConnection);
+
+        /// qrand's state is per-thread, make sure that temporary file names
+        /// chosen by different workers do not collide
+        qsrand(QTime::currentTime().msec() * (m_index + 1) + m_index);
+
+        QString filename;
+        QByteArray data;
+        while (p->takeNextFile(filename, data)) {
+            if (data.isNull())
+                analyzer.analyzeFile(filename);
+            else
+                analyzer.analyzeData(filename, data);
+        }
+        /// Leaving the scope waits for asynchronous analyses to complete
+    }
+};
+
+FileAnalyzerWorkerPool::FileAnalyzerWorkerPool(const QStringList &filters, int numWorkers, int queueSize, QObject *parent)
+    : FileAnalyzerAbstract(parent), m_filters(filters), m_numWorkers(numWorkers > 0 ? numWorkers : qMax(1, QThread::idealThreadCount())), m_queueSize(queueSize > 0 ? queueSize : m_numWorkers * 4), m_pdfDepth(FileAnalyzerPDF::dFull), m_pdfValidatorPolicy(FileAnalyzerPDF::vpRunAll), m_workerTimeout(0), m_workerCpuLimitSeconds(0), m_workerMemoryLimitMiB(0), m_submittingFiles(0), m_unfinishedFiles(0), m_shuttingDown(false)
+{
+    m_mutex = new QMutex();
+    m_queueNotEmpty = new QWaitCondition();
+    m_queueNotFull = new QWaitCondition();
+}
+
+FileAnalyzerWorkerPool::~FileAnalyzerWorkerPool()
+{
+    shutdown();
+    delete m_queueNotFull;
+    delete m_queueNotEmpty;
+    delete m_mutex;
+}
+
+bool FileAnalyzerWorkerPool::isAlive()
+{
+    return numPendingFiles() > 0;
+}
+
+int FileAnalyzerWorkerPool::numPendingFiles()
+{
+    QMutexLocker locker(m_mutex);
+    return m_submittingFiles + m_unfinishedFiles;
+}
+
+void FileAnalyzerWorkerPool::setupJhove(const QString &shellscript)
+{
+    m_jhoveShellscript = shellscript;
+}
+
+void FileAnalyzerWorkerPool::setupVeraPDF(const QString &cliTool)
+{
+    m_veraPDFcliTool = cliTool;
+}
+
+void FileAnalyzerWorkerPool::setupPdfBoXValidator(const QString &pdfboxValidatorJavaClass)
+{
+    m_pdfboxValidatorJavaClass = pdfboxValidatorJavaClass;
+}
+
+void FileAnalyzerWorkerPool::setupCallasPdfAPilotCLI(const QString &callasPdfAPilotCLI)
+{
+    m_callasPdfAPilotCLI = callasPdfAPilotCLI;
+}
+
+void FileAnalyzerWorkerPool::setPdfDepth(FileAnalyzerPDF::Depth depth)
+{
+    m_pdfDepth = depth;
+}
+
+void FileAnalyzerWorkerPool::setPdfValidatorPolicy(FileAnalyzerPDF::ValidatorPolicy policy)
+{
+    m_pdfValidatorPolicy = policy;
+}
+
+void FileAnalyzerWorkerPool::setupPopplerWorker(int timeout, int cpuLimitSeconds, int memoryLimitMiB)
+{
+    m_workerTimeout = timeout;
+    m_workerCpuLimitSeconds = cpuLimitSeconds;
+    m_workerMemoryLimitMiB = memoryLimitMiB;
+}
+
+int FileAnalyzerWorkerPool::numWorkers() const
+{
+    return m_numWorkers;
+}
+
+void FileAnalyzerWorkerPool::analyzeFile(const QString &filename)
+{
+    enqueue(filename, QByteArray());
+}
+
+void FileAnalyzerWorkerPool::analyzeData(const QString &filename, const QByteArray &data)
+{
+    enqueue(filename, data);
+}
+
+void FileAnalyzerWorkerPool::enqueue(const QString &filename, const QByteArray &data)
+{
+    /// Workers get started lazily, i.e. after all setup functions
+    /// and setTextExtraction have been called
+    if (m_workers.isEmpty())
+        startWorkers();
+
+    m_mutex->lock();
+    /// While waiting below, workers may report upstream as drained;
+    /// this file must already count as pending then
+    ++m_submittingFiles;
+    /// Queue is full, wait for a worker to pick up a file. No events get
+    /// processed meanwhile, as that would let further files get enqueued
+    /// from within this call and out of order; with flow control enabled,
+    /// upstream credits keep the queue from filling up in the first place
+    while (m_queue.count() >= m_queueSize && !m_shuttingDown)
+        m_queueNotFull->wait(m_mutex);
+    --m_submittingFiles;
+    if (m_shuttingDown) {
+        m_mutex->unlock();
+        qWarning() << "Worker pool is shutting down, not analyzing file" << filename;
+        emit creditsGranted(1);
+        return;
+    }
+    QueuedDocument document;
+    document.filename = filename;
+    document.data = data;
+    m_queue.enqueue(document);
+    ++m_unfinishedFiles;
+    m_queueNotEmpty->wakeOne();
+    m_mutex->unlock();
+}
+
+void FileAnalyzerWorkerPool::shutdown()
+{
+    m_mutex->lock();
+    m_shuttingDown = true;
+    m_queueNotEmpty->wakeAll();
+    m_queueNotFull->wakeAll();
+    m_mutex->unlock();
+
+    for (Worker *worker : const_cast<const QList<Worker *> &>(m_workers)) {
+        worker->wait();
+        delete worker;
+    }
+    m_workers.clear();
+}
+
+void FileAnalyzerWorkerPool::startWorkers()
+{
+    qDebug() << "Starting" << m_numWorkers << "analysis workers with a queue size of" << m_queueSize;
+    for (int i = 0; i < m_numWorkers; ++i) {
+        Worker *worker = new Worker(this, i);
+        m_workers.append(worker);
+        worker->start();
+    }
+}
+
+bool FileAnalyzerWorkerPool::takeNextFile(QString &filename, QByteArray &data)
+{
+    QMutexLocker locker(m_mutex);
+    while (m_queue.isEmpty() && !m_shuttingDown)
+        m_queueNotEmpty->wait(m_mutex);
+    /// Remaining files in the queue are processed even when shutting down
+    if (m_queue.isEmpty())
+        return false;
+
+    const QueuedDocument document = m_queue.dequeue();
+    filename = document.filename;
+    data = document.data;
+    m_queueNotFull->wakeOne();
+    return true;
+}
+
+void FileAnalyzerWorkerPool::workerCreditsGranted(int credits)
+{
+    /// Called from worker threads or the validator scheduler's thread
+    m_mutex->lock();
+    m_unfinishedFiles -= credits;
+    m_mutex->unlock();
+
+    emit creditsGranted(credits);
+    checkDrained();
+}
@@ -0,0 +1,126 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#ifndef FILEANALYZERWORKERPOOL_H
+#define FILEANALYZERWORKERPOOL_H
+
+#include <QStringList>
+#include <QQueue>
+
+#include "fileanalyzerabstract.h"
+#include "fileanalyzerpdf.h"
+
+class QMutex;
+class QWaitCondition;
+
+/**
+ * Distributes files to be analyzed over a number of worker
+ * threads. Each worker thread owns its own FileAnalyzerMultiplexer
+ * (and thus its own set of specialized analyzers), so no analyzer
+ * object is ever shared between threads.
+ * Files are passed to the workers through a bounded queue: if the
+ * queue is full, analyzeFile/analyzeData will block without processing
+ * events until a worker has picked up a file, keeping the number of
+ * pending files limited.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class FileAnalyzerWorkerPool : public FileAnalyzerAbstract
+{
+    Q_OBJECT
+public:
+    /**
+     * Create a pool of analysis workers.
+     *
+     * @param filters list of filters as passed to each worker's FileAnalyzerMultiplexer
+     * @param numWorkers number of worker threads; if not positive, the number of CPU cores is used
+     * @param queueSize maximum number of files waiting for a worker; if not positive, four times the number of workers is used
+     */
+    explicit FileAnalyzerWorkerPool(const QStringList &filters, int numWorkers, int queueSize, QObject *parent = nullptr);
+    ~FileAnalyzerWorkerPool();
+
+    virtual bool isAlive();
+
+    void setupJhove(const QString &shellscript);
+    void setupVeraPDF(const QString &cliTool);
+    void setupPdfBoXValidator(const QString &pdfboxValidatorJavaClass);
+    void setupCallasPdfAPilotCLI(const QString &callasPdfAPilotCLI);
+    void setPdfDepth(FileAnalyzerPDF::Depth depth);
+    void setPdfValidatorPolicy(FileAnalyzerPDF::ValidatorPolicy policy);
+    void setupPopplerWorker(int timeout, int cpuLimitSeconds, int memoryLimitMiB);
+
+    int numWorkers() const;
+
+public slots:
+    virtual void analyzeFile(const QString &filename);
+    virtual void analyzeData(const QString &filename, const QByteArray &data);
+
+    /**
+     * Let all workers finish the files remaining in the queue,
+     * then stop and join all worker threads.
+     * Should be called before the application exits.
+     */
+    void shutdown();
+
+protected:
+    virtual int numPendingFiles();
+
+private slots:
+    void workerCreditsGranted(int credits);
+
+private:
+    class Worker;
+    struct QueuedDocument {
+        QString filename;
+        /// Null if the document is to be read from disk
+        QByteArray data;
+    };
+
+    const QStringList m_filters;
+    const int m_numWorkers;
+    const int m_queueSize;
+    QString m_jhoveShellscript;
+    QString m_veraPDFcliTool;
+    QString m_pdfboxValidatorJavaClass;
+    QString m_callasPdfAPilotCLI;
+    FileAnalyzerPDF::Depth m_pdfDepth;
+    FileAnalyzerPDF::ValidatorPolicy m_pdfValidatorPolicy;
+    int m_workerTimeout, m_workerCpuLimitSeconds, m_workerMemoryLimitMiB;
+
+    QList<Worker *> m_workers;
+    QQueue<QueuedDocument> m_queue;
+    /// Number of analyzeFile/analyzeData calls waiting for space in the queue
+    int m_submittingFiles;
+    /// Number of files enqueued but whose analysis is not complete yet;
+    /// as analyzers may complete files asynchronously, a file counts
+    /// as complete once its credit has been granted
+    int m_unfinishedFiles;
+    bool m_shuttingDown;
+    QMutex *m_mutex;
+    QWaitCondition *m_queueNotEmpty, *m_queueNotFull;
+
+    void startWorkers();
+    void enqueue(const QString &filename, const QByteArray &data);
+    bool takeNextFile(QString &filename, QByteArray &data);
+};
+
+#endif // FILEANALYZERWORKERPOOL_H
@@ -22,10 +22,68 @@
 
 #include "filefinder.h"
 
+#include <QTimer>
+
 const int FileFinder::ResultNoError = 0;
 const int FileFinder::ResultUnspecifiedError = 1;
 
 FileFinder::FileFinder(QObject *parent)
-    : QObject(parent)
+    : QObject(parent), m_credits(-1), m_waitingForCredits(false)
+{
+}
+
+void FileFinder::setFlowControl(int initialCredits)
+{
+    m_credits = qMax(0, initialCredits);
+}
+
+bool FileFinder::reportsDrained() const
+{
+    return false;
+}
+
+void FileFinder::setCompletedFiles(const QSet<QString> &files)
+{
+    m_completedFiles = files;
+}
+
+void FileFinder::grantCredits(int credits)
+{
+    if (m_credits < 0 || credits <= 0) return; ///< flow control not enabled or nothing to grant
+
+    m_credits += credits;
+    if (m_waitingForCredits) {
+        m_waitingForCredits = false;
+        /// Do not continue the search right here, as this function may be
+        /// called from deep inside the call stack of a previously emitted hit
+        QTimer::singleShot(0, this, SLOT(resumeSearch()));
+    }
+}
+
+bool FileFinder::creditAvailable()
+{
+    if (m_credits != 0) return true;
+
+    m_waitingForCredits = true;
+    return false;
+}
+
+void FileFinder::useCredit()
+{
+    if (m_credits > 0) --m_credits;
+}
+
+void FileFinder::continueSearch()
+{
+    // nothing
+}
+
+bool FileFinder::isCompleted(const QString &filename) const
+{
+    return m_completedFiles.contains(filename);
+}
+
+void FileFinder::resumeSearch()
 {
+    continueSearch();
 }
@@ -25,6 +25,7 @@
 
 #include <QObject>
 #include <QUrl>
+#include <QSet>
 
 #include "watchable.h"
 
@@ -55,6 +56,37 @@ public:
      */
     virtual void startSearch(int numExpectedHits) = 0;
 
+    /**
+     * Enable credit-based flow control. Once enabled, a finder
+     * supporting flow control will only emit as many hits as it
+     * has credits and will pause until downstream components
+     * grant more credits via grantCredits(int).
+     * Without calling this function, credits are unlimited.
+     *
+     * @param initialCredits number of hits that may be emitted before further credits have to be granted
+     */
+    void setFlowControl(int initialCredits);
+
+    /**
+     * Test if this finder emits drained() once it has found all
+     * files it is going to find. Finders that cannot determine
+     * the end of their search (e.g. web crawlers waiting for
+     * replies) return false, in which case the end of processing
+     * has to be detected by a WatchDog instead.
+     * Default implementation returns false.
+     */
+    virtual bool reportsDrained() const;
+
+    /**
+     * Set files that were completed in a previous run and that
+     * shall not be reported as hits again, e.g. when resuming
+     * an interrupted run. Finders working on local files skip
+     * those files without consuming credits.
+     *
+     * @param files local filenames as passed on to file analyzers
+     */
+    void setCompletedFiles(const QSet<QString> &files);
+
 signals:
     /**
      * Notification about a found url that can be downloaded
@@ -66,6 +98,63 @@ signals:
      * Log message about an event that should be reported.
      */
     void report(QString);
+
+    /**
+     * Notification that the search is complete and that
+     * no further foundUrl(..) signals will be emitted.
+     * Only emitted if reportsDrained() returns true.
+     */
+    void drained();
+
+public slots:
+    /**
+     * Grant additional credits, i.e. allow this finder to emit
+     * further hits. Usually connected to the downstream component
+     * that reports when it has capacity for more work.
+     * Searches paused due to lack of credits get resumed
+     * asynchronously via the event loop.
+     *
+     * @param credits number of additional hits that may be emitted
+     */
+    void grantCredits(int credits);
+
+protected:
+    /**
+     * Check if another hit may be emitted. If flow control is
+     * disabled, this is always the case. Otherwise, this function
+     * will return false if there are no credits left and will
+     * remember to resume the search once credits get granted.
+     * Does not consume any credit, see useCredit().
+     */
+    bool creditAvailable();
+
+    /**
+     * Consume one credit for a hit to be emitted.
+     * Call only if creditAvailable() returned true.
+     */
+    void useCredit();
+
+    /**
+     * Continue a search paused due to lack of credits.
+     * Finders supporting flow control have to re-implement
+     * this function. Default implementation does nothing.
+     */
+    virtual void continueSearch();
+
+    /**
+     * Test if a file was completed in a previous run,
+     * see setCompletedFiles(..).
+     */
+    bool isCompleted(const QString &filename) const;
+
+private slots:
+    void resumeSearch();
+
+private:
+    /// Number of hits that may be emitted, -1 for unlimited
+    int m_credits;
+    bool m_waitingForCredits;
+    QSet<QString> m_completedFiles;
 };
 
 #endif // FILEFINDER_H
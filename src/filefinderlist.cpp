@@ -31,37 +31,70 @@
 #include "general.h"
 
 FileFinderList::FileFinderList(const QString &listFile, QObject *parent)
-    : FileFinder(parent) {
+    : FileFinder(parent), m_hits(0), m_numExpectedHits(0), m_skipped(0), m_file(nullptr), m_textStream(nullptr) {
     m_listFile = listFile;
     m_alive = false;
     qDebug() << "listFile= " << m_listFile;
 }
 
+FileFinderList::~FileFinderList() {
+    delete m_textStream;
+    delete m_file;
+}
+
 void FileFinderList::startSearch(int numExpectedHits) {
     m_alive = true;
+    m_hits = 0;
+    m_numExpectedHits = numExpectedHits;
+    m_skipped = 0;
 
-    int hits = 0;
-    QFile file(m_listFile);
-    if (file.open(QFile::ReadOnly)) {
-        QTextStream ts(&file);
-        while (!ts.atEnd() && hits < numExpectedHits) {
-            const QString filename = ts.readLine();
-            QFileInfo fi(filename);
-            if (fi.exists() && fi.isFile()) {
-                emit report(QString(QStringLiteral("<filefinder event=\"hit\" href=\"%1\" />\n")).arg(DocScan::xmlify(filename)));
-                emit foundUrl(QUrl::fromLocalFile(filename));
-                ++hits;
-            } else
-                qWarning() << "File does not exist: " << filename;
-        }
-        file.close();
-    } else
+    m_file = new QFile(m_listFile);
+    if (m_file->open(QFile::ReadOnly))
+        m_textStream = new QTextStream(m_file);
+    else
         qWarning() << "Could not open file: " << m_listFile;
 
-    emit report(QString(QStringLiteral("<filefinderlist listfile=\"%2\" numresults=\"%1\" />\n")).arg(QString::number(hits), DocScan::xmlify(m_listFile)));
+    continueSearch();
+}
+
+void FileFinderList::continueSearch() {
+    if (!m_alive) return;
+
+    while (m_textStream != nullptr && !m_textStream->atEnd() && m_hits < m_numExpectedHits) {
+        /// Pause until downstream components grant more credits
+        if (!creditAvailable()) return;
+
+        const QString filename = m_textStream->readLine();
+        QFileInfo fi(filename);
+        if (isCompleted(filename)) {
+            /// Analyzed in a previous run already
+            ++m_skipped;
+        } else if (fi.exists() && fi.isFile()) {
+            useCredit();
+            ++m_hits;
+            emit report(QString(QStringLiteral("<filefinder event=\"hit\" href=\"%1\" />\n")).arg(DocScan::xmlify(filename)));
+            emit foundUrl(QUrl::fromLocalFile(filename));
+            /// Search may have been completed while emitting the hit
+            if (!m_alive) return;
+        } else
+            qWarning() << "File does not exist: " << filename;
+    }
+
     m_alive = false;
+    delete m_textStream;
+    m_textStream = nullptr;
+    if (m_file != nullptr) m_file->close();
+    delete m_file;
+    m_file = nullptr;
+
+    emit report(QString(QStringLiteral("<filefinderlist listfile=\"%2\" numresults=\"%1\"%3 />\n")).arg(QString::number(m_hits), DocScan::xmlify(m_listFile), m_skipped > 0 ? QString(QStringLiteral(" skipped=\"%1\"")).arg(m_skipped) : QString()));
+    emit drained();
 }
 
 bool FileFinderList::isAlive() {
     return m_alive;
 }
+
+bool FileFinderList::reportsDrained() const {
+    return true;
+}
@@ -22,6 +22,9 @@
 
 #include "filefinder.h"
 
+class QFile;
+class QTextStream;
+
 /**
  * @author Thomas Fischer <thomas.fischer@his.se>
  */
@@ -30,11 +33,22 @@ class FileFinderList : public FileFinder
     Q_OBJECT
 public:
     explicit FileFinderList(const QString &listFile, QObject *parent = nullptr);
+    ~FileFinderList();
 
     virtual void startSearch(int numExpectedHits);
     virtual bool isAlive();
+    virtual bool reportsDrained() const;
+
+protected:
+    virtual void continueSearch();
 
 private:
     QString m_listFile;
     bool m_alive;
+    int m_hits, m_numExpectedHits;
+    /// Number of files skipped as completed in a previous run
+    int m_skipped;
+    /// List file is kept open and read line by line while searching
+    QFile *m_file;
+    QTextStream *m_textStream;
 };
@@ -26,44 +26,83 @@
 #include <QDebug>
 
 #include "general.h"
+#include "stagetiming.h"
 
 FileSystemScan::FileSystemScan(const QStringList &filters, const QString &baseDir, QObject *parent)
-    : FileFinder(parent), m_filters(filters), m_baseDir(baseDir), m_alive(false)
+    : FileFinder(parent), m_filters(filters), m_baseDir(baseDir), m_alive(false), m_hits(0), m_numExpectedHits(0), m_skipped(0)
 {
 }
 
 void FileSystemScan::startSearch(int numExpectedHits)
 {
     m_alive = true;
-    QStringList queue = QStringList() << m_baseDir;
-    int hits = 0;
-
-    while (hits < numExpectedHits && !queue.isEmpty()) {
-        QDir dir = QDir(queue.first());
-        queue.removeFirst();
-
-        const QStringList files = dir.entryList(m_filters, QDir::Files, QDir::Name | QDir::IgnoreCase);
-        for (const QString &filename : files) {
-            QUrl url = QUrl::fromLocalFile(dir.absolutePath() + QDir::separator() + filename);
-            emit report(QString(QStringLiteral("<filefinder event=\"hit\" href=\"%1\" />\n")).arg(DocScan::xmlify(url.toString())));
-            emit foundUrl(url);
-            ++hits;
-            if (hits >= numExpectedHits) break;
-        }
+    m_dirQueue = QStringList() << m_baseDir;
+    m_pendingFiles.clear();
+    m_hits = 0;
+    m_numExpectedHits = numExpectedHits;
+    m_skipped = 0;
+
+    continueSearch();
+}
+
+void FileSystemScan::continueSearch()
+{
+    if (!m_alive) return;
+
+    while (m_hits < m_numExpectedHits) {
+        if (m_pendingFiles.isEmpty()) {
+            if (m_dirQueue.isEmpty()) break;
+
+            StageTimer timer(QStringLiteral("find"));
+            const QDir dir = QDir(m_dirQueue.first());
+            m_dirQueue.removeFirst();
 
-        const QStringList subdirEntries = dir.entryList(QDir::Dirs);
-        for (const QString &subdir : subdirEntries) {
-            if (subdir != QStringLiteral(".") && subdir != QStringLiteral("..")) {
-                queue.append(dir.absolutePath() + QDir::separator() + subdir);
+            const QStringList files = dir.entryList(m_filters, QDir::Files, QDir::Name | QDir::IgnoreCase);
+            for (const QString &filename : files)
+                m_pendingFiles.append(dir.absolutePath() + QDir::separator() + filename);
+
+            const QStringList subdirEntries = dir.entryList(QDir::Dirs);
+            for (const QString &subdir : subdirEntries) {
+                if (subdir != QStringLiteral(".") && subdir != QStringLiteral("..")) {
+                    m_dirQueue.append(dir.absolutePath() + QDir::separator() + subdir);
+                }
             }
+            continue;
+        }
+
+        if (isCompleted(m_pendingFiles.first())) {
+            /// Analyzed in a previous run already
+            m_pendingFiles.removeFirst();
+            ++m_skipped;
+            continue;
         }
+
+        /// Pause until downstream components grant more credits
+        if (!creditAvailable()) return;
+        useCredit();
+
+        QUrl url = QUrl::fromLocalFile(m_pendingFiles.first());
+        m_pendingFiles.removeFirst();
+        ++m_hits;
+        emit report(QString(QStringLiteral("<filefinder event=\"hit\" href=\"%1\" />\n")).arg(DocScan::xmlify(url.toString())));
+        emit foundUrl(url);
+        /// Search may have been completed while emitting the hit
+        if (!m_alive) return;
     }
 
-    emit report(QString(QStringLiteral("<filesystemscan filter=\"%3\" directory=\"%2\" numresults=\"%1\" />\n")).arg(QString::number(hits), DocScan::xmlify(QDir(m_baseDir).absolutePath()), DocScan::xmlify(m_filters.join(QChar('|')))));
     m_alive = false;
+    m_dirQueue.clear();
+    m_pendingFiles.clear();
+    emit report(QString(QStringLiteral("<filesystemscan filter=\"%3\" directory=\"%2\" numresults=\"%1\"%4 />\n")).arg(QString::number(m_hits), DocScan::xmlify(QDir(m_baseDir).absolutePath()), DocScan::xmlify(m_filters.join(QChar('|'))), m_skipped > 0 ? QString(QStringLiteral(" skipped=\"%1\"")).arg(m_skipped) : QString()));
+    emit drained();
 }
 
 bool FileSystemScan::isAlive()
 {
     return m_alive;
 }
+
+bool FileSystemScan::reportsDrained() const
+{
+    return true;
+}
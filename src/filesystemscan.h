@@ -47,11 +47,22 @@ public:
 
     virtual void startSearch(int numExpectedHits);
     virtual bool isAlive();
+    virtual bool reportsDrained() const;
+
+protected:
+    virtual void continueSearch();
 
 private:
     const QStringList m_filters;
     const QString m_baseDir;
     bool m_alive;
+    int m_hits, m_numExpectedHits;
+    /// Number of files skipped as completed in a previous run
+    int m_skipped;
+    /// Directories still to be scanned
+    QStringList m_dirQueue;
+    /// Files found in the most recently scanned directory but not yet reported
+    QStringList m_pendingFiles;
 };
 
 #endif // FILESYSTEMSCAN_H
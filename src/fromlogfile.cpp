@@ -32,7 +32,7 @@
 #include "general.h"
 
 FromLogFileFileFinder::FromLogFileFileFinder(const QString &logfilename, const QStringList &filters, QObject *parent)
-    : FileFinder(parent), m_isAlive(true), filenameRegExp(filters.isEmpty() ? QRegExp() : QRegExp(QString(QStringLiteral("(^|/)(%1)$")).arg(filters.join(QChar('|'))).replace(QChar('.'), QStringLiteral("[.]")).replace(QChar('*'), QStringLiteral(".*"))))
+    : FileFinder(parent), m_remainingHits(0), m_isAlive(true), filenameRegExp(filters.isEmpty() ? QRegExp() : QRegExp(QString(QStringLiteral("(^|/)(%1)$")).arg(filters.join(QChar('|'))).replace(QChar('.'), QStringLiteral("[.]")).replace(QChar('*'), QStringLiteral(".*"))))
 {
     QFile input(logfilename);
     if (input.open(QFile::ReadOnly)) {
@@ -59,13 +59,30 @@ FromLogFileFileFinder::FromLogFileFileFinder(const QString &logfilename, const Q
 void FromLogFileFileFinder::startSearch(int numExpectedHits)
 {
     emit report(QString(QStringLiteral("<filefinder count=\"%1\" type=\"fromlogfilefilefinder\" regexp=\"%2\"/>\n")).arg(m_urlSet.count()).arg(DocScan::xmlify(filenameRegExp.pattern())));
-    int count = numExpectedHits;
-    for (const QUrl &url : const_cast<const QSet<QUrl> &>(m_urlSet)) {
-        if (count <= 0) break;
+    m_nextUrl = m_urlSet.constBegin();
+    m_remainingHits = numExpectedHits;
+
+    continueSearch();
+}
+
+void FromLogFileFileFinder::continueSearch()
+{
+    if (!m_isAlive) return;
+
+    while (m_remainingHits > 0 && m_nextUrl != m_urlSet.constEnd()) {
+        /// Pause until downstream components grant more credits
+        if (!creditAvailable()) return;
+        useCredit();
+
+        const QUrl url = *m_nextUrl;
+        ++m_nextUrl;
+        --m_remainingHits;
         emit foundUrl(url);
-        --count;
+        /// Search may have been completed while emitting the hit
+        if (!m_isAlive) return;
     }
     m_isAlive = false;
+    emit drained();
 }
 
 bool FromLogFileFileFinder::isAlive()
@@ -73,6 +90,11 @@ bool FromLogFileFileFinder::isAlive()
     return m_isAlive;
 }
 
+bool FromLogFileFileFinder::reportsDrained() const
+{
+    return true;
+}
+
 FromLogFileDownloader::FromLogFileDownloader(const QString &logfilename, const QStringList &filters, QObject *parent)
     : Downloader(parent), m_logfilename(logfilename), m_isAlive(true), filenameRegExp(filters.isEmpty() ? QRegExp() : QRegExp(QString(QStringLiteral("(^|/)(%1)$")).arg(filters.join(QChar('|'))).replace(QChar('.'), QStringLiteral("[.]")).replace(QChar('*'), QStringLiteral(".*"))))
 {
@@ -114,6 +136,7 @@ void FromLogFileDownloader::startParsingAndEmitting()
         qWarning() << "Could not find or open old log file" << m_logfilename;
 
     m_isAlive = false;
+    checkDrained();
 }
 
 void FromLogFileDownloader::download(const QUrl &url)
@@ -130,3 +153,9 @@ bool FromLogFileDownloader::isAlive()
 {
     return m_isAlive;
 }
+
+int FromLogFileDownloader::numPendingUrls()
+{
+    /// All downloads are emitted at once after parsing the old log file
+    return m_isAlive ? 1 : 0;
+}
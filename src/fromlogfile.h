@@ -50,9 +50,16 @@ public:
 
     virtual void startSearch(int numExpectedHits);
     virtual bool isAlive();
+    virtual bool reportsDrained() const;
+
+protected:
+    virtual void continueSearch();
 
 private:
     QSet<QUrl> m_urlSet;
+    /// Next URL to report; m_urlSet must not be modified while searching
+    QSet<QUrl>::ConstIterator m_nextUrl;
+    int m_remainingHits;
     bool m_isAlive;
     const QRegExp filenameRegExp;
 };
@@ -85,6 +92,9 @@ public slots:
     void download(const QUrl &);
     void finalReport();
 
+protected:
+    virtual int numPendingUrls();
+
 private slots:
     void startParsingAndEmitting();
 
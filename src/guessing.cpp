@@ -26,9 +26,14 @@
 #include <QHash>
 #include <QVector>
 #include <QRegExp>
+#include <QMutex>
 
 #include "general.h"
 
+/// Guessing functions use static QRegExp objects which keep their
+/// match state internally, so concurrent calls have to be serialized
+static QMutex guessingMutex;
+
 Guessing::Guessing()
 {
     /// nothing
@@ -36,6 +41,7 @@ Guessing::Guessing()
 
 QString Guessing::fontToXML(const QString &fontName, const QString &typeName)
 {
+    QMutexLocker locker(&guessingMutex);
     QHash<QString, QString> name, beautifiedName, license, technology;
     name[QStringLiteral("")] = fontName;
     license[QStringLiteral("type")] = QStringLiteral("unknown"); ///< default: license type is unknown
@@ -290,6 +296,7 @@ QString Guessing::fontToXML(const QString &fontName, const QString &typeName)
 }
 
 QString Guessing::programToXML(const QString &program) {
+    QMutexLocker locker(&guessingMutex);
     const QString text = program.toLower();
     QHash<QString, QString> xml;
     xml[QStringLiteral("")] = program;
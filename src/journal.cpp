@@ -0,0 +1,87 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#include "journal.h"
+
+#include <unistd.h>
+
+#include <QFile>
+#include <QDebug>
+
+Journal::Journal(const QString &filename, bool resume)
+{
+    m_file = new QFile(filename);
+
+    if (resume && m_file->open(QFile::ReadWrite)) {
+        const QByteArray data = m_file->readAll();
+        /// An interrupted run may have left an incomplete last line;
+        /// ignore it and let new entries overwrite it
+        const int validLength = data.lastIndexOf('\n') + 1;
+        const QList<QByteArray> lines = data.left(validLength).split('\n');
+        for (const QByteArray &line : lines)
+            if (!line.isEmpty())
+                m_completedFiles.insert(QString::fromUtf8(line));
+        m_file->resize(validLength);
+        m_file->seek(validLength);
+        qDebug() << "Resuming with" << m_completedFiles.count() << "completed files from journal" << filename;
+    } else if (!m_file->open(QFile::WriteOnly | QFile::Truncate))
+        qWarning() << "Cannot open journal file" << filename;
+}
+
+Journal::~Journal()
+{
+    commit();
+    delete m_file;
+}
+
+const QSet<QString> &Journal::completedFiles() const
+{
+    return m_completedFiles;
+}
+
+void Journal::append(const QString &filename)
+{
+    /// Entries are separated by line breaks
+    if (filename.contains(QChar('\n'))) return;
+    m_uncommitted.append(filename);
+}
+
+int Journal::numUncommitted() const
+{
+    return m_uncommitted.count();
+}
+
+bool Journal::commit()
+{
+    if (m_uncommitted.isEmpty()) return true;
+    if (!m_file->isOpen()) return false;
+
+    QByteArray data;
+    for (const QString &filename : const_cast<const QStringList &>(m_uncommitted))
+        data.append(filename.toUtf8()).append('\n');
+    m_uncommitted.clear();
+
+    const bool ok = m_file->write(data) == data.size() && m_file->flush() && fsync(m_file->handle()) == 0;
+    if (!ok)
+        qWarning() << "Failed to write to journal file" << m_file->fileName();
+    return ok;
+}
@@ -0,0 +1,85 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <QString>
+#include <QStringList>
+#include <QSet>
+
+class QFile;
+
+/**
+ * Append-only record of files whose analysis has been completed
+ * and written to the log. Used to resume an interrupted run
+ * without analyzing the same files again.
+ * Entries are collected via append(..) and written to disk in
+ * groups by commit(..), which has to be called only after the
+ * corresponding reports have been flushed to the log, so that
+ * every committed entry is guaranteed to have its report on disk.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class Journal
+{
+public:
+    /**
+     * Open a journal file.
+     *
+     * @param filename file to store journal in
+     * @param resume if 'true', read entries from a previous run and append new entries; otherwise start an empty journal
+     */
+    Journal(const QString &filename, bool resume);
+    ~Journal();
+
+    /**
+     * Files recorded as completed in the journal of a previous run.
+     * Empty if not resuming.
+     */
+    const QSet<QString> &completedFiles() const;
+
+    /**
+     * Record a file as completed. The entry is not written
+     * to disk before the next call to commit().
+     */
+    void append(const QString &filename);
+
+    /**
+     * Number of entries appended but not committed yet.
+     */
+    int numUncommitted() const;
+
+    /**
+     * Write all appended entries to disk and wait until
+     * the operating system reports them to be stored.
+     * @return 'true' on success
+     */
+    bool commit();
+
+private:
+    QFile *m_file;
+    QSet<QString> m_completedFiles;
+    QStringList m_uncommitted;
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,880 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+
+#include "languageidentifier.h"
+
+#include <cmath>
+
+#include <QMutex>
+
+const int TextSource::windowLength = 1024;
+const int PlainTextSource::partLength = 4096;
+const int LanguageIdentifier::maxSampleLength = 65536;
+const int LanguageIdentifier::maxSampleWindows = 16;
+const int LanguageIdentifier::numBuckets = 4096;
+const int LanguageIdentifier::minTrigrams = 16;
+const int LanguageIdentifier::minSampleWindows = 3;
+const double LanguageIdentifier::decisiveConfidence = 0.8;
+
+namespace {
+
+/**
+ * The 400 most frequent trigrams per language as found in gettext
+ * message catalogs of a common Linux installation (English from the
+ * catalogs' untranslated messages). Each entry is a trigram with
+ * spaces written as '_', followed by its frequency per million
+ * trigrams. Trigrams are taken from lower-case text where any
+ * non-letters are replaced by single spaces; trigrams whose middle
+ * character is a space are not counted.
+ */
+struct Profile {
+    const char *language;
+    const char *trigrams;
+};
+
+const Profile profiles[] = {
+    {
+        "cs",
+        "_ne11215 ní_10394 _po9563 _př7621 _pr6242 je_5814 sou5332 _na5098 _so4980 pro4861 _se4790 oub4293 "
+        "ubo4251 bor4251 ení4216 _je3964 na_3883 _vy3827 pře3461 sta3446 ze_3392 ová3360 ný_3250 _za3244 "
+        "ván3233 né_2876 ova2846 _ch2835 ání2723 se_2710 at_2590 chy2536 hyb2512 _od2489 uje2448 ch_2433 "
+        "or_2411 it_2358 _do2308 rov2308 ce_2287 vat2287 pou2274 zna2233 uži2215 ho_2201 při2200 no_2192 "
+        "pod2173 ro_2158 neb2153 lze2127 _st2121 pří2112 ost2104 lo_2099 _v_2080 ent2067 ou_2061 nel2001 "
+        "kon1985 ru_1979 elz1964 _ná1951 stu1936 oru1910 _ko1876 _a_1828 líč1820 _ve1757 lat1730 te_1717 "
+        "res1717 ouž1699 ba_1697 nep1695 to_1674 ná_1674 _kl1671 klí1665 _vý1659 cí_1654 nač1648 "
+        "men1643 nen1639 em_1637 le_1633 kaz1626 ast1607 _ba1600 atn1577 en_1568 pla1553 ky_1544 tel1525 "
+        "_ad1508 tav1502 ku_1473 adr1456 ový1446 tup1435 dre1435 ebo1431 ých1428 ate1420 yba1417 řep1409 "
+        "_s_1407 slo1405 bo_1402 _zn1394 odp1390 pis1379 _ar1374 ny_1360 vyp1353 vol1344 _ob1340 ři_1310 "
+        "zen1306 ína1293 tu_1284 _ro1265 pín1246 epí1245 ého1239 _zá1237 byl1232 str1230 _sp1205 "
+        "prá1203 _re1202 nov1185 hod1175 ek_1174 van1174 st_1172 dno1172 bal1155 nak1146 ové1138 vý_1132 "
+        "_in1131 řen1129 _ja1125 ka_1119 če_1112 et_1103 řád1101 nam1099 ím_1091 měn1078 ter1073 "
+        "por1071 ako1069 tí_1067 _sy1067 lov1063 odn1061 oče1058 dat1058 řík1052 íka1052 sel1048 jak1043 "
+        "sti1041 _řá1041 alí1037 pov1030 ta_1024 epl1024 náz1022 ty_1022 áze1018 esá1015 ver1011 "
+        "čís1007 nas1002 mu_1000 led998 _už996 _da994 raz994 ten985 iva985 for979 sář979 ist979 lož977 "
+        "ume977 án_976 dpo970 živ964 _ce964 ace961 orm953 ově953 _pa951 zad949 ící947 az_940 nt_934 "
+        "tov934 ně_931 eno916 _sk914 ezn912 la_912 alo912 ráv908 poč906 ale899 že_891 pra891 _čí891 "
+        "_by886 áno886 ech876 oku875 _al875 íst873 nos867 řed862 ko_858 ak_856 _ho854 dov852 ti_852 not843 "
+        "kov843 lík837 ač_835 aný833 žit830 _zp830 roz826 tný824 ran824 ry_820 mén820 do_819 vyt815 "
+        "ont811 _to804 edn796 čen794 arg792 elh790 čas789 jíc787 ytv783 sah779 še_777 tra776 id_774 "
+        "ven772 _jm772 sle770 dní768 pos766 ísl766 by_761 zí_759 ci_749 hal748 _no748 ev_746 lha744 pol738 "
+        "ave738 žád738 nez734 de_734 íč_734 oro733 tní729 _te727 _zm727 _n_723 am_723 _u_723 změ718 "
+        "čet718 jmé716 nou714 ádk714 ick712 odk712 _z_710 nýc708 vé_705 ují705 íče705 _si703 ací701 "
+        "obr701 ele699 ali697 zev697 oto693 _žá691 žad690 bud690 cho686 lic686 _pl684 _ma684 ifi684 ovo680 "
+        "ače678 ího676 dán676 poz676 lik675 _mo675 rgu675 gum675 fik673 vá_671 _de671 len669 _sl669 "
+        "_bu669 eze667 lní667 pok665 ádn665 rac665 obs660 ích658 epo656 _o_656 est656 _op654 _vo654 _fo652 "
+        "bra652 jed650 nte645 ign645 ění643 ít_643 sku643 _k_641 tvo639 áln639 zná637 kte637 spo637 "
+        "tuj635 _ta634 tů_634 ec_626 yst624 tif620 výs620 ena619 nám617 ces617 jso617 _ak617 akt615 "
+        "voř613 íše613 onč611 ktu611 pin611 kód609 kát609 píš609 yl_605 ním605 ček605 ste605 "
+        "áva605 poj600 lu_598 oli598 su_598 ený596 zpr594 sto594 ané592 tor591 át_589 ede589 ods585 "
+        "sys585 ém_583 _ka581 ypí581 up_579 ram579 mís579 den577 _js577 olo576 iká576 _kt574 čte574"
+    },
+    {
+        "da",
+        "er_20392 et_10511 en_9934 kke9189 ke_7934 for7474 ikk7222 _ik6824 _fo6687 til5871 ere5798 ing5731 "
+        "nde5653 _ti5600 _de5496 il_5454 or_4902 _in4839 ter4811 de_4778 _af4631 der4516 ler4505 _er4383 "
+        "fil4132 lle3926 es_3796 _fi3781 ed_3701 ver3618 ind3578 _me3546 re_3504 ne_3494 _st3450 end3351 "
+        "ng_3276 _i_3246 _ka3210 _ud3183 _en3177 af_3131 te_3108 den3061 ent3009 sta2915 ret2912 nte2860 "
+        "_ko2858 bru2820 tte2805 ste2780 rug2778 ger2772 and2770 an_2749 _br2749 ive2732 at_2719 ang2690 "
+        "nge2625 kan2623 gen2612 ede2598 ion2577 se_2547 med2451 dig2428 ers2356 al_2342 und2319 skr2308 "
+        "tal2287 og_2272 els2243 _sk2228 om_2224 _re2205 _ve2178 lse2159 ell2159 nin2147 le_2138 det2119 "
+        "mme2111 _so2063 ejl2058 men2056 fej2052 _at2052 lin2048 _op2037 nne2029 _an2027 rin2025 ig_2008 "
+        "kri2008 lig2006 _fe1975 ker1937 yld1933 ata1882 eri1868 kun1861 _og1851 ldi1849 _un1847 tio1832 "
+        "gyl1823 del1817 _el1815 ge_1788 _ku1765 el_1756 avn1740 nav1737 gt_1735 _ad1735 on_1733 _li1710 "
+        "som1710 gle1679 ati1664 dat1662 kom1643 ile1622 tet1616 uge1612 vær1601 jl_1599 ken1584 ern1582 "
+        "rer1578 _på1576 giv1572 _ma1565 ren1561 _vi1557 ndt1553 _ug1551 all1530 _pa1523 _sy1521 ugy1519 "
+        "_pr1515 ngs1513 på_1509 dt_1498 _et1498 vis1479 riv1460 st_1450 eks1446 str1437 _fr1431 ort1416 "
+        "des1389 kal1385 ved1379 pro1370 res1362 age1337 ven1337 man1324 val1311 igt1307 vet1280 _ar1269 "
+        "var1267 _se1265 ska1265 _fl1259 is_1255 ser1255 _læ1253 ngi1253 kon1251 nøg1251 _væ1251 øgl1244 "
+        "_si1234 ett1234 _be1232 mat1221 lde1213 unn1209 len1207 ove1198 iv_1194 dre1192 _nø1190 ige1175 "
+        "_x_1169 _hv1167 _mi1162 pe_1158 nd_1150 ill1144 lag1144 vn_1141 _te1137 fra1133 jer1131 ner1131 "
+        "stø1125 sel1118 orm1118 mer1116 rt_1114 kat1114 ug_1110 _al1104 omm1091 ar_1076 nt_1072 pak1066 "
+        "sti1053 nst1053 afs1049 akk1049 _da1045 _bl1045 fin1043 ra_1041 rel1039 tan1032 ont1026 ist1026 "
+        "inj1018 nje1018 dsk1013 rst1013 egn1007 log1005 red990 ppe980 _ge972 rse965 rma963 alg959 teg955 "
+        "int953 _ha951 tre951 rne948 sym948 ske944 ndr934 hed930 lut925 amm911 sen904 rdi902 ens898 lok898 "
+        "slu896 _sa888 kti881 sse879 rsk879 sni873 _na869 ert869 dst867 ve_867 sæt867 lem865 ude860 fla854 "
+        "ble852 lt_850 ærd844 elt841 læs837 me_833 ars833 _ov833 typ831 bol827 _he825 opr825 ymb823 mbo823 "
+        "ype823 ess818 ag_816 pre812 mma810 dva808 uds804 nta802 gn_799 ign797 tem789 ode778 _om778 _gr778 "
+        "ten776 _ek776 ons774 tat768 ide766 let764 rte760 eli757 sam757 _nu755 ndo755 old753 adv749 ore747 "
+        "tid745 ram745 ekt745 get741 cer741 _uk739 læn732 it_730 sio730 one728 ift726 lad722 rsi722 hol722 "
+        "_la720 uke720 ark720 gra718 æng716 vne716 _kr716 tor716 por711 met711 nda705 ard705 ta_703 _ta695 "
+        "tiv692 id_690 ér_690 fte686 sk_682 ære682 reg682 før680 em_678 eme676 har674 gan671 tek669 est669 "
+        "isk669 nke669 gru667 alo665 dar657 _bi653 rre653 _lo653 _di648 ænd648 ils648 ns_648 ins648 hvi644 "
+        "fik642 _du642 enn642 ate636 rki636 _sl636 ndl634 _fø632 tes630 min627 ifi625 arg623 kræ621 nds621 "
+        "_n_619 _va617 erv611 nfo609 sko606 fje606 omp606 _fj604 ked604 rd_602 kod600 æve600 esk600 tør600 "
+        "ræv598 mel596 gst592 _fu590 ted585"
+    },
+    {
+        "de",
+        "en_27168 er_11773 ich10049 ein7296 _de7091 der6597 cht6210 sch6057 den5902 ung5710 ht_5531 _be5400 "
+        "te_5229 _ni5149 _au5121 nic5112 ie_5077 nde4956 ver4932 _un4838 es_4785 che4719 _da4684 _di4544 "
+        "in_4399 _ei4260 die4222 gen4169 ben4042 on_3900 nte3876 ier3873 _ve3850 ert3844 _we3840 ist3765 "
+        "ate3763 _in3753 ten3708 rde3706 dat3665 zei3653 ter3418 _an3375 ine3371 _vo3358 it_3320 rt_3314 "
+        "wer3250 _ge3223 ng_3192 ere3179 ers3155 _si3139 end3139 ch_3134 st_3124 nge3082 _zu3081 tei3072 "
+        "eic2971 ion2968 ren2921 _er2909 nen2902 ehl2874 feh2862 ige2781 ste2781 ent2774 aus2713 _ko2628 "
+        "_fe2603 _is2571 ne_2527 sse2514 hen2473 erd2473 nd_2457 _fü2443 eit2423 tio2371 chl2349 sie2296 "
+        "mit2285 für2275 ür_2275 ei_2235 auf2222 ann2220 bei2213 ber2193 le_2181 und2151 von2141 _re2122 "
+        "tig2122 _wi2096 nn_2055 et_2043 _pa2002 des1994 kan1993 men1988 ebe1982 _ke1975 kei1970 hle1966 "
+        "ges1959 ese1947 nnt1927 ell1927 _sc1913 rei1898 sta1890 len1890 geb1888 ge_1862 rte1853 abe1848 "
+        "ang1845 _mi1840 ern1822 de_1817 im_1811 sen1795 kon1793 _ze1740 ler1709 lti1689 _st1678 wen1664 "
+        "lle1653 erw1651 sel1610 erz1594 hre1593 ült1593 gül1592 and1580 _se1574 rd_1544 _en1543 _ka1532 "
+        "run1530 _al1484 rze1470 ame1445 ode1442 wir1440 uf_1431 üss1428 her1421 zu_1410 lte1388 em_1374 "
+        "das1352 _op1318 _pr1317 tze1317 ind1316 as_1312 ird1310 lüs1290 hlü1283 eru1273 for1271 nam1270 "
+        "ati1268 chn1265 ege1257 ls_1255 ngü1248 um_1225 eim1225 _ab1224 nt_1222 _od1222 _na1213 usg1213 "
+        "lis1211 pti1210 el_1204 _ar1195 rst1192 ies1182 esc1172 lic1170 tel1168 gab1168 war1166 chr1153 "
+        "ite1152 _le1151 unt1148 ger1142 eil1141 onn1139 opt1137 tzt1134 _co1133 all1131 vor1126 rwe1113 "
+        "ket1105 ach1104 re_1100 lt_1089 he_1082 nut1079 ass1075 utz1074 me_1073 nis1073 enn1065 _gi1064 "
+        "se_1062 ile1061 _nu1040 one1036 age1027 ort1026 _me1026 als1025 us_1022 ur_1022 alt1020 übe1019 "
+        "akt1017 etz1009 ner1008 hni988 enu987 omm986 fer985 _üb982 tet979 art971 set969 ing965 zen962 "
+        "hl_956 pro951 is_951 _um936 git932 hal932 lge917 geg916 eig911 gt_910 tie906 be_903 spe890 isc885 "
+        "_bi884 mme883 ign881 anz877 ien876 nst876 änd875 _ak874 _ha870 ens869 at_868 gef865 ete864 efe862 "
+        "tte861 its859 wei855 orm853 _im848 mer841 ene839 zt_838 rie832 _so830 mat825 wur823 _wu822 uch818 "
+        "fun815 lie809 ser807 tes801 nze799 al_795 ess795 les794 rsc791 kom790 int788 urd785 ins783 gel781 "
+        "_fo781 ekt778 ake777 rma772 ngs764 sge753 erf748 erh747 rch736 ts_730 zer729 pak728 _wa725 det714 "
+        "_gr702 rbe700 est699 _sy699 erl695 ali690 ss_686 ahl679 nac678 nne671 _ne671 ig_670 ll_670 fen669 "
+        "_sp666 eib665 err663 ühr661 itt661 era661 eie659 lau658 füh657 sig655 ktu652 tat650 sti648 rha645 "
+        "ume643 erg642 lag642 com640 dar638 _es636 _ex632 or_628 ede626 an_624 kti624 zah624 oll624 _ma622 "
+        "_no620 isi616 chi616 rn_615 ele613 _hi613 _li608 neu607 arg607 eld606 res602 rne601 zie596 tan596 "
+        "rge594 mmi590 dem589 sio589 ran588 nur588 sin586 nun584 rti580 hla576 ori575 sei571 rsi571 kt_571 "
+        "ord569 arb564 pas562 erk562 lei561 ütz561 ech560 uel560 wor558 ale552 wie551 tra550 nbe548 stü543 "
+        "ück541 atu539 tiv538 bef537 onf536"
+    },
+    {
+        "en",
+        "ed_10046 _th8257 _in7907 ing7885 ng_7823 _re7464 the6959 le_6648 _co6558 _to6538 or_6414 on_6181 "
+        "ile6172 he_6071 ion6065 to_5980 _no5927 es_5663 not5501 er_5386 ot_5315 _fi5036 tio4754 is_4472 "
+        "_fo4393 for4324 fil4248 nd_3770 ent3704 te_3522 in_3466 _is3446 _pa3430 ect3416 _of3399 of_3242 "
+        "ate3199 _se3163 and3144 nt_3091 re_3076 se_3069 _a_3058 ter3042 _pr3030 _an2958 _us2915 it_2873 "
+        "ati2801 _ca2790 _un2757 ted2741 ge_2711 val2669 _de2657 rea2652 me_2647 _di2630 con2620 _ex2591 "
+        "ame2586 _st2584 st_2548 ry_2457 use2455 id_2438 _li2428 com2428 th_2403 _op2316 al_2314 ut_2302 "
+        "_be2244 ble2240 _wi2195 _ch2187 _ma2178 nam2175 ess2139 ali2129 _ar2124 ver2085 tin2077 rec2072 "
+        "res2047 age2025 en_2001 ail1986 err1977 can1972 ith1960 sta1956 ead1910 abl1900 et_1898 all1895 "
+        "_on1884 tor1877 lin1848 wit1838 ve_1822 ly_1817 as_1807 ist1806 _or1804 ts_1803 ire1780 ack1773 "
+        "an_1767 _su1766 at_1766 ch_1741 led1736 lid1735 _do1696 int1685 ce_1679 _al1676 _er1665 _ke1664 "
+        "rro1651 _fa1649 ne_1646 ror1641 ld_1632 cat1632 cha1625 ns_1625 _na1618 pec1610 key1603 pti1603 "
+        "ad_1588 ll_1584 rin1562 omm1561 out1535 ers1524 _me1518 mat1512 _lo1512 ine1508 _en1495 _si1491 "
+        "pro1491 opt1490 _gi1482 dat1471 nte1445 be_1441 fai1437 ory1437 inv1435 _wh1426 ive1422 ons1421 "
+        "_va1418 ann1412 ser1408 ste1408 men1399 nva1381 no_1370 dir1368 pac1363 han1361 ort1332 ign1329 "
+        "nno1329 _sp1323 sio1323 thi1300 pre1292 ica1291 _sh1285 ont1272 che1267 de_1263 _mo1258 _ha1251 "
+        "cte1248 ifi1233 nge1229 set1227 his1224 red1222 _tr1212 str1211 orm1205 ang1200 ins1196 cti1185 "
+        "ey_1178 les1176 ss_1175 are1172 _fr1171 om_1171 _wa1168 sin1167 _by1163 exp1150 ct_1150 put1146 "
+        "rom1145 emo1144 _as1141 _ne1137 _so1135 ase1131 por1127 ran1124 ssi1120 spe1113 rit1106 git1091 "
+        "eci1084 you1079 rt_1079 _yo1075 rem1068 _ou1048 _cr1047 cou1039 arg1039 man1037 fie1034 fro1032 "
+        "cre1028 tch1026 oul1021 uld1021 ove1016 ume1016 ow_1012 loc1007 _nu1007 act1006 par1006 ren1005 "
+        "rs_1003 cto1001 ces998 pat998 pri997 rd_996 ure992 _sy987 _da981 lic978 ult972 tri963 ore963 wor960 "
+        "rma956 ope953 ass945 ber945 din943 sig941 end941 num927 tur918 ck_916 mit914 eat905 equ904 nst902 "
+        "oun900 _ba896 per895 mod894 rac890 _ad884 nal882 mbe881 rat881 low881 one878 enc878 mes877 ere876 "
+        "ue_865 _bu864 whi863 our862 ord862 ite860 cif860 _ta856 llo855 ode851 own850 _ve847 est846 _up842 "
+        "alu841 ple841 lis841 ain840 ind838 mma837 nin831 ty_828 sup827 upp823 ay_823 rsi819 by_815 chi814 "
+        "ara813 lue811 tes810 her810 _mu805 iti802 sho802 _he802 pe_800 omp797 add795 unk791 ele788 rep787 "
+        "_at784 cka782 tat780 kag780 ref780 pen780 tem778 har777 _mi774 req771 exi769 atu768 nab768 ou_768 "
+        "dis766 ach765 tra764 nat764 onf761 ds_757 atc757 umb755 ata755 nde747 mov746 war743 _it738 ust737 "
+        "ize730 nta729 hen728 up_725 ied721 ern721 def717 tab712 wri711 ori708 nti707 _ap706 ext704 tre702 "
+        "sed699 hil698 rge698 qui697 ntr697 una697 sag697 nly697 eco695 und695 era690 lea689 onl686 ic_683 "
+        "arc680 ote679 _po676 ppo675 ide674 inc672 ges672 _ge672 ert672 _t_671 _wr671 typ670 nce670 ype668 "
+        "app667 utp665 tpu665 em_662 tha662 if_661"
+    },
+    {
+        "es",
+        "_de21634 de_16746 do_9222 _no9078 _se8660 el_8496 _co8301 no_8067 os_7685 ón_7166 es_7117 ión7047 "
+        "_el6999 _es6947 _en6552 _la6433 se_6140 ar_6023 ent5929 _re5886 la_5853 con5810 ció5592 en_5331 "
+        "ra_5274 ado5238 _in4892 _pa4528 or_4347 _un4278 te_4217 to_4090 est3992 da_3960 par3946 nte3942 "
+        "as_3937 ro_3868 al_3789 fic3510 ara3441 tra3289 ica3284 ero3256 aci3210 ta_2994 com2956 _pu2942 "
+        "que2894 ido2768 _fi2746 des2738 str2667 sta2649 er_2591 era2585 un_2578 ada2574 _ca2558 ion2556 "
+        "per2516 _pr2484 men2453 rec2442 cio2430 na_2403 _di2402 _lo2384 cci2379 ede2375 _si2350 lid2296 "
+        "ida2292 ist2292 _al2282 on_2248 _ar2221 res2216 ien2199 che2177 ntr2176 ndo2169 pue2127 esp2115 "
+        "re_2107 ued2104 nto2095 lo_2069 and2048 _op2040 por2037 ect2032 del2024 los2019 her1949 nes1943 "
+        "rad1930 ivo1925 one1905 ich1903 _a_1897 esc1871 _po1854 ont1832 cad1802 arc1787 io_1767 _qu1748 "
+        "ue_1748 ter1748 den1724 ecc1723 enc1721 rio1721 ali1708 car1699 ten1684 bre1674 ble1646 err1626 "
+        "ene1624 pro1601 mit1596 una1586 vo_1576 dos1544 _ex1544 tro1541 spe1538 áli1516 dir1505 vál1505 "
+        "_so1500 omb1498 _us1486 mbr1486 _ha1485 rch1485 _fa1475 nci1461 ma_1453 ifi1441 tos1438 rma1436 "
+        "nom1421 ori1393 _er1385 chi1336 _ti1332 ina1331 _va1330 hiv1321 ura1309 _y_1304 pre1300 sió1299 "
+        "sec1293 ire1288 reg1284 le_1283 ran1282 tor1273 ver1267 it_1259 rro1254 cto1254 po_1253 ir_1243 "
+        "cia1241 las1231 ste1231 pci1231 act1228 fal1225 ror1224 all1217 iza1197 omp1195 tar1189 ce_1180 "
+        "cac1175 _mo1170 tad1169 _ma1163 opc1155 stá1148 rar1143 for1141 liz1118 _ta1118 rea1116 _o_1112 "
+        "ato1108 tes1105 olo1101 _su1096 tiv1092 orm1089 so_1087 _ac1083 ama1083 abl1076 mo_1075 int1063 "
+        "_fu1063 _ob1063 ant1059 ia_1059 ser1049 inv1046 ite1045 cer1035 lic1034 ere1034 qui1034 _ve1031 "
+        "ona1028 dor1021 _pe1016 cid1006 nst1006 ari1000 ins976 _me975 ca_970 in_963 egi956 ea_954 val944 "
+        "mie942 eci937 arg929 ctu926 nta918 ece914 nvá909 _lí907 tie905 bol902 les902 _li900 ici895 git895 "
+        "nal890 ual885 eta882 nea880 cla879 tá_873 ces867 usa867 ndi865 emp863 mer862 ne_859 ete857 mpo850 "
+        "sin850 pos848 rac842 nco841 min835 rta835 end833 inc827 _sa826 ema826 _tr814 ave809 ope808 uet807 "
+        "_x_806 ers806 _ad806 nti805 cri804 scr803 ono802 ini801 lec801 gis799 ve_798 ort797 _cl795 ecu795 "
+        "erm795 alo795 amb794 tip794 cam790 tab788 _cr784 lor782 ros782 ace781 deb779 pec776 noc771 rmi771 "
+        "cre770 iva769 _gi767 fin767 lav765 _le763 _ra761 go_751 dad750 ubi748 ner744 _te742 ras742 ami741 "
+        "def739 sal738 mbo738 sol736 odo736 bic734 mbi732 tru732 ume730 tam729 _bi721 til719 oci716 mpl716 "
+        "_sí714 _fo714 jet711 esi710 igu710 mod710 ibl708 ili704 das703 onf701 uta687 cti683 ram682 sím681 "
+        "ímb681 sco680 oca678 ase677 aba677 cif675 orr672 obj671 tua670 ple667 rsi667 ad_666 bje665 íne662 "
+        "dic661 ipo660 omo660 an_659 lín659 aqu657 dat656 _da649 udo648 _au645 _nú644 ren643 gen643 reu639 "
+        "ref635 sca634 equ633 jo_633 ext632 tan627 cor627 nar627 _an626 tal625 mas623 va_621 eto620 rib619 "
+        "_im619 ebe617 ier617 pud615 paq615 dis614 _to613 eub613 osi611 imi607 rab607 núm607 ord607 ita602 "
+        "_cu602 efe600 _mu600"
+    },
+    {
+        "fi",
+        "en_11505 ist8525 on_7207 ta_6634 _ei6440 ei_6269 ett5562 nen5393 _va5249 ine5230 ell5192 in_5109 "
+        "sto4795 le_4553 ost4553 _kä4415 oit4305 _ko4254 _vi4181 tet4162 lli4133 tie4073 lin3943 sta3918 "
+        "äyt3797 _tu3721 vir3680 sa_3642 an_3605 ssa3513 edo3512 rhe3508 irh3490 _ol3483 ied3458 dos3421 "
+        "tä_3343 tta3329 _ti3304 ole3302 _on3251 itt3220 käy3203 ttu3161 lle3101 ste3088 _si3078 _ta3021 "
+        "een2942 eel2907 ton2867 taa2812 tu_2804 ite2756 tee2641 itu2624 tus2593 lit2499 us_2393 _li2388 "
+        "ja_2376 nni2361 tel2345 aa_2334 ttä2332 ali2292 ise2292 hee2269 nis2261 ent2225 tun2121 tte2108 "
+        "aan2098 to_2098 mat2062 _lu2048 mis2039 men2014 _sy2008 stu1987 rit1973 _ar1958 tti1956 ava1952 "
+        "la_1948 lla1947 ess1929 lis1925 ksi1925 val1918 sti1910 ytt1908 ia_1904 _lo1891 koh1883 hte1837 "
+        "all1835 _mu1810 mer1793 tää1793 ime1784 et_1770 ato1766 mää1739 _pa1738 _x_1726 äär1716 "
+        "kis1713 _sa1711 än_1707 voi1701 set1686 nim1672 _la1653 sen1649 _vo1630 utt1622 si_1619 ää_1619 "
+        "its1617 ään1605 sym1603 enn1603 joi1596 imi1592 ain1586 isä1559 oli1534 tav1530 vai1525 oso1525 "
+        "eta1521 soi1496 _re1482 tai1482 eri1479 tsi1458 bol1448 ymb1444 mbo1444 tii1442 min1433 ois1429 "
+        "_ja1429 luk1408 kki1408 _su1402 ita1385 _po1379 oht1379 _as1371 ivi1371 onn1369 lä_1346 ill1323 "
+        "nte1321 est1321 käs1318 tam1316 ote1308 iin1306 uut1302 _ka1295 ter1295 ake1285 loh1285 ohk1285 "
+        "hko1285 _tä1281 _ku1279 _jo1279 tul1279 sis1275 var1275 eki1272 epä1268 ema1268 aus1266 _ep1264 "
+        "sä_1256 _se1243 ti_1237 erk1235 uku1231 oll1225 etu1225 ssä1210 kir1204 irj1197 ai_1195 per1195 "
+        "ume1187 tui1181 _ha1181 arv1179 ui_1174 he_1168 oi_1160 ytä1156 te_1153 ees1149 nne1145 aik1141 "
+        "ama1139 dot1135 rek1130 stä1128 ty_1122 va_1122 int1120 _ni1112 nta1105 ase1105 äri1101 kse1099 "
+        "lue1085 ust1076 sii1076 uet1074 ata1070 unt1068 odo1066 att1062 rkk1062 ope1061 ark1059 _al1057 "
+        "ais1057 rvo1057 _ki1055 ami1055 _me1053 uot1053 ran1051 ri_1051 päo1047 äon1047 ses1045 vaa1041 "
+        "sek1034 ulo1034 _jä1032 _pi1030 tty1024 elm1018 at_1015 koo1009 era1009 _ri999 sin997 sim995 _op993 "
+        "it_980 uks974 sky974 vat968 los968 äsk968 rki967 _to967 mi_963 kem959 ot_959 ko_957 oa_957 net957 "
+        "_en955 ori955 iss947 llä944 tyy938 ros938 lii934 ijo934 ast926 na_926 oko915 poi911 _ty911 suo907 "
+        "isi905 _mä899 iä_890 alu884 ota880 kai873 tem865 _oh865 unn859 _od859 _vä853 sij853 and846 "
+        "täm844 iir842 nti838 ude834 kok834 ien832 itä828 del825 uva825 ver821 ika819 rjo819 lau817 toi815 "
+        "_pu815 aat813 _yh813 _av811 use811 jen809 un_807 uor802 tuu798 ity798 _ve796 ood794 emi794 eks794 "
+        "tue794 _os790 sit788 ulk788 ut_782 _ke781 roi779 ndi779 li_777 ttö777 tio775 oon769 tuk767 kit765 "
+        "see763 til761 kom759 omi759 ala758 ink758 ass754 ero754 sal748 _n_742 hde742 yte742 ämä742 den740 "
+        "ikk736 odi733 yyp733 iit729 ian727 riv723 _nä723 _ot719 _ma717 aut713 kan712 oss710 ohj710 tar708 "
+        "tin706 muu706 ypp702 met700 sia700 kon698 num698 ome696 ärä687 uud683 ott681 aro679 hak677 uri677 "
+        "pi_677 tau675 eis673 lma673 aks669 dat669 ppu665 säl660 _pr658 ppi656 pro654 _mi654 ka_654 ulu654 "
+        "_yl654 las652 toj650 muo650 jäl648 tys646 ila642 _uu642 vo_642"
+    },
+    {
+        "fr",
+        "_de17044 de_16498 es_12547 le_11065 er_9661 ion9649 on_9378 _le9121 tio7614 re_7106 ur_6962 _co6606 "
+        "ent6500 _pa6232 nt_6181 _la5505 _in5476 ne_5336 la_5144 ns_4776 les4759 fic4724 _un4502 _d_4064 "
+        "our4039 eur3890 ich3860 _no3845 _l_3818 ier3716 te_3701 _en3662 que3660 ble3636 ati3625 chi3617 "
+        "_re3611 _po3608 _fi3479 pas3435 men3374 _dé3348 con3338 as_3272 est3261 _es3198 lis3103 st_3081 "
+        "cti3038 res3035 tre3000 hie2910 des2862 ect2850 che2828 pou2802 un_2788 ue_2682 ssi2659 et_2656 "
+        "ans2642 dan2639 _li2619 _ré2581 _su2561 du_2532 com2529 _se2515 ire2504 ge_2472 ibl2457 rs_2440 "
+        "uti2419 _à_2415 _pr2400 en_2397 _da2396 ant2382 _im2358 par2319 ess2295 onn2282 pos2280 _du2277 "
+        "age2271 ts_2252 ée_2244 ons2187 til2172 ili2159 eme2158 it_2148 _au2147 val2146 mpo2127 _n_2119 "
+        "nte2104 _ut2085 imp2059 _ch2057 ign2052 _so2031 ist1995 ver1983 se_1975 rre1968 ont1956 une1950 "
+        "ter1932 _op1903 sib1888 _ne1872 ali1857 nom1857 cha1849 ten1848 _ma1848 iqu1834 ise1830 oss1827 "
+        "ce_1812 ers1799 sio1773 ec_1772 _ex1746 omm1741 str1722 _av1717 ut_1693 ide1688 nde1663 me_1662 "
+        "ifi1650 us_1640 and1638 lle1627 ser1626 _tr1579 _mo1543 _va1531 ert1517 _ou1507 ar_1505 tte1493 "
+        "ort1491 non1486 _ar1485 ave1468 err1466 _pe1449 ure1397 _sy1385 _et1369 aut1369 _a_1352 rée1347 "
+        "_qu1339 is_1339 _do1335 _éc1332 rti1330 act1306 _er1291 _si1285 _lo1274 _ce1274 sse1271 ntr1270 "
+        "ran1261 _ve1256 inc1246 sec1237 nco1233 _fo1230 té_1222 ale1220 pti1218 nti1204 cor1198 per1196 "
+        "ou_1193 man1186 ive1183 cat1182 pro1176 rec1176 sta1169 ées1156 vec1156 end1153 opt1146 déf1140 "
+        "ite1137 ir_1132 ins1131 reu1126 tur1118 sup1111 _di1111 for1104 att1102 ie_1095 ffi1095 nce1091 "
+        "_ca1086 omp1086 isa1078 ill1076 ode1075 int1071 ez_1069 abl1069 ouv1068 ica1063 om_1060 arg1048 "
+        "lid1046 _ta1043 ren1042 êtr1024 at_1023 anc1018 oir1017 _êt1014 fin1009 orm1007 upp1006 dre998 "
+        "_af997 por989 aff985 ind983 nst980 teu979 ini976 tif974 her973 mat967 au_965 pre960 ssa956 tie955 "
+        "_at954 orr949 ous941 air940 lig937 ate934 éch927 _pl925 gne925 tro923 al_911 rou911 _ét911 pe_907 "
+        "pri898 mme898 ces894 és_892 ére891 mod886 sym883 tai882 leu874 _ap870 tan867 enc866 tra865 nne865 "
+        "reg856 peu854 rma851 ien847 mbo846 _st840 sat838 bol836 ymb835 ara833 son832 rép823 he_820 egi818 "
+        "inv814 rer813 gis812 aqu808 ett806 sur803 tes802 adr799 _ac799 _te792 cte790 uet789 épe787 ors783 "
+        "in_779 tiv779 pér775 sag774 rai773 ail773 min771 ste767 iti766 éfi766 ère766 nnu763 urs760 cod757 "
+        "_bi757 ole751 _ob745 ve_745 sou745 ais743 uve742 née742 _cl741 ass739 ctu736 ux_735 nu_730 don730 "
+        "nts727 ell724 nva722 éra721 tré718 eut718 rch716 pré715 éci714 ule708 tat706 tru705 uct698 "
+        "erm697 app694 nné691 _vo685 ets682 toi682 isé680 _sa679 cal679 _gi679 tou679 el_677 bre676 rem675 "
+        "qui675 out675 éri674 _gr670 rsi670 cri669 ace668 dif661 typ661 _cr661 rto660 rat659 ype654 _al654 "
+        "_sp653 jou650 nda648 mma646 sig646 ruc646 ina642 _to637 _b_637 _ty634 san632 loc628 lie627 nat625 "
+        "arc625 paq619 ine619 plu616 lus615 git610 emp609 si_609 ndu607 _s_604 mpl604 ute598 hec595 _vi595 "
+        "rac595 ait594 car592 ond592 oit591"
+    },
+    {
+        "hu",
+        "_a_15233 _ne5669 em_5323 _me5156 az_5100 _az5022 en_4956 ele4869 nem4832 _sz4394 fáj4363 ájl4360 "
+        "_ki4334 tel4188 ása4073 meg4066 és_3906 tt_3893 _fá3835 len3820 sa_3799 gy_3701 cso3701 tás3580 "
+        "_el3332 _ha3298 _le3142 et_3028 _ka3015 egy3013 ara2933 _be2926 asz2911 nál2894 _ér2840 ek_2729 "
+        "ok_2670 _va2629 tés2624 men2595 _hi2585 _eg2570 has2468 _kö2446 ncs2420 agy2376 sze2359 _cs2352 "
+        "ak_2322 ás_2310 szn2308 ssz2269 ény2264 hat2262 es_2232 jl_2230 an_2206 zná2174 ése2167 "
+        "ítá2104 fel2084 _fe2065 lt_2062 ett2052 sít2045 ért2023 sol2009 lít1955 se_1950 kap1916 tal1899 "
+        "at_1892 rás1892 áll1865 cs_1865 ter1860 tó_1858 vén1853 apc1836 pcs1836 _mi1834 hoz1826 ott1775 "
+        "_pa1761 _ta1758 ató1744 jel1736 for1724 _al1717 ene1712 _fo1710 tum1700 hib1693 ker1683 or_1680 "
+        "_és1678 ent1671 _ke1659 al_1654 het1651 érv1639 vag1634 rvé1629 ran1629 oló1629 ja_1627 _z_1627 "
+        "zés1624 tár1612 ere1595 sza1590 par1590 kez1583 szá1581 _ad1561 _re1554 min1547 eze1542 kor1534 "
+        "net1513 ált1500 nt_1474 íté1459 ála1459 lha1457 zet1457 llí1454 lat1452 akt1442 ba_1440 anc1440 "
+        "zám1430 rak1427 mez1427 zás1413 si_1410 sor1401 rte1396 nyt1374 yte1372 írá1362 ely1357 elm1355 "
+        "iba1350 gye1347 ező1345 el_1338 kar1335 va_1330 lás1330 ló_1325 nak1311 int1306 _ar1306 re_1289 "
+        "ni_1289 lme1284 alá1269 ány1265 eg_1257 let1257 ség1248 szt1248 vál1243 lis1233 _so1221 _ho1218 "
+        "zer1206 lye1201 ra_1199 hel1189 is_1182 _vá1179 tar1177 er_1175 rt_1172 név1172 _te1155 end1145 "
+        "nyv1145 ren1143 kte1143 kön1138 ala1133 os_1131 _tö1126 um_1126 ato1124 ez_1121 öny1121 _he1119 "
+        "ik_1119 _si1119 ind1114 sik1102 art1099 _ni1097 tet1092 orm1092 nek1080 yvt1080 vtá1080 oz_1065 "
+        "sak1063 eál1060 inc1048 nin1046 öve1043 rmá1038 rté1036 ti_1036 ete1031 ezé1029 tot1019 _je1017 "
+        "ike1017 dat1014 sok1014 les1009 csa1009 oma1007 ban997 iss992 ár_992 ell987 esz987 mag985 ha_985 "
+        "ték982 ega982 gad980 ége978 _li965 _lé965 us_961 _né961 ta_958 év_956 _ké953 ont948 atá948 "
+        "ntu948 beá946 ada939 alm936 vet936 ozá934 elő931 öss929 on_922 ume922 _pr919 szi912 ve_910 "
+        "nde910 rül905 áso902 som902 _ál895 tre888 ző_888 elt885 ül_878 lap875 ehe875 _vi873 ára866 "
+        "nye866 _ut858 eti851 lva849 elh846 ész846 leh846 erü844 lok844 _ös844 áló839 val837 ver837 "
+        "lét834 át_829 eme827 arg827 _in824 ben817 ot_810 lma810 pro803 _is803 ime798 nev798 lle795 eje793 "
+        "res793 ret790 ók_785 ort783 lcs783 köv783 yel781 ásá781 kií778 iír778 maz776 rta776 st_771 "
+        "fej771 _bi764 ető764 olv761 ert761 olá756 ási754 _ez754 tke751 tat749 _fi749 els747 eté747 "
+        "ges747 lép737 tő_737 osí737 rés734 yez732 _tá732 ció730 _ku727 ite720 _ol720 vas717 ulc713 "
+        "vis708 ési705 kul705 lto700 köz700 kat698 eve698 elé693 fig693 ist691 nos688 toz686 por681 ll_681 "
+        "_id678 lem678 dsz678 leg671 _új666 lés664 rek664 _ko661 _má659 kel657 reh657 nds657 ult654 lta652 "
+        "_ír647 mód644 ámo644 bb_642 tle640 zó_640 vég640 nyo640 igy637 _vé637 szo635 hez635 zik635 "
+        "_ve632 mer630 etl630 ata630 etk630 tok627 ket627 _de623 oly623 szü620 éte620 átu620 van618 "
+        "álh615 sz_613 _es613 rgu610 gum610 ól_610 ána608 egh608 esí606 kim606 las603 kén603 _ma601"
+    },
+    {
+        "it",
+        "to_11372 _di10141 le_10082 re_9921 _co9191 ion8695 _no8488 on_8116 di_8077 ne_7970 _de7320 zio6944 "
+        "ile6862 one6753 non6744 _in6548 ent6283 ta_5494 _ri5346 la_5111 con5055 ato4937 il_4820 del4819 "
+        "_il4771 nte4649 te_4628 _fi4569 ti_4518 per4322 pos4310 sta4225 ell4149 _un4071 are3975 er_3843 "
+        "fil3706 mpo3696 bil3670 _pe3653 men3652 ssi3640 _im3639 _es3539 azi3457 ess3372 ica3356 imp3350 "
+        "un_3279 _la3170 _se3159 _è_3125 ibi3051 com3019 el_2975 ali2958 chi2867 _st2859 _pr2815 oss2799 "
+        "_ne2796 lla2712 est2709 ett2690 lo_2680 _re2665 _da2618 sib2552 _so2531 _al2480 ere2477 _l_2474 "
+        "ore2427 tat2409 so_2346 ll_2345 che2311 in_2290 ome2282 fic2274 do_2266 nti2248 ati2239 val2232 "
+        "me_2223 ifi2219 no_2198 _ch2192 ver2190 ten2180 all2172 _va2155 ter2097 ni_2075 _le2018 _pa2015 "
+        "oni2007 it_2005 _su1989 ro_1980 ata1971 tto1960 _si1944 att1939 ra_1938 li_1922 err1887 sci1886 "
+        "nto1875 io_1851 na_1845 seg1831 ire1828 ura1806 _i_1799 ita1798 tor1778 cor1765 ina1763 nel1738 "
+        "cat1718 _sc1710 tte1710 sio1705 ono1691 pre1681 tro1662 ont1659 ma_1650 _er1643 ost1636 _mo1632 "
+        "_op1624 ese1613 _tr1600 _ca1588 izz1588 and1582 rat1568 da_1566 ric1565 _us1558 rma1530 he_1523 "
+        "ito1518 zza1518 ame1515 nom1513 _a_1503 _qu1500 ggi1496 ve_1468 rro1464 eri1460 str1456 _ma1454 "
+        "rim1452 for1450 ndi1441 car1434 po_1428 mod1421 ran1421 pro1407 ca_1403 ist1397 _me1386 se_1386 "
+        "lid1367 tra1362 int1350 za_1349 agg1342 _gi1329 ser1329 _ar1324 acc1322 ror1322 por1315 _e_1315 "
+        "egu1298 dir1280 _sp1274 tti1271 cit1251 man1250 ri_1247 rec1243 _po1235 hia1231 una1226 _ve1226 "
+        "llo1221 ce_1212 usc1208 _nu1192 uto1185 ndo1185 que1178 _el1174 tes1170 enz1161 liz1158 rea1154 "
+        "ero1151 usa1142 ale1134 ia_1128 ius1127 opz1119 ste1110 ort1108 ich1107 pzi1107 ei_1104 res1102 "
+        "ari1099 iav1095 sto1093 ime1081 min1081 mer1078 _o_1069 ori1068 ris1064 git1059 ini1051 anc1051 "
+        "_at1047 ry_1045 sa_1044 spe1043 ppo1042 gge1040 _vi1038 ind1036 si_1035 ass1028 sse1027 orm1023 "
+        "ili1015 era1013 sso1011 ave1001 riu992 _fo991 lle983 ice980 _cr977 olo977 dei967 gui964 eci962 "
+        "cri960 pri954 ele951 dal951 ora950 ory943 spo938 ume936 lit932 gio932 mit930 rit929 ene924 _ap922 "
+        "odi920 dif915 _lo911 pac909 gli908 rsi904 rta903 co_902 cif900 _ut898 ues894 rig891 ers888 ect887 "
+        "loc886 sti883 ut_882 cch879 _pu878 vis875 pec870 ant869 scr869 ual868 al_866 son865 mat862 _te861 "
+        "ivi854 nat854 omp854 ido849 fin849 _ag847 lic841 dat840 sol834 ine831 ezi822 upp819 ede809 orr799 "
+        "tur799 nes798 ors797 cre796 ga_794 oma790 tri789 nde786 tiv781 de_780 izi780 sen779 isp775 nit773 "
+        "dic767 ott764 omm763 ssa756 pon756 nal754 sim754 _li751 put747 ara746 orn743 ge_742 nta742 ces737 "
+        "mmi734 oll733 fer730 ch_730 ond726 ova725 ute725 den721 col721 iut720 ttu716 _og713 sco712 num712 "
+        "cto711 het711 ntr709 _pi705 tar705 rif697 oca696 sis695 lor693 par693 _du693 ien692 uov684 raz684 "
+        "leg683 dis680 _ha679 erc676 onf676 itt675 ssu674 _au674 hie673 ico667 _an667 ate663 uti663 nzi663 "
+        "nza662 tà_657 get654 abi650 arc649 taz646 rov645 sup641 vo_640 ior637 tem636 efi636 ing631 alo629 "
+        "app627 _do624 ert622 arg619 tal618 rch616 gra615"
+    },
+    {
+        "nb",
+        "er_22791 kke10139 en_8693 et_8397 ke_7941 ikk7208 for6946 il_6898 _ik6535 ing6408 te_6117 _fo5926 "
+        "_er5452 til4875 or_4848 _ti4832 ter4827 ler4774 _av4719 fil4141 _en4131 _in4120 _fi4083 re_4030 "
+        "_me3988 ng_3985 _st3890 lle3879 bru3760 ver3736 _de3710 ruk3675 av_3662 ent3657 _br3633 _ut3532 "
+        "tte3469 ed_3432 rte3421 ig_3413 _i_3411 om_3379 de_3342 _va3313 es_3307 alg3254 _ko3217 val3193 "
+        "_sk3148 ste3130 ere3125 _ve3103 ett3053 _å_3045 opp3008 all2878 ell2794 dig2791 _so2767 nde2706 "
+        "ert2693 sta2690 _op2653 end2653 inn2640 and2637 art2627 nne2592 tt_2587 nge2553 ker2505 ne_2486 "
+        "som2455 der2447 og_2439 ldi2433 med2423 _og2407 nte2394 _kl2391 rt_2388 skr2380 lar2378 kla2373 "
+        "_på2261 _si2230 eil2227 fei2219 lin2187 på_2179 men2153 ll_2113 vis2113 yld2110 gyl2102 _fe2100 "
+        "rer2092 det2071 den2065 _el2050 avn2036 kri2018 tal2012 _et2012 nav2012 uke2004 _ma1991 rin1959 "
+        "nt_1946 dat1946 ser1944 gen1938 el_1936 _se1933 kel1933 is_1933 mme1930 _le1896 _li1893 sjo1856 "
+        "jon1840 nøk1830 se_1819 _ug1803 ppe1798 ugy1790 tet1777 var1758 _pa1737 ge_1716 le_1711 ata1697 "
+        "an_1695 _ka1681 vn_1679 _hv1679 _nø1673 len1671 man1663 riv1663 kom1655 _re1644 ger1636 _vi1628 "
+        "økk1621 kan1589 _la1576 _pr1568 _du1541 dre1507 utt1499 ign1462 _mi1454 jen1451 lde1451 gt_1440 "
+        "ren1435 pe_1417 uk_1414 ner1411 ist1403 ar_1403 ang1395 res1395 ten1393 on_1388 lgt1382 eks1377 "
+        "app1377 _ar1366 nda1364 lge1361 _un1361 _fr1358 du_1356 ndr1350 und1348 lg_1343 are1337 lig1332 "
+        "iv_1332 pro1321 ers1313 lag1300 fra1297 at_1297 egn1297 omm1292 ern1287 ngs1279 str1279 ede1271 "
+        "_an1260 mer1260 eri1250 _te1247 ta_1247 inj1231 al_1226 sig1223 teg1213 ant1194 ele1184 jer1181 "
+        "map1178 ont1170 nje1170 _al1168 mma1160 ort1149 ene1141 ill1120 kon1115 tre1115 ret1112 _na1112 "
+        "eng1109 _be1107 ra_1099 ndo1096 st_1094 atu1094 hvi1094 els1091 kal1083 ska1080 før1067 _sl1064 "
+        "lut1064 _he1059 _ha1059 enn1054 ved1049 ile1046 orm1043 ut_1038 set1025 ove1025 lse1009 nta1009 "
+        "_ta1009 rd_1006 rma1006 slu1004 gn_1001 _bl996 les996 tat988 ord985 arg982 age972 _sa966 fik948 "
+        "met945 nin945 _ad945 sel943 gje937 tes937 ass937 gna932 rdi932 _fø916 ive914 ven914 nst914 _ov908 "
+        "ess906 tid890 ate882 ard874 _to871 tan863 ram861 sti861 erd858 rti858 vel850 _gr845 del839 mel839 "
+        "ume839 _n_837 kst831 _ny829 eve829 _sy829 old826 stø824 sse821 amm818 nn_818 per816 rse813 sen810 "
+        "asj808 ens800 hol800 har797 kk_797 gra797 att794 lt_794 akk794 _gj792 elt789 sam786 lis786 dar784 "
+        "pak778 let776 kje773 avs771 fin768 eli768 jør768 tar765 net760 ifi755 _da755 ble755 het749 ør_747 "
+        "_kj747 ull747 eld744 ore736 ykk733 min731 get731 itt731 kat731 red731 ige731 _ba728 gru728 kre726 "
+        "us_723 _må723 nen723 sor718 ika718 id_715 one710 las707 vsl707 ide704 me_696 _om691 _ek688 rgu688 "
+        "ytt686 ses686 sva683 gum683 pre681 fje681 esi681 lat678 nfo678 år_678 ars675 _fj675 nke673 enk673 "
+        "tur673 pas670 bar670 ttr670 tor667 kes659 nes657 lik657 _by654 mat651 kte649 bli649 ogr646 ils646 "
+        "ier643 _ne641 _fu641 lyk638 est633 kjø633 kt_630 nat628 byt620 øre620 ode617 hen614 rog614 tin614 "
+        "sis612 eme609 tro606 ute604 _at604 unn598 sk_598"
+    },
+    {
+        "nl",
+        "en_30319 et_11456 an_10265 de_10164 _ge9751 _de7365 sta6980 ver6698 _be6436 and6368 _va6307 een6277 "
+        "van6184 _in5666 nie5614 _op5316 _ni5296 _ve5290 est5153 nde5122 er_5048 iet4935 is_4842 tan4838 "
+        "bes4838 aar4766 _is4762 _he4756 ken4502 oor4471 ere4377 ie_4359 ing4300 tie4280 _on4093 te_4018 "
+        "den3915 ege3843 _ee3833 _vo3750 nd_3720 gel3651 het3631 _te3478 in_3391 gen3371 nge3365 or_3355 "
+        "der3339 aan3313 ten3311 rde3250 sch3212 ren3099 _al3083 uit3061 ord3061 ste3061 erd3053 eer2962 "
+        "voo2942 eld2928 rd_2851 naa2797 ers2783 geb2664 ng_2658 _me2650 _ma2646 dig2557 gev2537 cht2537 "
+        "_to2535 eke2529 ven2503 _wo2493 rui2485 eve2462 ls_2452 ebr2452 wor2440 _re2414 _st2408 ar_2398 "
+        "lle2378 men2350 _ka2333 kan2323 bru2309 el_2307 ent2303 _aa2303 uik2303 _ui2259 gee2231 voe2182 "
+        "ge_2124 _pa2106 _na2104 met2104 len2102 _en2088 _wa2078 ige2076 ter2049 ard2043 _co2027 es_1936 "
+        "al_1928 als1928 ati1910 _bi1878 ach1868 end1860 opt1856 st_1848 ond1842 kt_1818 nen1795 waa1789 "
+        "_di1723 eli1719 lij1713 erw1709 ele1699 it_1695 nt_1691 ldi1685 at_1670 oer1668 _of1668 of_1646 "
+        "pti1646 tal1614 tek1610 ijd1608 ont1590 kke1586 am_1564 ong1556 _do1550 all1533 out1527 dt_1519 "
+        "reg1517 wij1509 con1503 aam1471 pak1471 le_1463 fou1457 _ar1439 geg1409 pro1394 rdt1390 slu1388 "
+        "akk1374 aat1370 bij1370 op_1362 tel1362 ens1352 nst1336 _pr1334 _da1334 ket1332 ind1328 ges1304 "
+        "map1304 ree1304 one1284 nte1257 ike1249 _zi1249 ut_1247 ij_1243 eze1229 _ko1227 sie1225 _om1223 "
+        "ove1221 _fo1215 pen1207 chi1201 lee1195 ijn1191 ang1187 taa1185 _mi1169 tte1169 ijk1165 wer1157 "
+        "ap_1151 ig_1145 zij1145 maa1143 _le1124 ake1124 lin1090 ell1086 jn_1082 toe1078 jde1076 on_1074 "
+        "_mo1070 rei1070 erk1068 re_1068 ist1066 _ov1050 gro1046 _sy1042 _we1016 ht_1012 esc1006 rwi995 "
+        "daa995 ld_989 ns_981 _af979 ins963 gin963 dat951 _gr949 ppe947 om_945 wac943 ies941 ume933 rij931 "
+        "oeg917 _la915 ker915 tee915 kop911 rt_899 laa899 arg899 nda897 ite893 tvo891 hte887 ton883 _er881 "
+        "itv881 doo877 ik_877 mis875 ert866 nta864 ngs862 chr854 vol854 ze_854 tro842 aal838 die832 ukt830 "
+        "tij826 evo824 nds822 luk820 _sc812 ron810 ke_804 id_802 eid802 din800 res796 isl788 _u_784 com782 "
+        "che782 rgu778 gum778 eel772 oep764 dit760 ame758 cti758 roo752 ort748 erv748 pel748 del740 age733 "
+        "aak733 eri733 ett733 _zo725 rsi725 rsc719 rs_719 rst711 mak711 ale707 ect701 ede701 hee701 ene697 "
+        "nvo695 cha689 ieu687 mma687 euw685 mer685 _li683 nbe679 ess679 _sl679 _se677 rac673 bre671 ant667 "
+        "pre663 uid661 rte659 app657 erg655 dez655 kel647 oon647 ts_647 ode645 dra645 _ex645 lui641 bro641 "
+        "ein641 ica639 _ta639 roe635 idi633 ijz633 eks631 _el629 eis627 _ti625 us_623 ief623 ope621 mme621 "
+        "sen617 ats615 zen613 eme613 get613 opp613 arc613 orm607 ber607 _pl600 _br600 bel596 _wi592 ete592 "
+        "ft_592 onb590 ssi590 nti588 ute586 epa586 cat582 opg580 pge574 rin572 ger572 eek572 _hu570 opd564 "
+        "sys562 _no560 eem558 ijv558 omm554 rec552 jzi550 bev550 _ac550 str550 rch548 yst540 eta540 ef_540 "
+        "ndi538 pdr538 oud536 em_536 _ho536 hri534 oet532 era532 rge530 _ei530 inv528 woo526 _au524 ien524 "
+        "eva524 ces522"
+    },
+    {
+        "pl",
+        "nie18030 ie_15754 _ni9631 _po9114 ani6736 na_5933 _pr5681 _wy5444 ia_5148 _za5140 wan4935 _na4876 "
+        "nia4876 eni4718 _do4712 owa4334 sta4191 _pl4152 lik4134 pli4009 ch_3952 _je3948 rze3917 ny_3708 "
+        "prz3665 ne_3622 go_3595 _mo3573 ego3551 ów_3395 moż3182 st_3095 _w_3049 ści3010 est3000 pod2918 "
+        "pis2912 ych2887 jes2711 _ko2707 any2599 wie2550 żna2487 ożn2483 ji_2379 zna2348 awi2341 ać_2302 "
+        "ku_2293 do_2256 ej_2250 rzy2242 _od2176 ost2083 raw2068 uży2052 _li2043 _op2000 cze1986 ane1973 "
+        "czy1957 cji1933 _uż1933 dan1927 nyc1914 _st1902 ien1900 cie1896 _bł1894 _z_1887 je_1878 pra1876 "
+        "cza1866 _si1864 ier1818 _us1782 la_1776 ent1751 ika1749 _pa1739 kat1738 ię_1736 iku1720 tu_1719 "
+        "się1715 pro1688 no_1678 zen1666 kon1658 owy1613 naz1609 azw1607 ik_1586 yć_1583 _in1580 nik1571 "
+        "_re1562 wa_1562 ja_1554 _i_1552 owe1550 em_1530 wy_1528 kie1524 kow1523 _ro1519 neg1501 oda1494 "
+        "zmi1465 za_1462 _zn1458 acj1456 cja1455 _se1425 ci_1422 pow1419 ka_1413 czn1388 zy_1379 bra1375 "
+        "_ty1373 owi1370 pcj1370 opc1369 _ka1354 dzi1351 ale1335 ami1333 tal1315 ywa1314 zyt1311 dło1310 "
+        "mia1306 _ob1305 ym_1304 era1299 mie1293 su_1291 orz1281 ki_1270 ucz1266 luc1256 alo1252 klu1251 "
+        "men1241 bie1238 war1236 zas1233 icz1231 ło_1206 pol1205 _ma1200 ole1197 _ar1196 yst1191 ak_1190 "
+        "_zm1188 iet1187 _kl1183 aln1180 ini1180 _sk1180 _dl1177 _wi1177 dla1176 jąc1176 for1169 _te1168 "
+        "_we1159 ty_1159 ony1156 api1153 ko_1151 zap1150 taw1148 ków1147 roz1146 _cz1144 ust1144 _sy1142 "
+        "tan1136 log1120 łow1105 zon1105 ume1103 ąd_1095 ist1091 błą1083 lic1080 łąd1075 tor1073 "
+        "row1071 dow1061 jśc1056 ić_1055 ion1055 str1054 _lu1053 orm1052 ośc1050 two1046 ano1044 wor1037 "
+        "art1035 ian1029 it_1023 ocz1023 ub_1022 _gi1018 ata1016 lub1004 ść_1001 ez_999 rma998 aki992 "
+        "rto987 le_981 zan970 acz970 kcj959 _sp955 to_951 ako946 git940 _al940 li_938 szy932 one931 ran930 "
+        "odc926 ra_926 lec924 res924 wym912 rak912 isa909 nal907 fik904 ana904 wyk895 iep891 wid889 dcz886 "
+        "tów884 gra884 _wa882 nak879 ącz877 łąc876 ość873 yfi871 by_866 pak860 ers860 ece860 poz859 "
+        "cen855 ast854 ięc852 dni851 obi851 sek846 trz842 toś837 _ja836 _br831 ące821 błę817 łęd817 "
+        "iej817 _ws813 _zo813 wer810 yma809 ram807 idł805 zos803 _to803 nej803 wni800 jak797 uni796 tow791 "
+        "_da787 wej787 mi_787 wyp787 zys785 lin780 now779 ste779 zyć775 uje775 ono774 _ta774 ędn772 zek772 "
+        "we_772 ona769 eks764 zie764 ają764 stę761 że_756 ług751 iwa751 ze_750 ktu748 odp745 ikó744 "
+        "zwa739 ogr739 nię738 usu733 lne733 nan731 nym730 eśl726 bez721 wać719 ież718 żyt717 sze713 "
+        "ekt712 epr711 ach709 ont706 ypi705 aga699 iel697 arg697 ta_696 tni691 tyl690 _co685 ęci685 ter685 "
+        "tko684 mac679 cje678 tęp677 oka677 adn677 iem672 ce_669 lny666 wyj665 _tr665 _o_664 _bi663 own663 "
+        "ekc662 wsz660 pie658 _be658 nt_651 oże651 kom648 _no644 san642 _by641 ują641 zwy640 ali640 omi639 "
+        "dom638 iu_635 ma_635 ii_635 zak634 dpi633 zez632 mat632 arc630 lko628 cia627 zaw626 um_626 iek626 "
+        "rac622 ład620 lok617 isu616 ało615 yjś614 lon610 wio608 tem605 sow605 lni603 yta601 ylk601 akt598 "
+        "tyf595 weg592 inf592 nfo590 zer590 nac587 czo585"
+    },
+    {
+        "pt",
+        "_de18197 de_14886 ão_13281 do_10051 _co8306 os_7335 _pa6676 da_6239 ar_6115 ção6106 ado6070 "
+        "ra_5979 _se5960 ro_5870 _a_5774 fic5730 ent5507 _in5088 as_4875 _fi4873 es_4833 não4796 _nã4753 "
+        "em_4676 _re4624 par4581 _o_4531 eir4510 com4473 _es4314 iro4308 ara4266 nte4236 con4218 ich4115 "
+        "che4095 er_4051 te_4045 to_3947 hei3876 or_3653 _no3619 ada3356 _um3250 açã3191 _po3189 _pr3140 "
+        "tra3135 ta_3053 _li3040 sta3024 _do2992 ido2950 _ca2889 ica2865 ter2823 men2772 ont2735 _fo2708 "
+        "est2631 rad2621 um_2541 ma_2534 pos2441 dos2441 des2437 el_2412 _en2398 por2339 al_2316 vel2316 "
+        "_em2315 ver2315 _da2263 ist2257 for2183 _im2180 _ex2177 _é_2177 mpo2146 ntr2133 res2114 que2090 "
+        "me_2064 ome2059 íve2026 imp2026 ou_1957 esp1936 _di1925 liz1905 _fa1902 iza1896 _ma1886 ess1870 "
+        "eci1851 _ta1849 ida1844 são1807 _te1803 cad1778 nom1775 ões1775 ia_1766 _op1759 oss1738 _e_1735 "
+        "nto1729 _ar1725 ura1717 ir_1711 esc1693 man1693 ini1687 io_1685 err1685 efi1682 spe1681 pre1679 "
+        "fin1679 pro1663 sív1661 po_1650 _ve1648 ssí1645 _ou1629 lid1626 _qu1618 era1608 _er1592 no_1589 "
+        "def1587 alh1586 om_1578 lin1547 and1544 _su1538 rro1536 çõe1531 rma1528 ha_1526 _si1523 _ao1517 "
+        "se_1509 tad1504 so_1498 _us1496 orm1477 ao_1475 ser1470 ifi1469 ina1465 per1448 áli1424 lo_1414 "
+        "vál1406 dad1404 ali1403 tes1401 tem1400 uma1398 rec1395 ste1395 car1388 _va1382 loc1377 ndo1374 "
+        "fal1368 ho_1348 _al1340 mo_1337 omp1334 _mo1311 tar1307 ue_1302 inv1299 ect1286 is_1273 ros1270 "
+        "ort1252 opç1242 sec1236 rio1233 nvá1231 _x_1213 ria1213 ade1213 pri1213 til1205 int1204 _b_1193 "
+        "str1189 _me1175 ode1165 tam1165 inh1157 dor1156 ama1144 ten1141 cia1141 na_1141 _as1140 _pe1132 "
+        "ces1130 oca1124 act1116 rar1112 nha1111 ion1109 ote1091 vo_1088 _ne1074 ers1066 cri1063 ili1056 "
+        "tiv1056 _sa1047 pac1043 nde1042 _ac1030 val1024 aco1019 usa1019 das1014 lha1008 upo1003 _ap995 "
+        "cçã984 alt981 ve_978 pec976 ecç976 alo974 _ut969 sem960 ume958 ema957 cot953 nho952 ere949 qui939 "
+        "ual937 uti933 nta931 tip931 ame929 pod915 mbo905 olo902 ivo897 lho896 end896 rim889 nci883 scr881 "
+        "rta873 arg873 _na867 ca_867 ito865 ant860 ran854 enc854 _ti852 cid847 cal847 elo844 _lo841 mpr838 "
+        "age836 cha836 bol836 lis827 pas825 tos817 lic817 _ch815 ári814 ero814 rem811 nal807 _tr807 sco804 "
+        "inf801 oma801 ora799 anh799 omo793 erm791 re_791 cif790 nfo788 _os788 cio786 _gr783 mat778 hec772 "
+        "roc770 caç769 _le764 zad764 rgu764 ece762 mas762 ast761 ais761 iva761 ipo761 tur759 rmi759 rqu759 "
+        "_to756 eri753 zaç753 ída750 tua746 tal746 tro746 _so746 ime745 iga745 min743 cor743 óri743 la_742 "
+        "nco740 dir740 rel737 _nú735 tri734 _an734 abe734 lor730 aíd726 _sí726 pon724 mer722 pçã722 "
+        "sím721 _st721 red719 ala719 reg719 _ob717 seg714 núm713 ímb713 açõ713 saí709 rsã709 sup706 "
+        "oi_701 foi700 ona700 egu698 nhe697 onh693 lig693 ext692 ecu692 sin690 ass690 ede689 ine685 dis679 "
+        "ndi677 sa_674 arq674 sso673 nti671 raç671 içã665 gra665 dic661 ici660 eve658 emo656 ita653 ost653 "
+        "_cr648 _at647 co_637 úme637 _ba636 vis634 dei634 cti632 exp626 cam626 ins623 _av616 mit615 der615 "
+        "nid613 inc612 sti608 _ab607 rup607 fer605 am_604"
+    },
+    {
+        "ro",
+        "_de14726 de_11478 te_10768 re_10494 are10209 _nu8417 ea_6713 _se6342 ul_6332 ent6252 _în5679 "
+        "nu_5597 rea5564 tă_5538 _co5343 le_5202 _fi5165 iun4854 _in4533 ntr4472 ate4452 est4403 ste4288 "
+        "fiș4053 ier4035 _re3955 _pe3941 at_3872 tru3581 se_3456 _es3424 _ne3410 une3374 rul3372 în_3303 "
+        "_di3301 iși3287 șie3273 ie_3242 țiu3224 _a_3210 _pr3158 num3156 ui_3123 oar3106 ru_3101 ză_3094 "
+        "pen3074 ază3055 _po2970 car2890 _la2886 men2885 eaz2852 la_2834 lui2801 nea2772 ume2702 ele2693 "
+        "nte2639 _ca2632 ulu2577 ile2531 ere2516 val2507 ire2472 nt_2453 ter2399 _un2395 ist2394 int2382 "
+        "_cu2382 con2378 ne_2342 or_2322 tat2293 ect2253 ali2251 _ex2242 che2223 ați2216 cți2185 tor2183 "
+        "_ac2164 ată2148 sta2120 _ar2120 _op2103 com2082 _li2075 ii_2047 liz2044 _su2016 ica1976 fic1962 "
+        "un_1943 ero1939 iza1934 ver1931 _fo1912 er_1894 ces1892 _si1880 rec1870 ște1868 cu_1858 ili1852 "
+        "ri_1849 eru1833 it_1821 _st1809 ifi1807 _da1804 _er1802 oat1800 sec1764 că_1764 pre1762 tul1760 "
+        "ră_1753 uni1753 să_1736 loc1732 al_1727 _ma1676 til1666 _și1649 pro1647 _o_1643 ți_1629 alo1617 "
+        "_ut1603 uti1595 roa1581 _pa1569 _va1563 me_1544 poa1532 ut_1513 ecu1508 ecț1499 ini1478 pți1461 "
+        "ori1457 id_1452 imb1450 bil1445 _al1445 str1441 uri1440 și_1436 tre1422 _s_1421 tar1410 oca1386 "
+        "in_1368 _sa1368 au_1367 ar_1363 ia_1358 siu1358 ta_1353 opț1353 lid1325 for1318 _ti1313 tra1311 "
+        "act1311 tur1293 res1290 din1287 orm1283 imp1274 ici1273 rar1271 nec1269 rma1257 ace1255 ei_1250 "
+        "lic1245 st_1243 des1243 lor1241 cat1234 cit1196 _ve1194 sau1194 sim1189 ara1189 eri1184 _să1173 "
+        "dat1158 lă_1154 pri1149 _sc1146 _b_1140 zat1135 _tr1133 _me1132 ept1128 ime1119 _pu1116 per1112 "
+        "ina1104 ato1104 cte1102 _af1100 _ch1099 lul1099 cut1088 abi1088 ce_1086 eșt1079 par1071 _im1071 "
+        "ări1064 mbo1064 por1060 bol1060 ine1055 șir1053 pta1050 ca_1048 înc1046 rat1045 _mo1041 omp1041 "
+        "ite1031 _sp1031 chi1027 ers1027 tri1006 _ad998 țin996 _ci992 scu975 tiv971 hei968 oru964 dir959 "
+        "mul951 lin947 ită937 cri937 eva937 ril935 cun928 ort923 utu923 tip923 ții921 esa916 rie914 tab914 "
+        "put910 ție909 esc905 _no902 _do902 mat897 dă_897 scr883 nev883 uno879 cep876 olu874 min870 eci870 "
+        "and863 eși863 reg862 tea855 _au850 het850 rsi846 spe844 afi844 stă841 imi839 _x_836 _ie836 pli830 "
+        "rel830 ale825 ont823 iți823 nă_822 _lu822 ten820 mai816 mpl816 ai_808 ert808 eal804 nos799 cre799 "
+        "ra_794 pec790 rti790 ică789 ive787 inf783 nfo782 mod780 nal775 ura773 ni_771 _ni769 ins768 măr764 "
+        "cif763 ieș761 _ce759 ion759 osc757 cce757 bui757 eta754 mel754 nd_754 loa750 ide750 ach745 ebu743 "
+        "ost742 _an742 erm740 sch740 pul733 rim733 umă731 tel731 pot731 cal731 iti729 et_726 rmi726 cor726 "
+        "ind726 pac724 _bi722 unt719 _te717 pe_712 ctu710 ext709 ult705 nic703 ute702 cto702 tim698 _ap698 "
+        "sit698 _lo698 _el696 nți695 roc695 fos693 man684 ens684 inc682 ita681 ece679 mit677 înt677 sup677 "
+        "exp672 _cr672 ătu672 ant670 era669 nsi669 lis669 unc665 ct_660 fi_660 arh658 rhi658 sem656 acc655 "
+        "fie655 edi653 _ta653 tut651 ete651 _câ651 lur649 tif649 _ob648 sun648 _fu646 nst642 lim637 toa637 "
+        "reb635 tal635 egi635 șea635 etu634 ișe630"
+    },
+    {
+        "ru",
+        "_не11372 ть_8732 ени7208 _по6691 _пр5841 не_5523 ие_4998 ние4617 пол4247 "
+        "ать4233 _в_4208 ия_4063 _за4061 ый_3891 _ко3726 ова3665 ся_3621 оль3561 "
+        "мен3367 ля_3330 но_3316 стр3265 _ра3260 ет_3167 фай3142 айл3142 _фа3133 "
+        "ка_3102 _вы3097 _дл3091 ния3044 тся3022 ный2980 пер2947 ить2916 _со2871 "
+        "про2808 для2735 _на2722 ани2677 раз2621 ват2601 етс2600 пре2584 ров2522 "
+        "го_2517 нны2512 вер2458 на_2446 льз2417 ой_2416 ало2396 _па2349 _ис2326 "
+        "уда2293 дал2286 _уд2254 _об2251 спо2244 _пе2238 ере2238 _от2234 ов_2228 "
+        "_до2189 ии_2184 льн2149 _си2134 ред2096 дел2089 анн2082 ста2053 сь_2045 "
+        "ком2024 ого2023 ест2008 ост2006 тро2006 ом_2003 ки_1960 ств1939 ые_1937 "
+        "ван1931 ли_1921 ое_1910 _ст1908 ает1877 исп1876 нов1865 _ре1852 зов1847 "
+        "ла_1817 _ка1802 ент1790 чен1780 уст1773 под1764 _из1758 ая_1748 сти1747 "
+        "лен1741 пис1720 при1714 _с_1678 _ин1656 сим1639 ует1610 ых_1610 мет1606 "
+        "дан1589 еме1584 иро1555 ось1538 тел1535 ий_1531 лос1528 _им1514 нач1509 "
+        "клю1508 люч1508 енн1508 ель1504 зна1477 рам1474 нев1473 лов1465 та_1463 "
+        "ьзо1457 ист1455 ера1447 оши1447 ект1446 _и_1443 _ош1436 шиб1435 кат1427 "
+        "вол1422 тор1419 ите1416 каз1414 мож1414 жен1413 _оп1401 те_1397 имв1396 "
+        "дер1393 ива1392 ные1389 пар1386 мво1383 щен1382 рав1382 зап1366 ибк1365 "
+        "аме1364 нен1349 ерж1336 рем1331 пус1297 аци1291 ных1281 тан1270 анд1266 "
+        "ден1243 зме1241 или1240 ное1238 ти_1237 нно1219 ран1217 аза1212 йл_1207 "
+        "бра1203 бка1202 ара1198 ен_1188 _ве1188 рок1186 име1179 жно1177 ног1169 "
+        "ата1155 сли1154 аче1151 ции1142 ход1134 _сл1126 ате1098 ок_1093 ока1085 "
+        "_ил1082 _но1081 мер1078 ано1077 ржи1074 етр1072 ию_1069 воз1068 зде1063 "
+        "_то1058 обр1055 пра1037 ра_1036 азд1024 ная1023 сто1018 реж1016 ожн1011 "
+        "_ар1011 ей_1006 ной1001 ика998 вае996 мещ992 орм991 ьны990 олн989 фор987 "
+        "_ус974 вле966 сле962 _зн962 опу961 фик958 то_955 кон954 ука953 оди951 "
+        "чит949 _бы949 _ук949 еще939 тны936 ево932 _кл928 ерн927 рма923 _да918 "
+        "кци913 _мо904 рек903 йла901 _эт900 змо899 пос897 одн895 озм893 тал887 "
+        "ьно885 вод878 ри_876 ене875 ер_874 по_874 нст874 ыть866 _x_863 _се863 "
+        "да_861 _сп858 оло854 тек852 аль850 мя_847 оже847 ле_847 тву843 ми_841 "
+        "_чт840 рег839 тно837 лог836 ома833 ави819 из_814 тов809 од_808 пак807 "
+        "тр_804 _b_802 ада801 еги799 доп796 опе791 ко_788 это779 гис778 еде775 "
+        "ифи773 ори772 ны_772 неп768 кет767 ман766 выв763 едо756 ном744 ото743 "
+        "имо740 _ди736 льк736 иче734 тру729 ем_728 вес728 зан728 ска728 ьзу728 "
+        "ты_725 апи718 одд717 дде716 жив716 ожи713 оде713 або710 рук709 изв708 "
+        "авл708 ько708 рир708 лок707 раб707 аке706 зда705 еве703 ыва703 дол700 "
+        "ры_699 чес698 тим697 ено695 ово695 тат694 ым_694 екс693 нит691 олж689 "
+        "ина688 код686 еду686 вит685 отк685 озд684 сте683 быт681 ежд680 вре677 "
+        "изм675 еск674 яет674 соз673 кор672 зад672 его672 ена671 еко671 инс670 "
+        "рас670 ида667 вля666 _ме666 мат665 овк665 ак_665 уме665 еле664 _вн664 "
+        "емы659 ове657 азо657 имя655 рес654 дат653 нос649 жид649 тол649 упр648 "
+        "it_647 тип647 тре645 нт_645 осл644 тиф642 ний642 укц642 оме641 дно639 "
+        "_ти635 лит634 айт634 нео632 вет628 ую_625 епо624 тст623 _ес623 оки621 "
+        "тра619 стн618 нед617"
+    },
+    {
+        "sv",
+        "_in12364 en_10621 er_9285 nte7962 för7784 ing7533 te_7506 _fö7434 int7181 era6389 ör_5808 ter5369 "
+        "et_5282 ar_5146 de_4914 _an4633 ra_4616 tt_4388 _st4332 nde4318 änd4174 _de4086 ng_4031 ill3973 "
+        "nin3932 ll_3917 an_3839 _ti3757 ta_3737 ler3728 til3616 vän3572 ion3544 _en3521 ade3450 fil3442 "
+        "är_3440 and3432 _me3401 _i_3397 _av3385 om_3361 sta3274 ver3208 _ko3164 _fi3142 lle2921 _ka2889 "
+        "_är2794 med2781 att2768 tio2746 kti2686 _ut2639 _sk2635 _re2634 nda2610 anv2597 nvä2584 _at2539 "
+        "rad2529 ste2466 tig2458 gen2405 av_2350 rin2311 on_2309 ed_2309 ell2283 yck2281 kan2263 fel2249 "
+        "var2247 ad_2213 den2164 _so2156 nd_2143 tal2093 _vi2077 es_2054 _va2033 eri2032 _fe2032 nge2029 "
+        "ata2025 som1994 nt_1966 el_1959 ist1934 des1923 _om1899 nam1876 ig_1875 ent1868 _på1859 ett1844 "
+        "as_1842 und1825 der1824 _lä1824 at_1794 kom1775 tan1770 lti1759 på_1747 ch_1747 cke1736 ort1733 "
+        "det1731 ekt1726 amn1711 na_1707 gt_1657 men1656 ilt1655 ska1645 mma1645 _oc1642 _el1627 lag1622 "
+        "_mi1609 ngs1603 _ar1601 ga_1583 all1581 _se1575 och1572 igt1565 ile1560 ser1556 ati1553 nta1548 "
+        "tta1548 gil1541 nst1521 nga1520 str1515 akt1507 _fl1506 ara1501 rt_1500 dat1496 skr1444 mat1423 "
+        "ers1421 st_1420 cka1412 _ta1401 _et1395 kat1384 kri1381 _sy1377 agg1373 _sa1368 la_1359 upp1358 "
+        "inn1356 _pr1341 il_1340 ela1335 re_1315 eck1311 _fr1305 _ha1303 mn_1298 ogi1295 id_1294 stä1284 "
+        "dar1283 sa_1281 kon1269 _og1269 riv1266 ang1250 log1248 _pa1243 ren1240 änt1239 _gi1227 gar1227 "
+        "fla1223 lis1214 tor1207 pro1206 ant1191 äll1190 al_1186 omm1180 for1169 man1169 lla1156 kad1153 "
+        "mer1151 lig1141 _x_1140 ns_1130 ärd1129 tad1125 _vä1123 are1123 ons1118 ka_1115 end1114 len1112 "
+        "öve1112 kun1111 or_1111 ins1108 tar1100 orm1097 lut1095 ner1090 uta1073 _be1071 rer1070 rat1062 "
+        "mis1060 it_1058 reg1058 frå1057 _ny1050 rde1045 _ku1044 slu1042 ive1039 ket1029 tet1019 rma1015 "
+        "ind1015 har1010 ran1007 one1007 ssl1004 lyc1004 sto1001 rar996 _öv990 _ma985 ut_975 rån974 äng974 "
+        "iss973 ån_973 _än966 vär964 alo961 vis961 del955 mme953 _al947 sym944 ndr942 ess937 _up936 sly930 "
+        "kän930 kal926 fin922 _si917 ens912 kt_909 _na909 _må908 in_907 _gr897 tat896 _ok891 rd_885 _ve885 "
+        "ken881 _bo880 mbo876 sek875 bol875 _ra874 ymb870 isa862 ast860 da_857 ge_854 ign852 iv_850 bor849 "
+        "vid849 kni843 _te842 ten835 nne831 git830 gga830 ätt830 stö828 amm825 täl825 per821 gra819 "
+        "okä817 ras816 sök813 ern813 _li812 sig812 sam810 tiv809 che807 ark803 _du802 _op800 sio784 egi783 "
+        "ts_779 dra774 let774 res774 läs764 ere762 gis757 bar755 avs755 val753 hål752 nna752 _to751 län750 "
+        "arn741 kap740 das739 åll738 ake737 lak736 rna735 _ex734 lok733 töd729 ard728 ck_721 lt_720 erv719 "
+        "läg714 _po711 sen708 typ706 itt705 ram704 nen702 isk697 nyc696 _ge696 lan695 ont694 ate693 atu692 "
+        "inf692 ope689 _sl684 apa682 rsi682 ise681 _by681 gor678 kna677 tec674 _un672 ds_671 dni671 pak671 "
+        "par670 _hi670 kel669 arg669 oll668 ier666 ume662 nfo659 byt659 pos656 ger656 rän654 kod653 örs651 "
+        "ali645 art644 _di640 oka638 _no636 pa_633 du_626 sät626 iga623 ndo619 han618 örv618 ehå618 red617 "
+        "_ef616 åst612 _bi611 fte611 rki611 _tr609"
+    },
+    {
+        "tr",
+        "_bi7005 lan6432 eri6105 ir_5805 in_5693 en_5574 _de5397 lar5091 ama4696 _do4618 _ya4593 bir4500 "
+        "ler4461 anı4452 _ge4201 _iç4123 an_4037 _ve4007 yor3961 arı3923 dos3881 sya3874 osy3870 ile3837 "
+        "içi3819 er_3806 or_3742 _ba3714 ası3644 _ol3643 len3542 ya_3519 lam3496 _ka3465 çin3410 ara3351 "
+        "eçe3193 dı_3174 _ku3141 değ3122 eği3038 ak_3033 sı_3013 kle3013 ini2998 _se2996 _sa2978 "
+        "ıla2935 lla2915 ar_2865 ri_2838 ull2806 lem2797 ene2763 ste2747 ma_2723 kul2713 le_2699 alı2685 "
+        "ili2652 ekl2610 _ha2563 çer2562 de_2557 bil2529 adı2505 eme2451 nde2449 _ye2381 şle2365 _be2350 "
+        "nda2350 ını2337 ni_2328 geç2311 si_2301 ır_2279 da_2255 ala2254 esi2250 ind2233 ayı2227 _gi2210 "
+        "iz_2181 rı_2154 _ta2140 _ko2116 _bu2112 _pa2101 iyo2098 _di2097 den2058 lir2057 eti2056 rin2047 "
+        "eni2047 _ar2041 lı_2014 rak2002 di_1990 ın_1989 nı_1987 _il1984 dır1983 ata1968 tır1965 mad1959 "
+        "tir1943 yen1922 _al1895 eli1886 me_1876 ola1866 ana1852 baş1850 li_1842 _iş1836 ek_1828 iri1823 "
+        "yaz1816 _ad1813 işl1797 siz1779 ne_1755 hat1750 _so1730 _ay1725 ter1721 _yo1715 rsi1714 uru1708 "
+        "ik_1695 aya1687 ınd1671 ers1650 ve_1645 _gö1628 tar1616 ıyo1602 izi1601 sın1592 bel1574 sin1556 "
+        "ırı1542 seç1533 la_1529 ki_1528 it_1523 tan1507 say1505 _da1493 ist1493 ere1459 edi1448 ok_1437 "
+        "lma1434 ril1425 ğiş1424 yar1410 _an1405 yal1393 ver1393 ine1388 and1385 rın1377 diz1373 yas1361 "
+        "çık1360 ılı1358 son1347 lik1346 şti1339 ket1337 _si1309 ısı1306 dan1306 emi1304 ula1298 "
+        "atı1295 rıl1294 _he1289 leş1283 rla1280 nam1262 ele1255 nım1251 amı1250 nın1243 _ça1241 "
+        "zin1238 çen1234 rma1226 bu_1216 ldı1215 ürü1211 _ön1208 _çı1206 yok1205 eye1201 mey1196 "
+        "_i_1194 isi1192 rle1190 mi_1182 kar1177 yer1174 dir1162 _ki1147 ta_1141 nme1140 ış_1138 rul1135 "
+        "eya1130 erl1128 vey1128 olu1127 ğer1127 _bo1116 man1109 ger1108 eğe1096 al_1086 ndı1084 kte1077 "
+        "_sı1066 ken1062 ği_1060 enm1059 _sü1057 yap1055 _uy1053 et_1039 rme1039 onu1037 lle1034 _te1032 "
+        "nek1022 mas1014 par1008 nin1008 git1005 bağ1001 il_1001 ndi1000 unu999 azı995 ilm990 ake986 "
+        "çal966 na_964 _ek964 end961 ıml960 lin955 _tü955 nıl955 pak954 mak952 sat952 num947 _in946 "
+        "miy941 iği937 lış935 abi929 ız_925 ulu919 yan917 tur916 el_916 ird910 iş_901 _ne901 aşa900 "
+        "ell900 sür895 iml895 ştı892 nla891 ağl886 tek882 _li873 nce873 _s_868 gir868 eks863 cı_857 "
+        "med857 arl857 kay857 olm857 may856 üm_853 mıy849 aht847 mış843 _re842 hta838 rek837 tem837 "
+        "nah836 apı836 ına834 una832 irt827 ğil823 _et822 ede822 akt818 des815 işi814 kal812 rti810 "
+        "im_808 miş805 nız803 dek803 aki800 _is799 içe798 luş795 eki794 ırm793 ğla789 irm789 ışt784 "
+        "ıcı780 şar774 alt771 _fa768 ikl765 mle761 mut761 dur760 sız758 imi755 rdi754 ştu753 nes751 "
+        "est751 gör750 irl749 uşt748 tal748 lis748 üze746 ut_745 kom743 _bö743 du_740 omu739 yı_736 "
+        "emb736 ktı735 mbo734 bol733 nu_733 til731 bul731 em_729 ılm729 ıkt728 sem725 rli717 kla714 ayn714 "
+        "az_710 pıl706 ral699 _st696 _gü694 am_689 işt687 mla685 _va684 ölü682 tür681 rde679 rum677 "
+        "lme677 re_677 böl677 ığı676 lgi675 lun675 var675 mal675 ilg673 mel670 kon668 ağı661 eşt661 "
+        "un_661 anm660 ide658 _uz657 ci_650 tı_650 oku648 tla646"
+    }
+};
+
+}
+
+TextSource::~TextSource()
+{
+    /// nothing
+}
+
+bool TextSource::isInMemory() const
+{
+    return false;
+}
+
+QString TextSource::window(int index)
+{
+    const QString text = part(index);
+    if (text.length() <= windowLength)
+        return text;
+    return text.mid((text.length() - windowLength) / 2, windowLength);
+}
+
+QString TextSource::sample(int maxLength)
+{
+    QString result;
+    const QVector<int> order = stratifiedOrder(numParts());
+    for (int index : order) {
+        if (result.length() >= maxLength) break;
+        const QString text = window(index);
+        if (!text.isEmpty())
+            result.append(text).append(QChar(' '));
+    }
+    return result;
+}
+
+QVector<int> TextSource::stratifiedOrder(int numParts)
+{
+    QVector<int> order;
+    if (numParts < 1) return order;
+    order.reserve(numParts);
+
+    int bits = 0;
+    while ((1 << bits) < numParts) ++bits;
+    /// Reversing the bits of 0, 1, 2, 3, ... yields 0, 1/2, 1/4, 3/4, ...
+    /// of the next power of two, which covers every part when scaled
+    QVector<bool> visited(numParts, false);
+    for (int i = 0; i < (1 << bits); ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b)
+            if ((i & (1 << b)) != 0)
+                reversed |= 1 << (bits - 1 - b);
+        const int index = static_cast<int>(static_cast<qint64>(reversed) * numParts >> bits);
+        if (!visited[index]) {
+            visited[index] = true;
+            order.append(index);
+        }
+    }
+    return order;
+}
+
+PlainTextSource::PlainTextSource(const QString &text)
+    : m_text(text)
+{
+    /// nothing
+}
+
+int PlainTextSource::numParts()
+{
+    return (m_text.length() + partLength - 1) / partLength;
+}
+
+QString PlainTextSource::part(int index)
+{
+    return m_text.mid(index * partLength, partLength);
+}
+
+bool PlainTextSource::isInMemory() const
+{
+    return true;
+}
+
+LanguageIdentifier *LanguageIdentifier::instance()
+{
+    static QMutex instanceMutex;
+    static LanguageIdentifier *identifier = nullptr;
+
+    QMutexLocker locker(&instanceMutex);
+    if (identifier == nullptr) {
+        /// Never deleted, lives as long as the process
+        identifier = new LanguageIdentifier();
+    }
+    return identifier;
+}
+
+LanguageIdentifier::LanguageIdentifier()
+{
+    const int numProfiles = sizeof(profiles) / sizeof(profiles[0]);
+    m_logProbabilities.resize(numProfiles * numBuckets);
+
+    for (int p = 0; p < numProfiles; ++p) {
+        m_languages.append(QString::fromLatin1(profiles[p].language));
+
+        /// Sum up frequencies of trigrams sharing a bucket
+        QVector<double> frequencies(numBuckets, 0.0);
+        double total = 0.0, minFrequency = 1.0e6;
+        const QStringList entries = QString::fromUtf8(profiles[p].trigrams).split(QChar(' '), QString::SkipEmptyParts);
+        for (const QString &entry : entries) {
+            const QString trigram = entry.left(3).replace(QChar('_'), QChar(' '));
+            const double frequency = entry.mid(3).toDouble();
+            if (trigram.length() != 3 || frequency <= 0.0) continue;
+            frequencies[bucket(trigram[0].unicode(), trigram[1].unicode(), trigram[2].unicode())] += frequency;
+            total += frequency;
+            minFrequency = qMin(minFrequency, frequency);
+        }
+
+        /// Trigrams not in a profile are assumed to be rarer
+        /// than the profile's rarest trigram
+        const float floor = static_cast<float>(std::log(minFrequency / total) - 1.0);
+        float *logProbabilities = m_logProbabilities.data() + p * numBuckets;
+        for (int b = 0; b < numBuckets; ++b)
+            logProbabilities[b] = frequencies[b] > 0.0 ? static_cast<float>(std::log(frequencies[b] / total)) : floor;
+    }
+}
+
+QString LanguageIdentifier::identify(const QString &text, double *confidence) const
+{
+    QVector<float> counts(numBuckets, 0.0f);
+    int numTrigrams = 0;
+    countTrigrams(text, qMin(text.length(), maxSampleLength), counts, numTrigrams);
+    return decide(counts, numTrigrams, confidence);
+}
+
+QString LanguageIdentifier::identify(TextSource &source, double *confidence, QString *sample) const
+{
+    QVector<float> counts(numBuckets, 0.0f);
+    int numTrigrams = 0, numWindows = 0;
+
+    const QVector<int> order = TextSource::stratifiedOrder(source.numParts());
+    for (int index : order) {
+        const QString window = source.window(index);
+        if (window.isEmpty()) continue; ///< e.g. pages with images only
+        countTrigrams(window, window.length(), counts, numTrigrams);
+        if (sample != nullptr)
+            sample->append(window).append(QChar(' '));
+
+        if (++numWindows >= maxSampleWindows) break;
+        if (numWindows >= minSampleWindows) {
+            /// Scoring is cheap compared to retrieving further parts
+            double windowConfidence = 0.0;
+            if (!decide(counts, numTrigrams, &windowConfidence).isEmpty() && windowConfidence >= decisiveConfidence)
+                break;
+        }
+    }
+
+    return decide(counts, numTrigrams, confidence);
+}
+
+QStringList LanguageIdentifier::languages() const
+{
+    return m_languages;
+}
+
+void LanguageIdentifier::countTrigrams(const QString &text, int length, QVector<float> &counts, int &numTrigrams)
+{
+    ushort previous2 = ' ', previous1 = ' ';
+    for (int i = 0; i <= length; ++i) {
+        /// Pretend the text ends in a space to count its last word's trigram
+        const QChar c = i < length ? text[i] : QChar(' ');
+        const ushort current = c.isLetter() ? c.toLower().unicode() : ' ';
+        if (current == ' ' && previous1 == ' ') continue;
+        if (previous1 != ' ') {
+            counts[bucket(previous2, previous1, current)] += 1.0f;
+            ++numTrigrams;
+        }
+        previous2 = previous1;
+        previous1 = current;
+    }
+}
+
+QString LanguageIdentifier::decide(const QVector<float> &counts, int numTrigrams, double *confidence) const
+{
+    if (confidence != nullptr) *confidence = 0.0;
+    if (numTrigrams < minTrigrams) return QString();
+
+    /// Average log-probability per trigram for each language
+    float bestScore = 0.0f, secondScore = 0.0f;
+    int best = -1, second = -1;
+    const float *countData = counts.constData();
+    for (int l = 0; l < m_languages.count(); ++l) {
+        const float *logProbabilities = m_logProbabilities.constData() + l * numBuckets;
+        float score = 0.0f;
+        for (int b = 0; b < numBuckets; ++b)
+            score += countData[b] * logProbabilities[b];
+        score /= numTrigrams;
+        if (best < 0 || score > bestScore) {
+            second = best;
+            secondScore = bestScore;
+            best = l;
+            bestScore = score;
+        } else if (second < 0 || score > secondScore) {
+            second = l;
+            secondScore = score;
+        }
+    }
+
+    if (confidence != nullptr && second >= 0)
+        *confidence = 1.0 - std::exp(-4.0 * (bestScore - secondScore));
+    return m_languages[best];
+}
+
+int LanguageIdentifier::bucket(ushort a, ushort b, ushort c)
+{
+    quint32 h = (a * 0x9E3779B1u) ^ (b * 0x85EBCA77u) ^ (c * 0xC2B2AE3Du);
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return static_cast<int>(h & (numBuckets - 1));
+}
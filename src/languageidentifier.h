@@ -0,0 +1,166 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+
+#ifndef LANGUAGEIDENTIFIER_H
+#define LANGUAGEIDENTIFIER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * Text of a document made up of parts like pages or paragraphs,
+ * so that samples can be drawn from all over the document without
+ * retrieving all of its text.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class TextSource
+{
+public:
+    virtual ~TextSource();
+
+    virtual int numParts() = 0;
+    virtual QString part(int index) = 0;
+
+    /**
+     * Whether all parts are held in memory, i.e. visiting
+     * every part is cheap. Default is 'false'.
+     */
+    virtual bool isInMemory() const;
+
+    /**
+     * Window of at most windowLength characters from
+     * the middle of a part.
+     */
+    QString window(int index);
+
+    /**
+     * Windows of parts in stratified order, concatenated
+     * until at least maxLength characters are sampled.
+     */
+    QString sample(int maxLength);
+
+    /**
+     * Order in which to visit parts, so that the parts visited
+     * first are spread evenly over the whole document: first and
+     * middle part, then first and third quarter, and so on.
+     */
+    static QVector<int> stratifiedOrder(int numParts);
+
+    static const int windowLength;
+};
+
+/**
+ * Plain text split into parts of equal length.
+ */
+class PlainTextSource : public TextSource
+{
+public:
+    explicit PlainTextSource(const QString &text);
+
+    int numParts();
+    QString part(int index);
+    bool isInMemory() const;
+
+private:
+    static const int partLength;
+
+    const QString m_text;
+};
+
+/**
+ * Identifies the language of a text in-process by comparing the
+ * frequencies of its character trigrams with built-in profiles
+ * of common European languages.
+ * Trigrams are hashed into a fixed number of buckets, so that
+ * scoring a text against all profiles is a series of dot products
+ * over contiguous arrays.
+ * The single instance is thread-safe, as it is never modified
+ * once created.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class LanguageIdentifier
+{
+public:
+    static LanguageIdentifier *instance();
+
+    /**
+     * Identify the language of a text. Only the text's beginning
+     * is considered, see maxSampleLength.
+     *
+     * @param text text to identify the language of
+     * @param confidence if not null, set to a value between 0.0 (best
+     * and second-best language are indistinguishable) and 1.0
+     * @return two-letter language code like 'de', or an empty string if the text contains too few letters
+     */
+    QString identify(const QString &text, double *confidence = nullptr) const;
+
+    /**
+     * Identify the language of a document by sampling windows of
+     * its parts in stratified order, so that e.g. an abstract in a
+     * different language does not decide the document's language.
+     * Sampling stops once the language is certain enough or
+     * maxSampleWindows windows got sampled.
+     *
+     * @param source document to identify the language of
+     * @param confidence if not null, set as for identify(const QString &, double *)
+     * @param sample if not null, windows sampled get appended to it
+     * @return two-letter language code like 'de', or an empty string if the sampled text contains too few letters
+     */
+    QString identify(TextSource &source, double *confidence = nullptr, QString *sample = nullptr) const;
+
+    /// Codes of all languages that can be identified
+    QStringList languages() const;
+
+    /// Number of characters at the beginning of a text considered for identification
+    static const int maxSampleLength;
+    /// Number of windows sampled at most from a TextSource
+    static const int maxSampleWindows;
+
+private:
+    static const int numBuckets;
+    /// Texts with fewer trigrams get no language assigned
+    static const int minTrigrams;
+    /// Sampling stops early once this many windows
+    /// yield decisiveConfidence
+    static const int minSampleWindows;
+    static const double decisiveConfidence;
+
+    QStringList m_languages;
+    /// One block of numBuckets log-probabilities per language
+    QVector<float> m_logProbabilities;
+
+    LanguageIdentifier();
+
+    /**
+     * Count trigrams of the normalized text, i.e. lower-case letters
+     * with anything else collapsed into single spaces.
+     */
+    static void countTrigrams(const QString &text, int length, QVector<float> &counts, int &numTrigrams);
+    QString decide(const QVector<float> &counts, int numTrigrams, double *confidence) const;
+    static int bucket(ushort a, ushort b, ushort c);
+};
+
+#endif // LANGUAGEIDENTIFIER_H
@@ -24,11 +24,30 @@
 
 #include <typeinfo>
 
+#include <unistd.h>
+
 #include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTimer>
+#include <QDebug>
+
+#include "journal.h"
+#include "stagetiming.h"
+#include "general.h"
+
+/// Journal entries are committed once this many are pending ...
+static const int journalGroupSize = 64;
+/// ... or at the latest after this many milliseconds
+static const int journalGroupDelay = 1000;
 
 LogCollector::LogCollector(QIODevice *output, QObject *parent)
-    : QObject(parent), m_ts(output), m_output(output), m_tagStart(QStringLiteral("<(\\w+)\\b"))
+    : QObject(parent), m_ts(output), m_output(output), m_tagStart(QStringLiteral("<(\\w+)\\b")), m_journal(nullptr)
 {
+    m_journalTimer = new QTimer(this);
+    m_journalTimer->setSingleShot(true);
+    connect(m_journalTimer, SIGNAL(timeout()), this, SLOT(commitJournal()));
+
     m_ts << "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>" << endl << "<log isodate=\"" << QDateTime::currentDateTimeUtc().toString(Qt::ISODate) << "\">" << endl;
 }
 
@@ -41,12 +60,127 @@ void LogCollector::receiveLog(const QString &message)
 {
     QString key = QString(typeid(*(sender())).name()).toLower().remove(QRegExp(QStringLiteral("[0-9]+")));
 
+    StageTimer timer(QStringLiteral("log-write"));
     QString time = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
     m_ts << "<logitem epoch=\"" << (QDateTime::currentMSecsSinceEpoch() / 1000) << "\" source=\"" << key << "\" time=\"" << time << "\">" << endl << message << "</logitem>" << endl;
+
+    if (m_journal != nullptr)
+        journalReport(message);
+}
+
+void LogCollector::setJournal(Journal *journal)
+{
+    m_journal = journal;
+}
+
+void LogCollector::journalReport(const QString &message)
+{
+    static const QRegExp fileAnalysisRegExp(QStringLiteral("^<fileanalysis filename=\"([^\"]*)\""));
+    static const QRegExp uncompressRegExp(QStringLiteral("^<uncompress status=\"[^\"]*\".*<origin [^>]*>([^<]*)</origin>\\s*<destination [^>]*>([^<]*)</destination>"));
+
+    QRegExp fileAnalysis(fileAnalysisRegExp), uncompress(uncompressRegExp);
+    if (uncompress.indexIn(message) == 0) {
+        /// Analysis of the uncompressed file completes the compressed file,
+        /// which is reported even if uncompressing failed
+        m_uncompressedOrigin.insert(DocScan::dexmlify(uncompress.cap(2)), DocScan::dexmlify(uncompress.cap(1)));
+    } else if (fileAnalysis.indexIn(message) == 0) {
+        const QString filename = DocScan::dexmlify(fileAnalysis.cap(1));
+        const QString origin = m_uncompressedOrigin.take(filename);
+        m_journal->append(origin.isEmpty() ? filename : origin);
+
+        if (m_journal->numUncommitted() >= journalGroupSize)
+            commitJournal();
+        else if (!m_journalTimer->isActive())
+            m_journalTimer->start(journalGroupDelay);
+    }
+}
+
+void LogCollector::commitJournal()
+{
+    m_journalTimer->stop();
+    if (m_journal == nullptr || m_journal->numUncommitted() == 0) return;
+
+    StageTimer timer(QStringLiteral("log-sync"));
+    /// Reports have to be on disk before they are recorded as completed
+    m_ts.flush();
+    QFile *file = qobject_cast<QFile *>(m_output);
+    if (file != nullptr) {
+        file->flush();
+        fsync(file->handle());
+    }
+    m_journal->commit();
+}
+
+QString LogCollector::prepareResumedLog(const QString &filename)
+{
+    const QFileInfo fi(filename);
+    const QString stem = fi.path() + QChar('/') + fi.completeBaseName();
+    const QString suffix = fi.suffix().isEmpty() ? QString() : QChar('.') + fi.suffix();
+
+    /// Close logs of all previous runs, then pick the first unused segment name
+    QString segment = filename;
+    for (int i = 2; QFileInfo::exists(segment) && QFileInfo(segment).size() > 0; ++i) {
+        if (!terminateLog(segment))
+            qWarning() << "Could not make log file" << segment << "well-formed";
+        segment = stem + QChar('.') + QString::number(i) + suffix;
+    }
+    return segment;
+}
+
+bool LogCollector::terminateLog(const QString &filename)
+{
+    static const QByteArray logEnd("</log>");
+    static const QByteArray logItemEnd("</logitem>\n");
+    static const QByteArray logStart("<log ");
+
+    QFile file(filename);
+    if (!file.open(QFile::ReadWrite)) return false;
+    const qint64 size = file.size();
+
+    /// Nothing to do if log has been closed properly
+    file.seek(qMax(Q_INT64_C(0), size - 128));
+    if (file.read(128).contains(logEnd)) return true;
+
+    /// Search backwards for the end of the last complete log item
+    static const qint64 chunkSize = 1 << 20;
+    qint64 cut = -1;
+    for (qint64 pos = size; pos > 0 && cut < 0;) {
+        const qint64 start = qMax(Q_INT64_C(0), pos - chunkSize);
+        file.seek(start);
+        /// Overlap chunks so that markers crossing chunk borders are found
+        const QByteArray chunk = file.read(pos - start + logItemEnd.length());
+        const int p = chunk.lastIndexOf(logItemEnd);
+        if (p >= 0)
+            cut = start + p + logItemEnd.length();
+        pos = start;
+    }
+    if (cut < 0) {
+        /// No complete log item at all, keep just the header if present
+        file.seek(0);
+        const QByteArray head = file.read(1024);
+        const int p = head.indexOf(logStart);
+        const int eol = p >= 0 ? head.indexOf('\n', p) : -1;
+        if (eol < 0) {
+            file.resize(0);
+            file.seek(0);
+            file.write(QByteArrayLiteral("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n<log>\n"));
+            cut = file.pos();
+        } else
+            cut = eol + 1;
+    }
+
+    file.resize(cut);
+    file.seek(cut);
+    file.write(QString(QStringLiteral("</log>\n<!-- %1 terminated for resumed run -->\n")).arg(QDateTime::currentDateTimeUtc().toString(Qt::ISODate)).toUtf8());
+    file.close();
+    qDebug() << "Terminated log of previous run" << filename << "after" << cut << "bytes";
+    return true;
 }
 
 void LogCollector::close()
 {
+    commitJournal();
+
     m_ts << "</log>" << endl << "<!-- " << QDateTime::currentDateTimeUtc().toString(Qt::ISODate) << " -->" << endl;
     m_ts.flush();
     m_output->close();
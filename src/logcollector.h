@@ -27,10 +27,13 @@
 #include <QTextStream>
 #include <QRegExp>
 #include <QTextStream>
+#include <QHash>
 
 #include "watchable.h"
 
 class QIODevice;
+class QTimer;
+class Journal;
 
 /**
  * Collecting log messages from various sources and
@@ -52,6 +55,27 @@ public:
 
     virtual bool isAlive();
 
+    /**
+     * Record every file whose analysis report has been logged in a
+     * journal. Reports are flushed to disk before the journal entries
+     * get committed, in groups of several files.
+     *
+     * @param journal journal to record completed files in; ownership stays with the caller
+     */
+    void setJournal(Journal *journal);
+
+    /**
+     * Prepare writing a log for a resumed run. Existing log files
+     * of previous runs are made well-formed by cutting off any
+     * incomplete log item and closing the log. As the output of
+     * previous runs is kept, the log will continue in a new segment
+     * file, e.g. 'log.2.xml' after 'log.xml'.
+     *
+     * @param filename log file as configured
+     * @return name of the file to write the new log segment to
+     */
+    static QString prepareResumedLog(const QString &filename);
+
 public slots:
     /**
      * Receive incomming log messages and store them in the output device
@@ -66,10 +90,20 @@ public slots:
      */
     void close();
 
+private slots:
+    void commitJournal();
+
 private:
     QTextStream m_ts;
     QIODevice *m_output;
     QRegExp m_tagStart;
+    Journal *m_journal;
+    QTimer *m_journalTimer;
+    /// Uncompressed temporary files mapped to their original files
+    QHash<QString, QString> m_uncompressedOrigin;
+
+    void journalReport(const QString &message);
+    static bool terminateLog(const QString &filename);
 };
 
 #endif // LOGCOLLECTOR_H
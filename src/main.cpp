@@ -35,6 +35,15 @@
 #include "urldownloader.h"
 #include "filesystemscan.h"
 #include "fileanalyzermultiplexer.h"
+#include "fileanalyzerworkerpool.h"
+#include "validatorscheduler.h"
+#include "aspellpool.h"
+#include "textanalysis.h"
+#include "analysiscache.h"
+#include "textstore.h"
+#include "journal.h"
+#include "popplerwrapper.h"
+#include "stagetiming.h"
 #include "watchdog.h"
 #include "webcrawler.h"
 #include "logcollector.h"
@@ -49,10 +58,19 @@ LogCollector *logCollector;
 FileAnalyzerAbstract *fileAnalyzer;
 static const int defaultNumHits = 25000;
 int numHits, webcrawlermaxvisitedpages;
+int finderCredits;
+int analysisThreads, analysisQueueSize;
 QString jhoveShellscript;
 QString veraPDFcliTool;
 QString pdfboxValidatorJavaClass;
 QString callasPdfAPilotCLI;
+FileAnalyzerPDF::Depth pdfDepth;
+FileAnalyzerPDF::ValidatorPolicy pdfValidatorPolicy;
+int pdfWorkerTimeout, pdfWorkerCpuLimit, pdfWorkerMemoryLimit;
+QString journalFilename;
+bool resumeRun;
+QString timingCsvFilename;
+int timingCsvInterval;
 FileAnalyzerAbstract::TextExtraction textExtraction;
 
 bool evaluateConfigfile(const QString &filename)
@@ -87,6 +105,56 @@ bool evaluateConfigfile(const QString &filename)
                         textExtraction = FileAnalyzerAbstract::teAspell;
                     else
                         qWarning() << "Invalid value for \"textExtraction\":" << value;
+                } else if (key == QStringLiteral("textextraction:pagelimit")) {
+                    bool ok = false;
+                    const int pageLimit = value.toInt(&ok);
+                    if (ok && pageLimit > 0) {
+                        PopplerWrapper::setPageLogLimit(pageLimit);
+                        qDebug() << "textextraction:pagelimit =" << pageLimit;
+                    } else
+                        qWarning() << "Invalid value for textextraction:pagelimit:" << value;
+                } else if (key == QStringLiteral("textextraction:images")) {
+                    if (value.compare(QStringLiteral("rendering"), Qt::CaseInsensitive) == 0)
+                        PopplerWrapper::setImageInventory(PopplerWrapper::iiRendering);
+                    else if (value.compare(QStringLiteral("resources"), Qt::CaseInsensitive) == 0)
+                        PopplerWrapper::setImageInventory(PopplerWrapper::iiResources);
+                    else
+                        qWarning() << "Invalid value for textextraction:images:" << value;
+                    qDebug() << "textextraction:images =" << value;
+                } else if (key == QStringLiteral("textextraction:language")) {
+                    if (value.compare(QStringLiteral("ngram"), Qt::CaseInsensitive) == 0)
+                        FileAnalyzerAbstract::setLanguageIdentification(FileAnalyzerAbstract::liNGram, FileAnalyzerAbstract::minLanguageConfidence());
+                    else if (value.compare(QStringLiteral("aspell"), Qt::CaseInsensitive) == 0)
+                        FileAnalyzerAbstract::setLanguageIdentification(FileAnalyzerAbstract::liAspell, FileAnalyzerAbstract::minLanguageConfidence());
+                    else if (value.compare(QStringLiteral("fallback"), Qt::CaseInsensitive) == 0)
+                        FileAnalyzerAbstract::setLanguageIdentification(FileAnalyzerAbstract::liFallback, FileAnalyzerAbstract::minLanguageConfidence());
+                    else
+                        qWarning() << "Invalid value for textextraction:language:" << value;
+                    qDebug() << "textextraction:language =" << value;
+                } else if (key == QStringLiteral("textextraction:languageconfidence")) {
+                    bool ok = false;
+                    const double minConfidence = value.toDouble(&ok);
+                    if (ok && minConfidence >= 0.0 && minConfidence <= 1.0) {
+                        FileAnalyzerAbstract::setLanguageIdentification(FileAnalyzerAbstract::languageIdentification(), minConfidence);
+                        qDebug() << "textextraction:languageconfidence =" << minConfidence;
+                    } else
+                        qWarning() << "Invalid value for textextraction:languageconfidence:" << value;
+                } else if (key == QStringLiteral("textextraction:threads")) {
+                    bool ok = false;
+                    const int numThreads = value.toInt(&ok);
+                    if (ok && numThreads > 0) {
+                        PopplerWrapper::setTextExtractionThreads(numThreads);
+                        qDebug() << "textextraction:threads =" << numThreads;
+                    } else
+                        qWarning() << "Invalid value for textextraction:threads:" << value;
+                } else if (key == QStringLiteral("textanalysis:threads")) {
+                    bool ok = false;
+                    const int numThreads = value.toInt(&ok);
+                    if (ok && numThreads > 0) {
+                        TextAnalysis::instance()->setMaxThreads(numThreads);
+                        qDebug() << "textanalysis:threads =" << numThreads;
+                    } else
+                        qWarning() << "Invalid value for textanalysis:threads:" << value;
                 } else if (key == QStringLiteral("requiredcontent")) {
                     requiredContent = QRegExp(value);
                     qDebug() << "requiredContent =" << requiredContent.pattern();
@@ -108,6 +176,24 @@ bool evaluateConfigfile(const QString &filename)
                     const QFileInfo javaClass(pdfboxValidatorJavaClass);
                     if (pdfboxValidatorJavaClass.isEmpty() || !javaClass.exists() || javaClass.isExecutable())
                         qCritical() << "Value for pdfboxValidatorJavaClass does not refer to an non-existing xor executable file";
+                } else if (key == QStringLiteral("pdfdepth")) {
+                    if (value.compare(QStringLiteral("metadata"), Qt::CaseInsensitive) == 0)
+                        pdfDepth = FileAnalyzerPDF::dMetadata;
+                    else if (value.compare(QStringLiteral("fonts"), Qt::CaseInsensitive) == 0)
+                        pdfDepth = FileAnalyzerPDF::dFonts;
+                    else if (value.compare(QStringLiteral("full"), Qt::CaseInsensitive) == 0)
+                        pdfDepth = FileAnalyzerPDF::dFull;
+                    else
+                        qWarning() << "Invalid value for \"pdfdepth\":" << value;
+                    qDebug() << "pdfdepth =" << pdfDepth;
+                } else if (key == QStringLiteral("validators:policy")) {
+                    if (value.compare(QStringLiteral("all"), Qt::CaseInsensitive) == 0)
+                        pdfValidatorPolicy = FileAnalyzerPDF::vpRunAll;
+                    else if (value.compare(QStringLiteral("costaware"), Qt::CaseInsensitive) == 0)
+                        pdfValidatorPolicy = FileAnalyzerPDF::vpCostAware;
+                    else
+                        qWarning() << "Invalid value for \"validators:policy\":" << value;
+                    qDebug() << "validators:policy =" << pdfValidatorPolicy;
                 } else if (key == QStringLiteral("callaspdfapilot")) {
                     callasPdfAPilotCLI = value;
                     qDebug() << "callaspdfapilot = " << callasPdfAPilotCLI;
@@ -169,9 +255,25 @@ bool evaluateConfigfile(const QString &filename)
                 } else if (key == QStringLiteral("fakedownloader") && downloader == nullptr) {
                     /// Deprecated setting key. If no other downloader is configured,
                     /// a FakeDownloader instance will be automatically created and used.
+                } else if (key == QStringLiteral("journal")) {
+                    journalFilename = value;
+                    qDebug() << "journal =" << journalFilename;
+                } else if (key == QStringLiteral("journal:resume")) {
+                    resumeRun = value == QStringLiteral("true") || value == QStringLiteral("yes") || value == QStringLiteral("1");
+                    qDebug() << "journal:resume =" << resumeRun;
+                } else if (key == QStringLiteral("timing:csv")) {
+                    timingCsvFilename = value;
+                    qDebug() << "timing:csv =" << timingCsvFilename;
+                } else if (key == QStringLiteral("timing:csvinterval")) {
+                    bool ok = false;
+                    timingCsvInterval = value.toInt(&ok);
+                    if (!ok || timingCsvInterval <= 0) timingCsvInterval = 60;
+                    qDebug() << "timing:csvinterval =" << timingCsvInterval;
                 } else if (key == QStringLiteral("logcollector") && logCollector == nullptr) {
-                    qDebug() << "logcollector =" << value;
-                    QFile *logOutput = new QFile(value);
+                    /// Logs of previous runs are kept and continued in a new file
+                    const QString logFilename = resumeRun ? LogCollector::prepareResumedLog(value) : value;
+                    qDebug() << "logcollector =" << logFilename;
+                    QFile *logOutput = new QFile(logFilename);
                     logOutput->open(QFile::WriteOnly);
                     logCollector = new LogCollector(logOutput);
                 } else if (key == QStringLiteral("finder:numhits")) {
@@ -179,12 +281,119 @@ bool evaluateConfigfile(const QString &filename)
                     numHits = value.toInt(&ok);
                     if (!ok || numHits <= 0) numHits = defaultNumHits;
                     qDebug() << "finder:numhits =" << numHits;
+                } else if (key == QStringLiteral("finder:credits")) {
+                    bool ok = false;
+                    finderCredits = value.toInt(&ok);
+                    if (!ok || finderCredits < 0) finderCredits = 0;
+                    qDebug() << "finder:credits =" << finderCredits;
+                } else if (key == QStringLiteral("fileanalyzer:threads")) {
+                    bool ok = false;
+                    analysisThreads = value.toInt(&ok);
+                    if (!ok || analysisThreads < 0) analysisThreads = 1;
+                    qDebug() << "fileanalyzer:threads =" << analysisThreads;
+                } else if (key == QStringLiteral("fileanalyzer:maxuncompressedsize")) {
+                    bool ok = false;
+                    const qint64 maxSizeMiB = value.toLongLong(&ok);
+                    if (ok && maxSizeMiB > 0) {
+                        /// Bounded before converting to bytes to avoid overflows
+                        FileAnalyzerMultiplexer::setMaxUncompressedSize(qMin(maxSizeMiB, Q_INT64_C(2047)) * 1024 * 1024);
+                        qDebug() << "fileanalyzer:maxuncompressedsize =" << FileAnalyzerMultiplexer::maxUncompressedSize() / 1024 / 1024;
+                    } else
+                        qWarning() << "Invalid value for fileanalyzer:maxuncompressedsize:" << value;
+                } else if (key == QStringLiteral("fileanalyzer:queuesize")) {
+                    bool ok = false;
+                    analysisQueueSize = value.toInt(&ok);
+                    if (!ok || analysisQueueSize < 0) analysisQueueSize = 0;
+                    qDebug() << "fileanalyzer:queuesize =" << analysisQueueSize;
+                } else if (key == QStringLiteral("verapdf:maxprocesses") || key == QStringLiteral("callaspdfapilot:maxprocesses") || key == QStringLiteral("jhove:maxprocesses") || key == QStringLiteral("pdfboxvalidator:maxprocesses") || key == QStringLiteral("pdfworker:maxprocesses")) {
+                    bool ok = false;
+                    const int maxProcesses = value.toInt(&ok);
+                    if (ok && maxProcesses > 0) {
+                        const QString tool = key.left(key.indexOf(QChar(':')));
+                        const ValidatorScheduler::Tool schedulerTool = tool == QStringLiteral("verapdf") ? ValidatorScheduler::VeraPDF : (tool == QStringLiteral("callaspdfapilot") ? ValidatorScheduler::CallasPdfAPilot : (tool == QStringLiteral("jhove") ? ValidatorScheduler::JHove : (tool == QStringLiteral("pdfworker") ? ValidatorScheduler::PopplerWorker : ValidatorScheduler::PdfBoxValidator)));
+                        ValidatorScheduler::instance()->setMaxProcesses(schedulerTool, maxProcesses);
+                        qDebug() << key << "=" << maxProcesses;
+                    } else
+                        qWarning() << "Invalid value for" << key << ":" << value;
+                } else if (key == QStringLiteral("pdfworker:timeout")) {
+                    bool ok = false;
+                    pdfWorkerTimeout = value.toInt(&ok);
+                    if (!ok || pdfWorkerTimeout < 0) pdfWorkerTimeout = 0;
+                    qDebug() << "pdfworker:timeout =" << pdfWorkerTimeout;
+                } else if (key == QStringLiteral("pdfworker:cpulimit")) {
+                    bool ok = false;
+                    pdfWorkerCpuLimit = value.toInt(&ok);
+                    if (!ok || pdfWorkerCpuLimit < 0) pdfWorkerCpuLimit = 0;
+                    qDebug() << "pdfworker:cpulimit =" << pdfWorkerCpuLimit;
+                } else if (key == QStringLiteral("pdfworker:memorylimit")) {
+                    bool ok = false;
+                    pdfWorkerMemoryLimit = value.toInt(&ok);
+                    if (!ok || pdfWorkerMemoryLimit < 0) pdfWorkerMemoryLimit = 0;
+                    qDebug() << "pdfworker:memorylimit =" << pdfWorkerMemoryLimit;
+                } else if (key == QStringLiteral("pdfboxvalidator:server")) {
+                    const bool enabled = value == QStringLiteral("true") || value == QStringLiteral("yes") || value == QStringLiteral("1");
+                    ValidatorScheduler::instance()->setServerMode(ValidatorScheduler::PdfBoxValidator, enabled);
+                    qDebug() << "pdfboxvalidator:server =" << enabled;
+                } else if (key == QStringLiteral("verapdf:batch") || key == QStringLiteral("jhove:batch")) {
+                    /// Format: number of files per batch, optionally followed by waiting time in milliseconds
+                    const QStringList values = value.split(QLatin1Char(','), QString::SkipEmptyParts);
+                    bool ok1 = false, ok2 = true;
+                    const int maxFiles = values.isEmpty() ? 0 : values[0].trimmed().toInt(&ok1);
+                    const int maxWait = values.count() > 1 ? values[1].trimmed().toInt(&ok2) : 2000;
+                    if (ok1 && ok2 && maxFiles > 0 && maxWait >= 0) {
+                        if (key == QStringLiteral("verapdf:batch"))
+                            FileAnalyzerPDF::setupVeraPDFBatching(maxFiles, maxWait);
+                        else
+                            FileAnalyzerPDF::setupJhoveBatching(maxFiles, maxWait);
+                        qDebug() << key << "=" << maxFiles << "files," << maxWait << "ms";
+                    } else
+                        qWarning() << "Invalid value for" << key << ":" << value;
+                } else if (key == QStringLiteral("validators:serverrecycling")) {
+                    /// Format: number of requests, optionally followed by memory limit in MiB
+                    const QStringList values = value.split(QLatin1Char(','), QString::SkipEmptyParts);
+                    bool ok1 = false, ok2 = true;
+                    const int maxRequests = values.isEmpty() ? 0 : values[0].trimmed().toInt(&ok1);
+                    const int maxMemoryMiB = values.count() > 1 ? values[1].trimmed().toInt(&ok2) : 0;
+                    if (ok1 && ok2 && maxRequests > 0 && maxMemoryMiB >= 0) {
+                        ValidatorScheduler::instance()->setServerRecycling(maxRequests, maxMemoryMiB);
+                        qDebug() << "validators:serverrecycling =" << maxRequests << "requests," << maxMemoryMiB << "MiB";
+                    } else
+                        qWarning() << "Invalid value for validators:serverrecycling:" << value;
+                } else if (key == QStringLiteral("cache:directory")) {
+                    AnalysisCache::instance()->setDirectory(value);
+                    qDebug() << "cache:directory =" << value;
+                } else if (key == QStringLiteral("textstore")) {
+                    if (TextStore::instance()->setFilename(value))
+                        qDebug() << "textstore =" << value;
+                } else if (key == QStringLiteral("validators:maxpendingfiles")) {
+                    bool ok = false;
+                    const int maxPendingFiles = value.toInt(&ok);
+                    if (ok && maxPendingFiles > 0) {
+                        ValidatorScheduler::instance()->setMaxPendingJobs(maxPendingFiles);
+                        qDebug() << "validators:maxpendingfiles =" << maxPendingFiles;
+                    } else
+                        qWarning() << "Invalid value for validators:maxpendingfiles:" << value;
+                } else if (key == QStringLiteral("validators:maxoutput")) {
+                    /// Given in KiB
+                    bool ok = false;
+                    const int maxOutputKiB = value.toInt(&ok);
+                    if (ok && maxOutputKiB >= 0 && maxOutputKiB <= 1048576) {
+                        ValidatorScheduler::instance()->setMaxOutputSize(maxOutputKiB * 1024);
+                        qDebug() << "validators:maxoutput =" << maxOutputKiB << "KiB";
+                    } else
+                        qWarning() << "Invalid value for validators:maxoutput:" << value;
                 } else if (key == QStringLiteral("fileanalyzer")) {
                     if (value.contains(QStringLiteral("multiplexer"))) {
                         if (filter.isEmpty())
                             qWarning() << "Attempting to create a FileAnalyzerMultiplexer with empty filter";
-                        fileAnalyzer = new FileAnalyzerMultiplexer(filter);
-                        qDebug() << "fileanalyzer = FileAnalyzerMultiplexer";
+                        if (analysisThreads != 1) {
+                            /// Value 0 means: use as many workers as there are CPU cores
+                            fileAnalyzer = new FileAnalyzerWorkerPool(filter, analysisThreads, analysisQueueSize);
+                            qDebug() << "fileanalyzer = FileAnalyzerWorkerPool with" << static_cast<FileAnalyzerWorkerPool *>(fileAnalyzer)->numWorkers() << "workers";
+                        } else {
+                            fileAnalyzer = new FileAnalyzerMultiplexer(filter);
+                            qDebug() << "fileanalyzer = FileAnalyzerMultiplexer";
+                        }
 #ifdef HAVE_QUAZIP5
                     } else if (value.contains(QStringLiteral("odf"))) {
                         fileAnalyzer = new FileAnalyzerODF();
@@ -245,6 +454,10 @@ int main(int argc, char *argv[])
     qInstallMessageHandler(myMessageOutput);
     QCoreApplication a(argc, argv);
 
+    /// Started by FileAnalyzerPDF to analyze files in a separate process
+    if (argc > 1 && qstrcmp(argv[1], FileAnalyzerPDF::workerArgument) == 0)
+        return FileAnalyzerPDF::runWorker(a.arguments().mid(2));
+
     netAccMan = new NetworkAccessManager(&a);
     fileAnalyzer = nullptr;
     logCollector = nullptr;
@@ -252,7 +465,15 @@ int main(int argc, char *argv[])
     finder = nullptr;
     numHits = defaultNumHits;
     webcrawlermaxvisitedpages = 0;
+    finderCredits = 0;
+    resumeRun = false;
+    timingCsvInterval = 60;
+    analysisThreads = 1;
+    analysisQueueSize = 0;
     textExtraction = FileAnalyzerAbstract::teNone;
+    pdfDepth = FileAnalyzerPDF::dFull;
+    pdfValidatorPolicy = FileAnalyzerPDF::vpRunAll;
+    pdfWorkerTimeout = pdfWorkerCpuLimit = pdfWorkerMemoryLimit = 0;
 
     if (argc != 2) {
         fprintf(stderr, "Require single configuration file as parameter\n");
@@ -271,6 +492,14 @@ int main(int argc, char *argv[])
             downloader = new FakeDownloader(netAccMan);
         }
 
+        Journal *journal = nullptr;
+        if (!journalFilename.isEmpty()) {
+            journal = new Journal(journalFilename, resumeRun);
+            logCollector->setJournal(journal);
+            if (finder != nullptr) finder->setCompletedFiles(journal->completedFiles());
+        } else if (resumeRun)
+            qWarning() << "Cannot resume without a journal";
+
         WatchDog watchDog;
         if (fileAnalyzer != nullptr) {
             watchDog.addWatchable(fileAnalyzer);
@@ -288,6 +517,10 @@ int main(int argc, char *argv[])
                 FileAnalyzerMultiplexer *fileAnalyzerMultiplexer = qobject_cast<FileAnalyzerMultiplexer *>(fileAnalyzer);
                 if (fileAnalyzerMultiplexer != nullptr) {
                     fileAnalyzerMultiplexer->setupJhove(jhoveShellscript);
+                } else {
+                    FileAnalyzerWorkerPool *fileAnalyzerWorkerPool = qobject_cast<FileAnalyzerWorkerPool *>(fileAnalyzer);
+                    if (fileAnalyzerWorkerPool != nullptr)
+                        fileAnalyzerWorkerPool->setupJhove(jhoveShellscript);
                 }
             }
         }
@@ -300,6 +533,10 @@ int main(int argc, char *argv[])
                 FileAnalyzerMultiplexer *fileAnalyzerMultiplexer = qobject_cast<FileAnalyzerMultiplexer *>(fileAnalyzer);
                 if (fileAnalyzerMultiplexer != nullptr) {
                     fileAnalyzerMultiplexer->setupVeraPDF(veraPDFcliTool);
+                } else {
+                    FileAnalyzerWorkerPool *fileAnalyzerWorkerPool = qobject_cast<FileAnalyzerWorkerPool *>(fileAnalyzer);
+                    if (fileAnalyzerWorkerPool != nullptr)
+                        fileAnalyzerWorkerPool->setupVeraPDF(veraPDFcliTool);
                 }
             }
         }
@@ -312,6 +549,10 @@ int main(int argc, char *argv[])
                 FileAnalyzerMultiplexer *fileAnalyzerMultiplexer = qobject_cast<FileAnalyzerMultiplexer *>(fileAnalyzer);
                 if (fileAnalyzerMultiplexer != nullptr) {
                     fileAnalyzerMultiplexer->setupPdfBoXValidator(pdfboxValidatorJavaClass);
+                } else {
+                    FileAnalyzerWorkerPool *fileAnalyzerWorkerPool = qobject_cast<FileAnalyzerWorkerPool *>(fileAnalyzer);
+                    if (fileAnalyzerWorkerPool != nullptr)
+                        fileAnalyzerWorkerPool->setupPdfBoXValidator(pdfboxValidatorJavaClass);
                 }
             }
         }
@@ -324,23 +565,113 @@ int main(int argc, char *argv[])
                 FileAnalyzerMultiplexer *fileAnalyzerMultiplexer = qobject_cast<FileAnalyzerMultiplexer *>(fileAnalyzer);
                 if (fileAnalyzerMultiplexer != nullptr) {
                     fileAnalyzerMultiplexer->setupCallasPdfAPilotCLI(callasPdfAPilotCLI);
+                } else {
+                    FileAnalyzerWorkerPool *fileAnalyzerWorkerPool = qobject_cast<FileAnalyzerWorkerPool *>(fileAnalyzer);
+                    if (fileAnalyzerWorkerPool != nullptr)
+                        fileAnalyzerWorkerPool->setupCallasPdfAPilotCLI(callasPdfAPilotCLI);
+                }
+            }
+        }
+
+        if (pdfDepth != FileAnalyzerPDF::dFull) {
+            FileAnalyzerPDF *fileAnalyzerPDF = qobject_cast<FileAnalyzerPDF *>(fileAnalyzer);
+            if (fileAnalyzerPDF != nullptr) {
+                fileAnalyzerPDF->setDepth(pdfDepth);
+            } else {
+                FileAnalyzerMultiplexer *fileAnalyzerMultiplexer = qobject_cast<FileAnalyzerMultiplexer *>(fileAnalyzer);
+                if (fileAnalyzerMultiplexer != nullptr) {
+                    fileAnalyzerMultiplexer->setPdfDepth(pdfDepth);
+                } else {
+                    FileAnalyzerWorkerPool *fileAnalyzerWorkerPool = qobject_cast<FileAnalyzerWorkerPool *>(fileAnalyzer);
+                    if (fileAnalyzerWorkerPool != nullptr)
+                        fileAnalyzerWorkerPool->setPdfDepth(pdfDepth);
+                }
+            }
+        }
+
+        if (pdfValidatorPolicy != FileAnalyzerPDF::vpRunAll) {
+            FileAnalyzerPDF *fileAnalyzerPDF = qobject_cast<FileAnalyzerPDF *>(fileAnalyzer);
+            if (fileAnalyzerPDF != nullptr) {
+                fileAnalyzerPDF->setValidatorPolicy(pdfValidatorPolicy);
+            } else {
+                FileAnalyzerMultiplexer *fileAnalyzerMultiplexer = qobject_cast<FileAnalyzerMultiplexer *>(fileAnalyzer);
+                if (fileAnalyzerMultiplexer != nullptr) {
+                    fileAnalyzerMultiplexer->setPdfValidatorPolicy(pdfValidatorPolicy);
+                } else {
+                    FileAnalyzerWorkerPool *fileAnalyzerWorkerPool = qobject_cast<FileAnalyzerWorkerPool *>(fileAnalyzer);
+                    if (fileAnalyzerWorkerPool != nullptr)
+                        fileAnalyzerWorkerPool->setPdfValidatorPolicy(pdfValidatorPolicy);
+                }
+            }
+        }
+
+        if (pdfWorkerTimeout > 0) {
+            /// Time limit is configured in seconds
+            FileAnalyzerPDF *fileAnalyzerPDF = qobject_cast<FileAnalyzerPDF *>(fileAnalyzer);
+            if (fileAnalyzerPDF != nullptr) {
+                fileAnalyzerPDF->setupPopplerWorker(pdfWorkerTimeout * 1000, pdfWorkerCpuLimit, pdfWorkerMemoryLimit);
+            } else {
+                FileAnalyzerMultiplexer *fileAnalyzerMultiplexer = qobject_cast<FileAnalyzerMultiplexer *>(fileAnalyzer);
+                if (fileAnalyzerMultiplexer != nullptr) {
+                    fileAnalyzerMultiplexer->setupPopplerWorker(pdfWorkerTimeout * 1000, pdfWorkerCpuLimit, pdfWorkerMemoryLimit);
+                } else {
+                    FileAnalyzerWorkerPool *fileAnalyzerWorkerPool = qobject_cast<FileAnalyzerWorkerPool *>(fileAnalyzer);
+                    if (fileAnalyzerWorkerPool != nullptr)
+                        fileAnalyzerWorkerPool->setupPopplerWorker(pdfWorkerTimeout * 1000, pdfWorkerCpuLimit, pdfWorkerMemoryLimit);
                 }
             }
         }
 
         if (downloader != nullptr && finder != nullptr) QObject::connect(finder, SIGNAL(foundUrl(QUrl)), downloader, SLOT(download(QUrl)));
-        if (downloader != nullptr && fileAnalyzer != nullptr) QObject::connect(downloader, SIGNAL(downloaded(QString)), fileAnalyzer, SLOT(analyzeFile(QString)));
-        QObject::connect(&watchDog, SIGNAL(quit()), &a, SLOT(quit()));
+        if (downloader != nullptr && fileAnalyzer != nullptr) {
+            if (qobject_cast<UrlDownloader *>(downloader) != nullptr)
+                /// Analyze downloads straight from memory, no need to read them back from disk
+                QObject::connect(downloader, SIGNAL(downloaded(QString, QByteArray)), fileAnalyzer, SLOT(analyzeData(QString, QByteArray)));
+            else
+                QObject::connect(downloader, SIGNAL(downloaded(QString)), fileAnalyzer, SLOT(analyzeFile(QString)));
+        }
+        /// Queued, as the pipeline may get drained even before the event loop is running
+        QObject::connect(&watchDog, SIGNAL(quit()), &a, SLOT(quit()), Qt::QueuedConnection);
         if (downloader != nullptr) QObject::connect(downloader, SIGNAL(report(QString)), logCollector, SLOT(receiveLog(const QString &)));
         if (fileAnalyzer != nullptr) QObject::connect(fileAnalyzer, SIGNAL(analysisReport(QString)), logCollector, SLOT(receiveLog(const QString &)));
         if (finder != nullptr) QObject::connect(finder, SIGNAL(report(QString)), logCollector, SLOT(receiveLog(const QString &)));
         if (downloader != nullptr) QObject::connect(&watchDog, SIGNAL(firstWarning()), downloader, SLOT(finalReport()));
         QObject::connect(&watchDog, SIGNAL(lastWarning()), logCollector, SLOT(close()));
+        /// Timing summary gets logged after all stages reported, but before the log is closed
+        QObject::connect(StageTiming::instance(), SIGNAL(report(QString)), logCollector, SLOT(receiveLog(const QString &)));
+        QObject::connect(&watchDog, SIGNAL(firstWarning()), StageTiming::instance(), SLOT(finalReport()));
+        if (!timingCsvFilename.isEmpty()) StageTiming::instance()->setCsvOutput(timingCsvFilename, timingCsvInterval);
+        if (qobject_cast<FileAnalyzerWorkerPool *>(fileAnalyzer) != nullptr)
+            QObject::connect(&a, SIGNAL(aboutToQuit()), fileAnalyzer, SLOT(shutdown()));
+        /// Stop the validator scheduler only after all analysis threads have finished
+        QObject::connect(&a, SIGNAL(aboutToQuit()), ValidatorScheduler::instance(), SLOT(shutdown()), Qt::DirectConnection);
+        QObject::connect(&a, SIGNAL(aboutToQuit()), AspellPool::instance(), SLOT(shutdown()), Qt::DirectConnection);
+
+        if (finderCredits > 0 && finder != nullptr && downloader != nullptr && fileAnalyzer != nullptr) {
+            /// Credits flow back from the file analyzer via the downloader to the finder
+            finder->setFlowControl(finderCredits);
+            QObject::connect(fileAnalyzer, SIGNAL(creditsGranted(int)), downloader, SLOT(grantCredits(int)));
+            QObject::connect(downloader, SIGNAL(creditsGranted(int)), finder, SLOT(grantCredits(int)));
+        }
+
+        /// If every stage can tell when it has processed all its work items,
+        /// quit as soon as the file analyzer is drained instead of waiting
+        /// for the watch dog to notice that nothing is alive anymore
+        const bool drainTracking = downloader != nullptr && fileAnalyzer != nullptr && (finder == nullptr || finder->reportsDrained());
+        if (drainTracking) {
+            if (finder != nullptr) QObject::connect(finder, SIGNAL(drained()), downloader, SLOT(upstreamDrained()));
+            QObject::connect(downloader, SIGNAL(drained()), fileAnalyzer, SLOT(upstreamDrained()));
+            QObject::connect(fileAnalyzer, SIGNAL(drained()), &watchDog, SLOT(pipelineDrained()));
+            watchDog.setDrainTracking(true);
+        }
 
         if (finder != nullptr) finder->startSearch(numHits);
+        else if (drainTracking) downloader->upstreamDrained(); ///< downloader is its own source of urls
 
         qDebug() << "activeThreadCount" << QThreadPool::globalInstance()->activeThreadCount() << "   maxThreadCount" << QThreadPool::globalInstance()->maxThreadCount();
 
-        return a.exec();
+        const int exitCode = a.exec();
+        delete journal;
+        return exitCode;
     }
 }
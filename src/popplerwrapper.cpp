@@ -30,26 +30,137 @@
 #include <poppler/cpp/poppler-document.h>
 #include <poppler/cpp/poppler-font.h>
 #include <poppler/cpp/poppler-page.h>
+#include <poppler/cpp/poppler-version.h>
 #include <poppler/GfxState.h>
 
 #include "PDFDoc.h"
 #include "PDFDocFactory.h"
+#include "Stream.h"
+#include "Page.h"
+#include "Dict.h"
+#include "Array.h"
 
 #include <QStringList>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QAtomicInt>
 #include <QDebug>
 
 #include "general.h"
 
+int PopplerWrapper::s_pageLogLimit = 16;
+PopplerWrapper::ImageInventory PopplerWrapper::s_imageInventory = PopplerWrapper::iiRendering;
+int PopplerWrapper::s_textExtractionThreads = QThread::idealThreadCount();
+
+/// Number of characters after which no further pages get extracted
+static const int textBudget = 16384;
+
+/**
+ * Pages of one document whose text is extracted by several
+ * threads. Threads claim pages in ascending order until all
+ * pages are claimed or enough text has been extracted, so that
+ * the extracted pages always form a contiguous range from the
+ * first page on.
+ */
+struct TextExtractionState {
+    int numPages;
+    QAtomicInt nextPage, numCharacters;
+    std::vector<poppler::ustring> texts;
+    /// One flag per page, as each page is written by a different thread
+    std::vector<char> extracted;
+    QSemaphore finishedTasks;
+
+    explicit TextExtractionState(int numPages)
+        : numPages(numPages), nextPage(0), numCharacters(0), texts(numPages), extracted(numPages, 0) {
+        /// nothing
+    }
+};
+
+static void extractPageTexts(poppler::document *document, TextExtractionState *state)
+{
+    while (state->numCharacters.load() < textBudget) {
+        const int index = state->nextPage.fetchAndAddOrdered(1);
+        if (index >= state->numPages) break;
+        const std::unique_ptr<poppler::page> page(document->create_page(index));
+        if (page)
+            state->texts[index] = page->text();
+        state->extracted[index] = 1;
+        state->numCharacters.fetchAndAddOrdered(static_cast<int>(state->texts[index].length()));
+    }
+}
+
+/**
+ * Extracts pages' text in a pool thread using its own instance
+ * of the document, as poppler documents must not be shared
+ * between threads.
+ */
+class TextExtractionTask : public QRunnable
+{
+public:
+    TextExtractionTask(const QString &filename, const QByteArray &data, TextExtractionState *state)
+        : m_filename(filename), m_data(data), m_state(state) {
+        /// nothing
+    }
+
+    void run() {
+        /// Others may have finished all work while this task was queued
+        if (m_state->nextPage.load() >= m_state->numPages || m_state->numCharacters.load() >= textBudget) {
+            m_state->finishedTasks.release();
+            return;
+        }
+
+        poppler::document *document = m_data.isNull() ? poppler::document::load_from_file(m_filename.toStdString()) : poppler::document::load_from_raw_data(m_data.constData(), m_data.size());
+        if (document != nullptr) {
+            extractPageTexts(document, m_state);
+            delete document;
+        }
+        m_state->finishedTasks.release();
+    }
+
+private:
+    const QString m_filename;
+    const QByteArray m_data;
+    TextExtractionState *m_state;
+};
+
+/// Shared by all wrappers, limiting the number of extraction threads process-wide
+static QThreadPool *textExtractionPool()
+{
+    static QThreadPool *pool = new QThreadPool();
+    return pool;
+}
+
+/**
+ * Page log's text element for a page's text.
+ */
+static QString pageTextToXML(const poppler::ustring &text, bool includeText)
+{
+    if (!includeText)
+        return QString(QStringLiteral("<text length=\"%1\" />\n")).arg(text.length());
+
+    const poppler::byte_array utf8 = text.to_utf8();
+    const QString cookedText = DocScan::xmlify(QString::fromUtf8(utf8.data(), static_cast<int>(utf8.size())).simplified());
+    if (!cookedText.isEmpty())
+        return QString(QStringLiteral("<text length=\"%1\">")).arg(text.length()).append(cookedText).append(QStringLiteral("</text>\n"));
+    else
+        return QString(QStringLiteral("<text length=\"%1\" />\n")).arg(text.length());
+}
+
 class ImageInfoOutputDev: public OutputDev
 {
 private:
     QString logText;
     int currentPage;
-    poppler::document *m_document;
+    const int lastPage;
+    const PopplerWrapper *m_wrapper;
+    const bool m_includeText;
 
 public:
-    ImageInfoOutputDev(poppler::document *document)
-        : currentPage(0), m_document(document) {
+    ImageInfoOutputDev(const PopplerWrapper *wrapper, int lastPage, bool includeText)
+        : currentPage(0), lastPage(lastPage), m_wrapper(wrapper), m_includeText(includeText) {
         /// nothing
     }
 
@@ -64,7 +175,7 @@ public:
 
     // Start a page.
     virtual void startPage(int pageNum, GfxState */*state*/, XRef */*xref*/) {
-        if (pageNum >= 0 && pageNum <= 16) {
+        if (pageNum >= 1 && pageNum <= lastPage) {
             logText.append(QString(QStringLiteral("<page number=\"%1\">\n")).arg(pageNum));
             currentPage = pageNum;
         } else
@@ -73,15 +184,9 @@ public:
 
     // End a page.
     virtual void endPage() {
-        if (currentPage >= 0 && currentPage <= 16) {
-            poppler::page *page = m_document->create_page(currentPage - 1);
-            if (page != nullptr) {
-                const QString cookedText = page != nullptr ? DocScan::xmlify(QString::fromUtf8(page->text().to_utf8().data()).simplified()) : QString();
-                if (!cookedText.isEmpty())
-                    logText.append(QString(QStringLiteral("<text length=\"%1\">")).arg(page->text().length())).append(cookedText).append(QStringLiteral("</text>\n"));
-                else
-                    logText.append(QString(QStringLiteral("<text length=\"%1\" />\n")).arg(page->text().length()));
-            }
+        if (currentPage >= 1 && currentPage <= lastPage) {
+            if (currentPage <= m_wrapper->numPages())
+                logText.append(pageTextToXML(m_wrapper->pageText(currentPage - 1), m_includeText));
 
             logText.append(QStringLiteral("</page>\n"));
         }
@@ -181,6 +286,118 @@ public:
 };
 
 
+#if POPPLER_VERSION_MAJOR > 0 || POPPLER_VERSION_MINOR >= 58
+/**
+ * Lists images by walking a page's XObject resources, including
+ * those of forms used on the page, without interpreting any
+ * content stream. Different from ImageInfoOutputDev, each image
+ * is listed once per page, no matter how often it is drawn,
+ * and neither inline images nor images used only in patterns
+ * or annotations are found.
+ */
+class ResourceImageLister
+{
+private:
+    QString &logText;
+    /// Objects already seen on the current page, also preventing cycles between forms
+    QSet<qint64> visitedObjects;
+
+    static QString imageType(Object &filter) {
+        if (filter.isName("DCTDecode") || filter.isName("DCT"))
+            return QStringLiteral("jpeg");
+        else if (filter.isName("JPXDecode"))
+            return QStringLiteral("jpx");
+        else if (filter.isName("CCITTFaxDecode") || filter.isName("CCF"))
+            return QStringLiteral("ccitt");
+        else if (filter.isName("JBIG2Decode"))
+            return QStringLiteral("jbig2");
+        return QString();
+    }
+
+    static int intValue(Dict *dict, const char *key, const char *abbreviation) {
+        Object value = dict->lookup(key);
+        if (!value.isNum())
+            value = dict->lookup(abbreviation);
+        return value.isNum() ? static_cast<int>(value.getNum()) : 0;
+    }
+
+    void listImage(Dict *dict, bool isMask) {
+        DocScan::XMLNode node;
+        node.name = QStringLiteral("img");
+
+        /// Decoding an image starts with the last filter
+        QString type;
+        Object filter = dict->lookup("Filter");
+        if (filter.isArray() && filter.arrayGetLength() > 0) {
+            Object lastFilter = filter.arrayGet(filter.arrayGetLength() - 1);
+            type = imageType(lastFilter);
+        } else
+            type = imageType(filter);
+        if (!type.isEmpty())
+            node.attributes.insert(QStringLiteral("type"), type);
+
+        node.attributes.insert(QStringLiteral("width"), QString::number(intValue(dict, "Width", "W")));
+        node.attributes.insert(QStringLiteral("height"), QString::number(intValue(dict, "Height", "H")));
+        /// Like for rendering, masks come without color map and thus without bits
+        Object imageMask = dict->lookup("ImageMask");
+        const int bits = intValue(dict, "BitsPerComponent", "BPC");
+        if (!isMask && !(imageMask.isBool() && imageMask.getBool()) && bits > 0)
+            node.attributes.insert(QStringLiteral("bits"), QString::number(bits));
+
+        logText.append(DocScan::xmlNodeToText(node));
+
+        Object softMask = dict->lookup("SMask");
+        if (softMask.isStream())
+            listImage(softMask.streamGetDict(), false);
+        Object mask = dict->lookup("Mask");
+        if (mask.isStream())
+            listImage(mask.streamGetDict(), true);
+    }
+
+    void listResources(Dict *resources) {
+        Object xObjects = resources->lookup("XObject");
+        if (!xObjects.isDict())
+            return;
+
+        Dict *xObjectDict = xObjects.getDict();
+        for (int i = 0; i < xObjectDict->getLength(); ++i) {
+            /// Depending on poppler's version, a reference or a temporary object is returned
+            Object reference = xObjectDict->getValNF(i).copy();
+            if (reference.isRef()) {
+                const Ref ref = reference.getRef();
+                const qint64 key = (static_cast<qint64>(ref.num) << 32) | static_cast<quint32>(ref.gen);
+                if (visitedObjects.contains(key)) continue;
+                visitedObjects.insert(key);
+            }
+
+            Object xObject = xObjectDict->getVal(i);
+            if (!xObject.isStream()) continue;
+            Dict *dict = xObject.streamGetDict();
+            Object subtype = dict->lookup("Subtype");
+            if (subtype.isName("Image"))
+                listImage(dict, false);
+            else if (subtype.isName("Form")) {
+                Object formResources = dict->lookup("Resources");
+                if (formResources.isDict())
+                    listResources(formResources.getDict());
+            }
+        }
+    }
+
+public:
+    explicit ResourceImageLister(QString &logText)
+        : logText(logText) {
+        /// nothing
+    }
+
+    void listPage(Page *page) {
+        visitedObjects.clear();
+        Dict *resources = page->getResourceDict();
+        if (resources != nullptr)
+            listResources(resources);
+    }
+};
+#endif // POPPLER_VERSION
 
 PopplerWrapper *PopplerWrapper::createPopplerWrapper(const QString &filename)
 {
@@ -191,77 +408,137 @@ PopplerWrapper *PopplerWrapper::createPopplerWrapper(const QString &filename)
     return new PopplerWrapper(document, filename);
 }
 
-PopplerWrapper::PopplerWrapper(poppler::document *document, const QString &filename)
-    : m_document(document), m_filename(filename)
+PopplerWrapper *PopplerWrapper::createPopplerWrapper(const QByteArray &data, const QString &filename)
+{
+    poppler::document *document = poppler::document::load_from_raw_data(data.constData(), data.size());
+    if (document == nullptr)
+        return nullptr;
+
+    return new PopplerWrapper(document, filename, data);
+}
+
+PopplerWrapper::PopplerWrapper(poppler::document *document, const QString &filename, const QByteArray &data)
+    : m_document(document), m_filename(filename), m_data(data), m_pdfDoc(nullptr)
 {
     Q_ASSERT(document != nullptr);
 }
 
 PopplerWrapper::~PopplerWrapper()
 {
+    /// Pages refer to their document, so release them first
+    m_pages.clear();
+    delete m_pdfDoc;
     delete m_document;
 }
 
+poppler::page *PopplerWrapper::page(int index) const
+{
+    if (index < 0 || index >= numPages())
+        return nullptr;
+
+    if (m_pages.empty())
+        m_pages.resize(numPages());
+    CachedPage &cachedPage = m_pages[index];
+    if (!cachedPage.page)
+        cachedPage.page.reset(m_document->create_page(index));
+    return cachedPage.page.get();
+}
+
+const poppler::ustring &PopplerWrapper::pageText(int index) const
+{
+    static const poppler::ustring emptyText;
+    if (index < 0 || index >= numPages())
+        return emptyText;
+
+    if (m_pages.empty())
+        m_pages.resize(numPages());
+    CachedPage &cachedPage = m_pages[index];
+    if (!cachedPage.hasText) {
+        /// Text may have been extracted without keeping the page
+        const poppler::page *p = page(index);
+        if (p != nullptr)
+            cachedPage.text = p->text();
+        cachedPage.hasText = true;
+    }
+    return cachedPage.text;
+}
+
 void PopplerWrapper::getPdfVersion(int &majorVersion, int &minorVersion) const
 {
     majorVersion = minorVersion = 0;
     m_document->get_pdf_version(&majorVersion, &minorVersion);
 }
 
-QStringList PopplerWrapper::fontNames() const
+QString PopplerWrapper::FontInfo::typeName() const
 {
-    QStringList result;
+    switch (type) {
+    case Type1: return QStringLiteral("Type1");
+    case Type1C: return QStringLiteral("Type1C");
+    case Type1COpenType: return QStringLiteral("Type1C (OpenType)");
+    case Type3: return QStringLiteral("Type3");
+    case TrueType: return QStringLiteral("TrueType");
+    case TrueTypeOpenType: return QStringLiteral("TrueType (OpenType)");
+    case CIDType0: return QStringLiteral("CIDType0");
+    case CIDType0C: return QStringLiteral("CIDType0C");
+    case CIDType0COpenType: return QStringLiteral("CIDType0C (OpenType)");
+    case CIDTrueType: return QStringLiteral("CIDTrueType");
+    case CIDTrueTypeOpenType: return QStringLiteral("CIDTrueType (OpenType)");
+    default: return QStringLiteral("unknown");
+    }
+}
+
+/**
+ * Remove a subset's prefix like 'ABCDEF+' from a font name.
+ */
+static QString withoutSubsetPrefix(const QString &fontName)
+{
+    const int p = fontName.indexOf(QLatin1Char('+'));
+    if (p < 1) return fontName;
+    for (int i = 0; i < p; ++i)
+        if ((fontName[i] < QLatin1Char('A') || fontName[i] > QLatin1Char('Z')) && (fontName[i] < QLatin1Char('a') || fontName[i] > QLatin1Char('z')))
+            return fontName;
+    return fontName.mid(p + 1);
+}
+
+static PopplerWrapper::FontInfo::Type fontType(poppler::font_info::type_enum type)
+{
+    switch (type) {
+    case poppler::font_info::type1: return PopplerWrapper::FontInfo::Type1;
+    case poppler::font_info::type1c: return PopplerWrapper::FontInfo::Type1C;
+    case poppler::font_info::type1c_ot: return PopplerWrapper::FontInfo::Type1COpenType;
+    case poppler::font_info::type3: return PopplerWrapper::FontInfo::Type3;
+    case poppler::font_info::truetype: return PopplerWrapper::FontInfo::TrueType;
+    case poppler::font_info::truetype_ot: return PopplerWrapper::FontInfo::TrueTypeOpenType;
+    case poppler::font_info::cid_type0: return PopplerWrapper::FontInfo::CIDType0;
+    case poppler::font_info::cid_type0c: return PopplerWrapper::FontInfo::CIDType0C;
+    case poppler::font_info::cid_type0c_ot: return PopplerWrapper::FontInfo::CIDType0COpenType;
+    case poppler::font_info::cid_truetype: return PopplerWrapper::FontInfo::CIDTrueType;
+    case poppler::font_info::cid_truetype_ot: return PopplerWrapper::FontInfo::CIDTrueTypeOpenType;
+    default: return PopplerWrapper::FontInfo::Unknown;
+    }
+}
+
+QVector<PopplerWrapper::FontInfo> PopplerWrapper::fonts() const
+{
+    QVector<FontInfo> result;
+    QSet<QString> knownFonts;
     poppler::font_iterator *it = m_document->create_font_iterator();
     while (it->has_next()) {
-        std::vector<poppler::font_info> fonts = it->next();
-        // do domething with the fonts
-        for (std::vector<poppler::font_info>::const_iterator fit = fonts.begin(); fit != fonts.end(); ++fit) {
-            QString fontType = QStringLiteral("???");
-            poppler::font_info fi = *fit;
-
-            /* FIXME
-            switch ((poppler::font_info::type_enum)fi.type){
-            case poppler::font_info::unknown:
-                fontType= QStringLiteral("unknown");
-                break;
-            case poppler::font_info::type1:
-                fontType= QStringLiteral("Type 1");
-                break;
-            case poppler::font_info::type1c:
-                fontType= QStringLiteral("Type 1C");
-                break;
-            case poppler::font_info::type3:
-                fontType= QStringLiteral("Type 3");
-                break;
-            case poppler::font_info::truetype:
-                fontType= QStringLiteral("TrueType");
-                break;
-            case poppler::font_info::cid_type0:
-                fontType= QStringLiteral("CID Type 0");
-                break;
-            case poppler::font_info::cid_type0c:
-                fontType= QStringLiteral("CID Type 0C");
-                break;
-            case poppler::font_info::cid_truetype:
-                fontType= QStringLiteral("CID TrueType");
-                break;
-            case poppler::font_info::type1c_ot:
-                fontType= QStringLiteral("Type 1C (OpenType)");
-                break;
-            case poppler::font_info::truetype_ot:
-                fontType= QStringLiteral("TrueType (OpenType)");
-                break;
-            case poppler::font_info::cid_type0c_ot:
-                fontType= QStringLiteral("CID Type 0C (OpenType)");
-                break;
-            case poppler::font_info::cid_truetype_ot:
-                fontType= QStringLiteral("CID TrueType (OpenType)");
-                break;
-            }
-            */
-
-            const QString fontFilename = fi.file().empty() ? QString() : QStringLiteral("|FONTFILENAME:") + QString::fromStdString(fi.file());
-            result << QString::fromStdString(fi.name()) + QLatin1Char('|') + fontType + fontFilename + QStringLiteral("|EMBEDDED:") + (fi.is_embedded() ? QLatin1Char('1') : QLatin1Char('0')) + QStringLiteral("|SUBSET:") + (fi.is_subset() ? QLatin1Char('1') : QLatin1Char('0'));
+        /// Fonts are listed per page, so most fonts show up repeatedly
+        const std::vector<poppler::font_info> pageFonts = it->next();
+        for (std::vector<poppler::font_info>::const_iterator fit = pageFonts.cbegin(); fit != pageFonts.cend(); ++fit) {
+            const QString name = withoutSubsetPrefix(QString::fromStdString(fit->name()));
+            if (name.isEmpty() || knownFonts.contains(name)) continue;
+            knownFonts.insert(name);
+
+            FontInfo fontInfo;
+            fontInfo.name = name;
+            fontInfo.type = fontType(fit->type());
+            if (!fit->file().empty())
+                fontInfo.filename = QString::fromStdString(fit->file()).replace(QStringLiteral("#20"), QStringLiteral(" "));
+            fontInfo.embedded = fit->is_embedded();
+            fontInfo.subset = fit->is_subset();
+            result.append(fontInfo);
         }
     }
     // after we are done with the iterator, it must be deleted
@@ -288,24 +565,71 @@ int PopplerWrapper::numPages() const
 QString PopplerWrapper::plainText(int *length) const
 {
     if (length != 0) *length = 0;
+    const int pageCount = numPages();
+    if (pageCount < 1)
+        return QString();
+    if (m_pages.empty())
+        m_pages.resize(pageCount);
+
+    /// Pages beyond the first few are only needed if those contain
+    /// little text, so start as many threads as there are pages at most
+    const int numTasks = qMin(s_textExtractionThreads, pageCount) - 1;
+    if (numTasks > 0) {
+        TextExtractionState state(pageCount);
+        QThreadPool *pool = textExtractionPool();
+        for (int i = 0; i < numTasks; ++i)
+            pool->start(new TextExtractionTask(m_filename, m_data, &state));
+        /// This thread takes part as well, using the wrapper's own document
+        extractPageTexts(m_document, &state);
+        state.finishedTasks.acquire(numTasks);
+
+        for (int i = 0; i < pageCount && state.extracted[i] != 0; ++i) {
+            CachedPage &cachedPage = m_pages[i];
+            if (!cachedPage.hasText) {
+                cachedPage.text.swap(state.texts[i]);
+                cachedPage.hasText = true;
+            }
+        }
+    }
+
+    /// Pages already extracted above are taken from the cache
     QString result;
-    for (int i = 0; i < numPages() && result.length() < 16384; ++i) {
-        poppler::page *page = m_document->create_page(i);
-        const QString text = QString::fromStdString(page->text().to_latin1());
+    for (int i = 0; i < pageCount && result.length() < textBudget; ++i) {
+        const QString text = pagePlainText(i);
         if (length != 0) *length += text.length();
         result.append(text);
     }
     return result;
 }
 
+QString PopplerWrapper::pagePlainText(int index) const
+{
+    const poppler::byte_array utf8 = pageText(index).to_utf8();
+    return QString::fromUtf8(utf8.data(), static_cast<int>(utf8.size()));
+}
+
+void PopplerWrapper::setTextExtractionThreads(int numThreads)
+{
+    s_textExtractionThreads = qMax(1, numThreads);
+    textExtractionPool()->setMaxThreadCount(s_textExtractionThreads);
+}
+
+int PopplerWrapper::textExtractionThreads()
+{
+    return s_textExtractionThreads;
+}
+
 QSizeF PopplerWrapper::pageSize() const
 {
     if (numPages() < 1)
         return QSize(0, 0);
 
-    poppler::page *page = m_document->create_page(0);
-    poppler::rectf rect = page->page_rect();
-    if (page->orientation() == poppler::page::seascape || page->orientation() == poppler::page::landscape)
+    const poppler::page *firstPage = page(0);
+    if (firstPage == nullptr)
+        return QSize(0, 0);
+
+    const poppler::rectf rect = firstPage->page_rect();
+    if (firstPage->orientation() == poppler::page::seascape || firstPage->orientation() == poppler::page::landscape)
         return QSizeF(rect.height(), rect.width());
     else
         return QSizeF(rect.width(), rect.height());
@@ -321,16 +645,83 @@ bool PopplerWrapper::isEncrypted() const
     return m_document->is_encrypted();
 }
 
-QString PopplerWrapper::popplerLog()
+PDFDoc *PopplerWrapper::pdfDoc()
 {
-    ImageInfoOutputDev iiod(m_document);
+    if (m_pdfDoc != nullptr)
+        return m_pdfDoc;
+
+    if (!m_data.isNull()) {
+        /// Document is held in memory, read it from there as well
+        char *buffer = const_cast<char *>(m_data.constData());
+#if POPPLER_VERSION_MAJOR > 0 || POPPLER_VERSION_MINOR >= 58
+        m_pdfDoc = new PDFDoc(new MemStream(buffer, 0, m_data.size(), Object(objNull)));
+#else // POPPLER_VERSION
+        Object dict;
+        dict.initNull();
+        m_pdfDoc = new PDFDoc(new MemStream(buffer, 0, m_data.size(), &dict));
+#endif // POPPLER_VERSION
+    } else {
+        GooString fileName(m_filename.toLocal8Bit().constData());
+        m_pdfDoc = PDFDocFactory().createPDFDoc(fileName);
+    }
 
-    GooString fileName(m_filename.toLocal8Bit().constData());
-    PDFDoc *doc = PDFDocFactory().createPDFDoc(fileName);
+    return m_pdfDoc;
+}
 
-    doc->displayPages(&iiod, 0, numPages(), 72, 72, 0, gTrue, gFalse, gFalse);
+QString PopplerWrapper::popplerLog(bool includeText)
+{
+    /// Only pages within the window get logged, so do not
+    /// interpret any content streams beyond it
+    const int lastPage = qMin(numPages(), s_pageLogLimit);
+    if (lastPage < 1)
+        return QString();
+
+    PDFDoc *doc = pdfDoc();
+    if (doc == nullptr || !doc->isOk())
+        return QString();
+
+#if POPPLER_VERSION_MAJOR > 0 || POPPLER_VERSION_MINOR >= 58
+    if (s_imageInventory == iiResources) {
+        QString logText;
+        ResourceImageLister lister(logText);
+        for (int pageNum = 1; pageNum <= lastPage; ++pageNum) {
+            logText.append(QString(QStringLiteral("<page number=\"%1\">\n")).arg(pageNum));
+            Page *page = doc->getPage(pageNum);
+            if (page != nullptr)
+                lister.listPage(page);
+            logText.append(pageTextToXML(pageText(pageNum - 1), includeText)).append(QStringLiteral("</page>\n"));
+        }
+        return logText;
+    }
+#endif // POPPLER_VERSION
 
-    delete doc;
+    ImageInfoOutputDev iiod(this, lastPage, includeText);
+    doc->displayPages(&iiod, 1, lastPage, 72, 72, 0, gTrue, gFalse, gFalse);
 
     return iiod.getLogText();
 }
+
+void PopplerWrapper::setPageLogLimit(int pageLimit)
+{
+    s_pageLogLimit = pageLimit;
+}
+
+int PopplerWrapper::pageLogLimit()
+{
+    return s_pageLogLimit;
+}
+
+void PopplerWrapper::setImageInventory(ImageInventory imageInventory)
+{
+#if POPPLER_VERSION_MAJOR > 0 || POPPLER_VERSION_MINOR >= 58
+    s_imageInventory = imageInventory;
+#else // POPPLER_VERSION
+    if (imageInventory == iiResources)
+        qWarning() << "Listing images from resources requires poppler 0.58 or later";
+#endif // POPPLER_VERSION
+}
+
+PopplerWrapper::ImageInventory PopplerWrapper::imageInventory()
+{
+    return s_imageInventory;
+}
@@ -27,44 +27,162 @@
 #define POPPLERWRAPPER_H
 
 #include <QString>
+#include <QByteArray>
 #include <QDateTime>
 #include <QSize>
+#include <QVector>
+
+#include <memory>
+#include <vector>
+
+#include <poppler/cpp/poppler-global.h>
 
 namespace poppler
 {
 class document;
+class page;
 }
 
+class PDFDoc;
+
 /**
  * @author Thomas Fischer <thomas.fischer@his.se>
  */
 class PopplerWrapper
 {
 public:
+    /**
+     * A font as used in a document.
+     */
+    struct FontInfo {
+        enum Type {Unknown, Type1, Type1C, Type1COpenType, Type3, TrueType, TrueTypeOpenType, CIDType0, CIDType0C, CIDType0COpenType, CIDTrueType, CIDTrueTypeOpenType};
+
+        /// Font name without a subset's prefix like 'ABCDEF+'
+        QString name;
+        Type type;
+        /// Font file on this system used for non-embedded fonts, may be empty
+        QString filename;
+        bool embedded, subset;
+
+        QString typeName() const;
+    };
+
     static PopplerWrapper *createPopplerWrapper(const QString &filename);
+    /**
+     * Load a PDF document held in memory. The wrapper keeps
+     * a (shallow) copy of the data as poppler does not copy it.
+     *
+     * @param data the PDF document's content
+     * @param filename name of the document, used in messages only
+     */
+    static PopplerWrapper *createPopplerWrapper(const QByteArray &data, const QString &filename);
     ~PopplerWrapper();
 
     void getPdfVersion(int &majorVersion, int &minorVersion) const;
 
-    QStringList fontNames() const;
+    /**
+     * All fonts used in this document, each name listed only once
+     * even if different subsets of a font got embedded.
+     */
+    QVector<FontInfo> fonts() const;
     QString info(const QString &field) const;
     QDateTime date(const QString &field) const;
 
     int numPages() const;
+    /**
+     * Text of the first pages until at least 16384 characters
+     * have been collected. Pages are extracted by several threads
+     * in parallel, see setTextExtractionThreads(..).
+     *
+     * @param length if not null, receives the returned text's length
+     */
     QString plainText(int *length = 0) const;
+    /**
+     * Text of a single page by zero-based index, extracted
+     * at most once; empty if invalid.
+     */
+    QString pagePlainText(int index) const;
     QSizeF pageSize() const;
 
-    QString popplerLog();
+    /**
+     * Page-wise log of text and images, covering only
+     * the first pages as set by setPageLogLimit(..).
+     *
+     * @param includeText if 'false', pages' text elements only give the text's length, e.g. if text is kept in a TextStore
+     */
+    QString popplerLog(bool includeText = true);
+
+    /**
+     * Set the number of pages covered by popplerLog(). Applies to
+     * all wrappers; should be set before any analysis is started.
+     * Default is 16 pages.
+     */
+    static void setPageLogLimit(int pageLimit);
+    static int pageLogLimit();
+
+    /**
+     * How popplerLog() finds images on a page.
+     */
+    enum ImageInventory {
+        /// Render pages, finding every image when it gets drawn
+        iiRendering = 0,
+        /// Walk pages' resources, no content streams get interpreted
+        iiResources = 1
+    };
+
+    /**
+     * Set how popplerLog() finds images. Applies to all
+     * wrappers. Default is iiRendering.
+     */
+    static void setImageInventory(ImageInventory imageInventory);
+    static ImageInventory imageInventory();
+
+    /**
+     * Set the number of threads extracting text from a document's
+     * pages in parallel for plainText(). Applies to all wrappers.
+     * Default is the number of CPU cores; 1 disables parallel
+     * extraction.
+     */
+    static void setTextExtractionThreads(int numThreads);
+    static int textExtractionThreads();
 
     bool isLocked() const;
     bool isEncrypted() const;
 
 protected:
-    PopplerWrapper(poppler::document *document, const QString &filename);
+    PopplerWrapper(poppler::document *document, const QString &filename, const QByteArray &data = QByteArray());
 
 private:
     poppler::document *m_document;
     QString m_filename;
+    /// Document's content if loaded from memory, null otherwise
+    const QByteArray m_data;
+    /// Lower-level document for output devices, created on demand
+    PDFDoc *m_pdfDoc;
+
+    /**
+     * Pages are parsed and their text is extracted at most once
+     * per document, as plainText(), pageSize() and popplerLog()
+     * all access the first pages.
+     */
+    struct CachedPage {
+        std::unique_ptr<poppler::page> page;
+        bool hasText = false;
+        poppler::ustring text;
+    };
+    mutable std::vector<CachedPage> m_pages;
+
+    static int s_pageLogLimit;
+    static ImageInventory s_imageInventory;
+    static int s_textExtractionThreads;
+
+    PDFDoc *pdfDoc();
+
+    friend class ImageInfoOutputDev;
+    /// Page by zero-based index, owned by this wrapper; null if invalid
+    poppler::page *page(int index) const;
+    /// Text of a page by zero-based index; empty if invalid
+    const poppler::ustring &pageText(int index) const;
 };
 
 #endif // POPPLERWRAPPER_H
@@ -0,0 +1,213 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#include "stagetiming.h"
+
+#include <chrono>
+
+#include <QMutex>
+#include <QTimer>
+#include <QFile>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+
+#include "general.h"
+
+/// Values below 2^subBucketBits are counted exactly, larger ones in
+/// 2^(subBucketBits-1) sub-buckets per power of two
+static const int subBucketBits = 6;
+static const int subBucketCount = 1 << subBucketBits;
+static const int subBucketHalfCount = subBucketCount / 2;
+static const int numBuckets = subBucketCount + (63 - subBucketBits) * subBucketHalfCount;
+
+class StageTiming::Histogram
+{
+public:
+    qint64 count, total, max;
+    quint32 buckets[numBuckets];
+
+    Histogram()
+        : count(0), total(0), max(0) {
+        for (int i = 0; i < numBuckets; ++i)
+            buckets[i] = 0;
+    }
+
+    void add(qint64 value) {
+        if (value < 0) value = 0;
+        ++buckets[bucketIndex(value)];
+        ++count;
+        total += value;
+        if (value > max) max = value;
+    }
+
+    /**
+     * Smallest recorded value not exceeded by the given share
+     * of all values, up to the precision of the buckets.
+     */
+    qint64 percentile(double share) const {
+        if (count == 0) return 0;
+        const qint64 rank = qMax(Q_INT64_C(1), static_cast<qint64>(share * count + 0.5));
+        qint64 seen = 0;
+        for (int i = 0; i < numBuckets; ++i) {
+            seen += buckets[i];
+            if (seen >= rank)
+                return qMin(highestValueInBucket(i), max);
+        }
+        return max;
+    }
+
+private:
+    static int bucketIndex(qint64 value) {
+        if (value < subBucketCount) return static_cast<int>(value);
+        int msb = subBucketBits;
+        while ((value >> (msb + 1)) != 0) ++msb;
+        const int shift = msb - subBucketBits + 1;
+        return subBucketCount + (shift - 1) * subBucketHalfCount + static_cast<int>((value >> shift) - subBucketHalfCount);
+    }
+
+    static qint64 highestValueInBucket(int index) {
+        if (index < subBucketCount) return index;
+        const int shift = (index - subBucketCount) / subBucketHalfCount + 1;
+        const qint64 subBucket = (index - subBucketCount) % subBucketHalfCount + subBucketHalfCount;
+        return ((subBucket + 1) << shift) - 1;
+    }
+};
+
+StageTiming *StageTiming::instance()
+{
+    static StageTiming *stageTiming = new StageTiming();
+    return stageTiming;
+}
+
+StageTiming::StageTiming()
+    : QObject(), m_csvTimer(nullptr), m_csvFile(nullptr)
+{
+    m_mutex = new QMutex();
+    /// Timers must belong to the main thread, even if first used by a worker
+    if (QCoreApplication::instance() != nullptr)
+        moveToThread(QCoreApplication::instance()->thread());
+}
+
+StageTiming::~StageTiming()
+{
+    if (m_csvFile != nullptr) {
+        m_csvFile->close();
+        delete m_csvFile;
+    }
+    qDeleteAll(m_total);
+    qDeleteAll(m_interval);
+    delete m_mutex;
+}
+
+qint64 StageTiming::now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void StageTiming::record(const QString &stage, qint64 microseconds)
+{
+    QMutexLocker locker(m_mutex);
+    Histogram *&total = m_total[stage];
+    if (total == nullptr) total = new Histogram();
+    total->add(microseconds);
+    if (m_csvFile != nullptr) {
+        Histogram *&interval = m_interval[stage];
+        if (interval == nullptr) interval = new Histogram();
+        interval->add(microseconds);
+    }
+}
+
+bool StageTiming::setCsvOutput(const QString &filename, int intervalSeconds)
+{
+    QFile *file = new QFile(filename);
+    if (!file->open(QFile::WriteOnly | QFile::Truncate)) {
+        qWarning() << "Cannot open file for timing statistics:" << filename;
+        delete file;
+        return false;
+    }
+    file->write("time,stage,count,p50_us,p95_us,p99_us,max_us,total_us\n");
+    file->flush();
+
+    QMutexLocker locker(m_mutex);
+    m_csvFile = file;
+    m_csvTimer = new QTimer(this);
+    connect(m_csvTimer, SIGNAL(timeout()), this, SLOT(writeCsv()));
+    m_csvTimer->start(intervalSeconds * 1000);
+    return true;
+}
+
+void StageTiming::writeCsv()
+{
+    QMutexLocker locker(m_mutex);
+    if (m_csvFile == nullptr) return;
+
+    const QString time = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    for (QHash<QString, Histogram *>::ConstIterator it = m_interval.constBegin(); it != m_interval.constEnd(); ++it) {
+        const Histogram *h = it.value();
+        if (h->count == 0) continue;
+        m_csvFile->write(QString(QStringLiteral("%1,%2,%3,%4,%5,%6,%7,%8\n")).arg(time, it.key(), QString::number(h->count), QString::number(h->percentile(0.5)), QString::number(h->percentile(0.95)), QString::number(h->percentile(0.99)), QString::number(h->max), QString::number(h->total)).toUtf8());
+    }
+    m_csvFile->flush();
+    /// Next line covers the next interval only
+    qDeleteAll(m_interval);
+    m_interval.clear();
+}
+
+void StageTiming::finalReport()
+{
+    if (m_csvTimer != nullptr) {
+        m_csvTimer->stop();
+        writeCsv();
+    }
+
+    QString logText = QStringLiteral("<timing-summary unit=\"us\">\n");
+    m_mutex->lock();
+    QStringList stages = m_total.keys();
+    stages.sort();
+    for (const QString &stage : const_cast<const QStringList &>(stages)) {
+        const Histogram *h = m_total.value(stage);
+        logText.append(QString(QStringLiteral("<stage name=\"%1\" count=\"%2\" p50=\"%3\" p95=\"%4\" p99=\"%5\" max=\"%6\" total=\"%7\" />\n")).arg(DocScan::xmlify(stage), QString::number(h->count), QString::number(h->percentile(0.5)), QString::number(h->percentile(0.95)), QString::number(h->percentile(0.99)), QString::number(h->max), QString::number(h->total)));
+    }
+    m_mutex->unlock();
+    logText.append(QStringLiteral("</timing-summary>\n"));
+
+    emit report(logText);
+}
+
+StageTimer::StageTimer(const QString &stage)
+    : m_stage(stage), m_startTime(StageTiming::now()), m_stopped(false)
+{
+    /// nothing
+}
+
+StageTimer::~StageTimer()
+{
+    stop();
+}
+
+void StageTimer::stop()
+{
+    if (m_stopped) return;
+    m_stopped = true;
+    StageTiming::instance()->record(m_stage, StageTiming::now() - m_startTime);
+}
@@ -0,0 +1,129 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#ifndef STAGETIMING_H
+#define STAGETIMING_H
+
+#include <QObject>
+#include <QHash>
+
+class QMutex;
+class QTimer;
+class QFile;
+
+/**
+ * Collects how long the stages of a run take, e.g. downloading,
+ * loading a PDF file with poppler, or running a validator. Every
+ * measured duration is added to the stage's histogram, which is
+ * bucketed log-linearly like an HDR histogram (about 3% precision),
+ * so that percentiles can be reported without keeping all values.
+ *
+ * At the end of a run, a '<timing-summary>' report lists count,
+ * median, 95th and 99th percentile, maximum and total for each
+ * stage. Optionally, the same figures are periodically written to
+ * a CSV file, each line covering only the interval since the
+ * previous line.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class StageTiming : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Process-wide instance, created on first use.
+     */
+    static StageTiming *instance();
+
+    ~StageTiming();
+
+    /**
+     * Monotonic clock in microseconds, for use with record(..).
+     */
+    static qint64 now();
+
+    /**
+     * Record a stage's duration. May be called from any thread.
+     *
+     * @param stage stage name, e.g. 'poppler-load'
+     * @param microseconds duration of the stage
+     */
+    void record(const QString &stage, qint64 microseconds);
+
+    /**
+     * Periodically write per-stage figures to a CSV file.
+     * Has to be called from the main thread.
+     *
+     * @param filename CSV file to write to, will be overwritten
+     * @param intervalSeconds seconds between two lines per stage
+     * @return 'false' if the file could not be opened
+     */
+    bool setCsvOutput(const QString &filename, int intervalSeconds);
+
+signals:
+    void report(QString);
+
+public slots:
+    /**
+     * Emit the '<timing-summary>' report for all stages recorded so far.
+     */
+    void finalReport();
+
+private slots:
+    void writeCsv();
+
+private:
+    class Histogram;
+
+    QMutex *m_mutex;
+    /// Histograms since start of run and since last CSV output, respectively
+    QHash<QString, Histogram *> m_total, m_interval;
+    QTimer *m_csvTimer;
+    QFile *m_csvFile;
+
+    explicit StageTiming();
+};
+
+/**
+ * Measures the time from its construction to its destruction
+ * (or to an explicit call of stop()) and records it for a stage.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class StageTimer
+{
+public:
+    explicit StageTimer(const QString &stage);
+    ~StageTimer();
+
+    /**
+     * Record the duration now instead of on destruction.
+     */
+    void stop();
+
+private:
+    const QString m_stage;
+    const qint64 m_startTime;
+    bool m_stopped;
+};
+
+#endif // STAGETIMING_H
@@ -0,0 +1,151 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+
+#include "textanalysis.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMutex>
+
+#include "fileanalyzerabstract.h"
+#include "languageidentifier.h"
+#include "aspellpool.h"
+#include "stagetiming.h"
+
+TextAnalysisJob::~TextAnalysisJob()
+{
+    /// nothing
+}
+
+class TextAnalysis::Task : public QRunnable
+{
+public:
+    Task(TextAnalysisJob *job, bool identifyLanguage)
+        : m_job(job), m_identifyLanguage(identifyLanguage)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() {
+        QString headerText;
+        TextSource *source = m_job->textSource();
+        if (source != nullptr)
+            headerText = TextAnalysis::analyze(*source, m_identifyLanguage);
+        m_job->textAnalyzed(headerText);
+        delete m_job;
+    }
+
+private:
+    TextAnalysisJob *m_job;
+    const bool m_identifyLanguage;
+};
+
+TextAnalysis *TextAnalysis::instance()
+{
+    static QMutex instanceMutex;
+    static TextAnalysis *textAnalysis = nullptr;
+
+    QMutexLocker locker(&instanceMutex);
+    if (textAnalysis == nullptr) {
+        /// Never deleted, lives as long as the process
+        textAnalysis = new TextAnalysis();
+    }
+    return textAnalysis;
+}
+
+TextAnalysis::TextAnalysis()
+    : m_pool(new QThreadPool())
+{
+    m_pool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+void TextAnalysis::setMaxThreads(int numThreads)
+{
+    m_pool->setMaxThreadCount(numThreads > 0 ? numThreads : qMax(1, QThread::idealThreadCount()));
+}
+
+void TextAnalysis::submit(TextAnalysisJob *job, bool identifyLanguage)
+{
+    m_pool->start(new Task(job, identifyLanguage));
+}
+
+QString TextAnalysis::analyze(TextSource &source, bool identifyLanguage)
+{
+    QString result;
+    /// Counting requires visiting every part, which is only
+    /// done if this does not mean extracting text once more
+    if (source.isInMemory())
+        result.append(statisticsToXML(source));
+    if (identifyLanguage)
+        result.append(languageToXML(source));
+    return result;
+}
+
+QString TextAnalysis::languageToXML(TextSource &source)
+{
+    QString result;
+    QString sample;
+
+    const FileAnalyzerAbstract::LanguageIdentification method = FileAnalyzerAbstract::languageIdentification();
+    if (method != FileAnalyzerAbstract::liAspell) {
+        StageTimer timer(QStringLiteral("language"));
+        double confidence = 0.0;
+        const QString language = LanguageIdentifier::instance()->identify(source, &confidence, &sample);
+        timer.stop();
+        if (!language.isEmpty())
+            result = QString(QStringLiteral("<language origin=\"ngram\" confidence=\"%2\">%1</language>\n")).arg(language, QString::number(confidence, 'f', 2));
+        /// Spell-checking with every dictionary is expensive,
+        /// so only do so if the trigram statistics are inconclusive
+        if (method == FileAnalyzerAbstract::liNGram || (!language.isEmpty() && confidence >= FileAnalyzerAbstract::minLanguageConfidence()))
+            return result;
+    } else
+        sample = source.sample(LanguageIdentifier::maxSampleWindows * TextSource::windowLength);
+
+    StageTimer timer(QStringLiteral("aspell"));
+    const QString language = AspellPool::instance()->guessLanguage(sample);
+    timer.stop();
+    if (!language.isEmpty())
+        result.append(QString(QStringLiteral("<language origin=\"aspell\">%1</language>\n")).arg(language));
+    return result;
+}
+
+QString TextAnalysis::statisticsToXML(TextSource &source)
+{
+    qint64 numCharacters = 0, numWords = 0;
+    /// Kept across parts, so that words split by a part's end count once
+    bool inWord = false;
+
+    const int numParts = source.numParts();
+    for (int i = 0; i < numParts; ++i) {
+        const QString text = source.part(i);
+        numCharacters += text.length();
+        for (const QChar c : text) {
+            const bool isWordCharacter = c.isLetterOrNumber();
+            if (isWordCharacter && !inWord) ++numWords;
+            inWord = isWordCharacter;
+        }
+    }
+
+    return QString(QStringLiteral("<text-statistics characters=\"%1\" words=\"%2\" />\n")).arg(QString::number(numCharacters), QString::number(numWords));
+}
@@ -0,0 +1,108 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+
+#ifndef TEXTANALYSIS_H
+#define TEXTANALYSIS_H
+
+#include <QString>
+
+class QThreadPool;
+class TextSource;
+
+/**
+ * A document whose text gets analyzed by TextAnalysis.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class TextAnalysisJob
+{
+public:
+    virtual ~TextAnalysisJob();
+
+    /**
+     * Text to analyze. Called once in a pool thread, so any
+     * expensive retrieval of text should happen in here or in
+     * the returned source. The source remains owned by the job.
+     */
+    virtual TextSource *textSource() = 0;
+
+    /**
+     * Analysis is complete. Called in a pool thread, the job
+     * gets deleted afterwards.
+     *
+     * @param headerText XML elements to be added to the document's <header>, may be empty
+     */
+    virtual void textAnalyzed(const QString &headerText) = 0;
+};
+
+/**
+ * Analyzes documents' text, i.e. identifies their language and
+ * counts characters and words, in a pool of threads shared by all
+ * analyzers, so that analyzers can continue with the next file
+ * meanwhile. Language identification is configured through
+ * FileAnalyzerAbstract::setLanguageIdentification(..).
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class TextAnalysis
+{
+public:
+    /**
+     * Process-wide instance, created on first use.
+     */
+    static TextAnalysis *instance();
+
+    /**
+     * Set the number of threads analyzing text.
+     * Default is the number of CPU cores.
+     */
+    void setMaxThreads(int numThreads);
+
+    /**
+     * Queue a job for analysis; returns immediately.
+     * Takes ownership of the job.
+     *
+     * @param job document to analyze
+     * @param identifyLanguage if 'false', text statistics only
+     */
+    void submit(TextAnalysisJob *job, bool identifyLanguage);
+
+    /**
+     * Analyze a document's text in the calling thread.
+     *
+     * @return XML elements for the document's <header>
+     */
+    static QString analyze(TextSource &source, bool identifyLanguage);
+
+private:
+    class Task;
+
+    QThreadPool *m_pool;
+
+    TextAnalysis();
+
+    static QString languageToXML(TextSource &source);
+    static QString statisticsToXML(TextSource &source);
+};
+
+#endif // TEXTANALYSIS_H
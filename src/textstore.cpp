@@ -0,0 +1,251 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+
+#include "textstore.h"
+
+#include <cstring>
+
+#include <sys/file.h>
+
+#include <QFile>
+#include <QtEndian>
+#include <QMutex>
+#include <QUuid>
+#include <QDebug>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+
+/// zstd's default level, favoring speed as texts are written once
+/// per document but rarely read
+static const int compressionLevel = 3;
+#endif // HAVE_ZSTD
+
+const int TextStore::indexRecordSize = 16;
+const int TextStore::identityFrameSize = 24;
+
+TextStore *TextStore::instance()
+{
+    static QMutex instanceMutex;
+    static TextStore *store = nullptr;
+
+    QMutexLocker locker(&instanceMutex);
+    if (store == nullptr) {
+        /// Never deleted, lives as long as the process
+        store = new TextStore();
+    }
+    return store;
+}
+
+TextStore::TextStore()
+{
+    /// nothing
+}
+
+bool TextStore::setFilename(const QString &filename)
+{
+    m_filename.clear();
+    m_identity.clear();
+    if (filename.isEmpty()) return true;
+
+#ifdef HAVE_ZSTD
+    QFile data(filename);
+    if (!data.open(QFile::ReadWrite)) {
+        qWarning() << "Cannot open text store" << filename;
+        return false;
+    }
+    /// Worker processes open the same store
+    if (::flock(data.handle(), LOCK_EX) != 0) {
+        qWarning() << "Cannot lock text store" << filename;
+        return false;
+    }
+
+    /// Data file starts with a skippable frame holding a random UUID,
+    /// ignored by zstd when decompressing the whole file
+    uchar header[identityFrameSize];
+    const qint64 headerSize = data.read(reinterpret_cast<char *>(header), identityFrameSize);
+    if (headerSize == 0) {
+        /// New store; an index left over from a previous
+        /// data file would assign wrong ids
+        QFile index(filename + QStringLiteral(".idx"));
+        index.open(QFile::WriteOnly | QFile::Truncate);
+        const QByteArray uuid = QUuid::createUuid().toRfc4122();
+        qToLittleEndian<quint32>(ZSTD_MAGIC_SKIPPABLE_START, header);
+        qToLittleEndian<quint32>(static_cast<quint32>(uuid.size()), header + 4);
+        memcpy(header + 8, uuid.constData(), uuid.size());
+        if (data.write(reinterpret_cast<const char *>(header), identityFrameSize) == identityFrameSize && data.flush())
+            m_identity = QUuid::fromRfc4122(uuid).toString();
+    } else if (headerSize == identityFrameSize && (qFromLittleEndian<quint32>(header) & 0xFFFFFFF0u) == ZSTD_MAGIC_SKIPPABLE_START && qFromLittleEndian<quint32>(header + 4) == identityFrameSize - 8)
+        m_identity = QUuid::fromRfc4122(QByteArray(reinterpret_cast<const char *>(header + 8), identityFrameSize - 8)).toString();
+    ::flock(data.handle(), LOCK_UN);
+
+    if (m_identity.isEmpty()) {
+        /// Stores written by earlier versions separated pages by form
+        /// feeds, which may occur in pages' text as well
+        qWarning() << "Cannot use text store" << filename << "written in an outdated format or lacking its identity; use a new file instead";
+        return false;
+    }
+    m_filename = filename;
+    return true;
+#else // HAVE_ZSTD
+    qWarning() << "Storing text requires DocScan to be built with zstd support (qmake CONFIG+=zstd)";
+    return false;
+#endif // HAVE_ZSTD
+}
+
+QString TextStore::filename() const
+{
+    return m_filename;
+}
+
+bool TextStore::isEnabled() const
+{
+    return !m_filename.isEmpty();
+}
+
+QString TextStore::identity() const
+{
+    return m_identity;
+}
+
+qint64 TextStore::append(const QStringList &pageTexts, qint64 *offset, int *size) const
+{
+    if (m_filename.isEmpty()) return -1;
+
+#ifdef HAVE_ZSTD
+    /// Pages' text may contain any character, so pages are not separated
+    /// by a special character but preceded by their lengths in bytes
+    QByteArray text;
+    uchar number[4];
+    qToLittleEndian<quint32>(static_cast<quint32>(pageTexts.count()), number);
+    text.append(reinterpret_cast<const char *>(number), 4);
+    QList<QByteArray> utf8Texts;
+    for (const QString &pageText : pageTexts) {
+        utf8Texts.append(pageText.toUtf8());
+        qToLittleEndian<quint32>(static_cast<quint32>(utf8Texts.last().size()), number);
+        text.append(reinterpret_cast<const char *>(number), 4);
+    }
+    for (const QByteArray &utf8Text : const_cast<const QList<QByteArray> &>(utf8Texts))
+        text.append(utf8Text);
+    QByteArray frame(static_cast<int>(ZSTD_compressBound(text.size())), Qt::Uninitialized);
+    const size_t frameSize = ZSTD_compress(frame.data(), frame.size(), text.constData(), text.size(), compressionLevel);
+    if (ZSTD_isError(frameSize)) {
+        qWarning() << "Cannot compress text for text store:" << ZSTD_getErrorName(frameSize);
+        return -1;
+    }
+    frame.resize(static_cast<int>(frameSize));
+
+    QFile data(m_filename), index(indexFilename());
+    if (!data.open(QFile::ReadWrite) || !index.open(QFile::ReadWrite)) {
+        qWarning() << "Cannot open text store" << m_filename;
+        return -1;
+    }
+
+    /// Other threads or worker processes may append at the same time;
+    /// the data file's lock covers the index file as well
+    if (::flock(data.handle(), LOCK_EX) != 0) {
+        qWarning() << "Cannot lock text store" << m_filename;
+        return -1;
+    }
+    /// A record cut short by an interrupted run gets overwritten, a frame
+    /// without a record is skipped as frames are located by offset
+    const qint64 id = index.size() / indexRecordSize;
+    const qint64 frameOffset = data.size();
+    bool ok = data.seek(frameOffset) && data.write(frame) == frame.size() && data.flush();
+    if (ok) {
+        uchar record[indexRecordSize];
+        qToLittleEndian<quint64>(static_cast<quint64>(frameOffset), record);
+        qToLittleEndian<quint32>(static_cast<quint32>(frame.size()), record + 8);
+        qToLittleEndian<quint32>(static_cast<quint32>(text.size()), record + 12);
+        ok = index.seek(id * indexRecordSize) && index.write(reinterpret_cast<const char *>(record), indexRecordSize) == indexRecordSize && index.flush();
+    }
+    ::flock(data.handle(), LOCK_UN);
+
+    if (!ok) {
+        qWarning() << "Failed to write to text store" << m_filename;
+        return -1;
+    }
+    if (offset != nullptr) *offset = frameOffset;
+    if (size != nullptr) *size = frame.size();
+    return id;
+#else // HAVE_ZSTD
+    Q_UNUSED(pageTexts);
+    Q_UNUSED(offset);
+    Q_UNUSED(size);
+    return -1;
+#endif // HAVE_ZSTD
+}
+
+QStringList TextStore::pageTexts(qint64 id) const
+{
+    if (m_filename.isEmpty() || id < 0) return QStringList();
+
+#ifdef HAVE_ZSTD
+    QFile index(indexFilename());
+    uchar record[indexRecordSize];
+    if (!index.open(QFile::ReadOnly) || !index.seek(id * indexRecordSize) || index.read(reinterpret_cast<char *>(record), indexRecordSize) != indexRecordSize)
+        return QStringList();
+    const qint64 frameOffset = static_cast<qint64>(qFromLittleEndian<quint64>(record));
+    const int frameSize = static_cast<int>(qFromLittleEndian<quint32>(record + 8));
+    const int textSize = static_cast<int>(qFromLittleEndian<quint32>(record + 12));
+
+    QFile data(m_filename);
+    if (!data.open(QFile::ReadOnly) || !data.seek(frameOffset))
+        return QStringList();
+    const QByteArray frame = data.read(frameSize);
+    if (frame.size() != frameSize)
+        return QStringList();
+
+    QByteArray text(textSize, Qt::Uninitialized);
+    const size_t decompressedSize = ZSTD_decompress(text.data(), text.size(), frame.constData(), frame.size());
+    if (ZSTD_isError(decompressedSize) || decompressedSize != static_cast<size_t>(textSize)) {
+        qWarning() << "Corrupt text in text store" << m_filename << "for id" << id;
+        return QStringList();
+    }
+    const uchar *p = reinterpret_cast<const uchar *>(text.constData());
+    const qint64 numPages = textSize >= 4 ? qFromLittleEndian<quint32>(p) : -1;
+    if (numPages < 0 || 4 + 4 * numPages > textSize) {
+        qWarning() << "Corrupt text in text store" << m_filename << "for id" << id;
+        return QStringList();
+    }
+    QStringList result;
+    qint64 textOffset = 4 + 4 * numPages;
+    for (qint64 i = 0; i < numPages; ++i) {
+        const qint64 length = qFromLittleEndian<quint32>(p + 4 + 4 * i);
+        if (textOffset + length > textSize) {
+            qWarning() << "Corrupt text in text store" << m_filename << "for id" << id;
+            return QStringList();
+        }
+        result.append(QString::fromUtf8(text.constData() + textOffset, static_cast<int>(length)));
+        textOffset += length;
+    }
+    return result;
+#else // HAVE_ZSTD
+    return QStringList();
+#endif // HAVE_ZSTD
+}
+
+QString TextStore::indexFilename() const
+{
+    return m_filename + QStringLiteral(".idx");
+}
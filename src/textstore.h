@@ -0,0 +1,105 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+
+#ifndef TEXTSTORE_H
+#define TEXTSTORE_H
+
+#include <QStringList>
+
+/**
+ * Append-only store for the full text of analyzed documents, kept
+ * next to the log instead of inside it. Each document's page texts
+ * are compressed as a single, independent zstd frame appended to the
+ * store's data file. Uncompressed, a frame holds the number of pages
+ * and each page's length in bytes (32 bit each, little-endian),
+ * followed by the pages' UTF-8 encoded texts. Frames are located
+ * by the offset and size given in the log's <body> element or, by
+ * a document's id, through an index file next to the data file
+ * ('.idx' appended to its name): a sequence of 16-byte records, the
+ * n-th record describing the n-th document as frame offset (64 bit),
+ * compressed and uncompressed size (32 bit each), all little-endian.
+ * The data file starts with a skippable zstd frame holding a random
+ * UUID, identifying the store, see identity().
+ * Several threads and processes may append to the same store.
+ * Requires DocScan to be built with zstd support.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class TextStore
+{
+public:
+    /**
+     * Process-wide store instance, created on first use.
+     */
+    static TextStore *instance();
+
+    /**
+     * Set the data file to append texts to; the index file's name
+     * is derived from it. Should be called before any analysis is
+     * started. An empty filename disables the store.
+     *
+     * @return 'false' if texts cannot be stored, e.g. due to missing zstd support or a store in an outdated format
+     */
+    bool setFilename(const QString &filename);
+    QString filename() const;
+    bool isEnabled() const;
+
+    /**
+     * UUID written when the data file was created, so that references
+     * to frames of a deleted or replaced store can be told apart.
+     * Empty if the store is disabled.
+     */
+    QString identity() const;
+
+    /**
+     * Compress and append a document's page texts.
+     * May be called from any thread.
+     *
+     * @param pageTexts text of each page
+     * @param offset if not null, receives the frame's offset in the data file
+     * @param size if not null, receives the frame's size in bytes
+     * @return document's id, i.e. its record's number in the index file; -1 on failure
+     */
+    qint64 append(const QStringList &pageTexts, qint64 *offset = nullptr, int *size = nullptr) const;
+
+    /**
+     * Retrieve a document's page texts by its id as returned
+     * by append(..), without reading any other document.
+     *
+     * @return page texts, empty on failure
+     */
+    QStringList pageTexts(qint64 id) const;
+
+private:
+    static const int indexRecordSize;
+    static const int identityFrameSize;
+
+    QString m_filename;
+    QString m_identity;
+
+    TextStore();
+
+    QString indexFilename() const;
+};
+
+#endif // TEXTSTORE_H
@@ -37,6 +37,7 @@
 #include "watchdog.h"
 #include "general.h"
 #include "networkaccessmanager.h"
+#include "stagetiming.h"
 
 UrlDownloader::UrlDownloader(NetworkAccessManager *networkAccessManager, const QString &filePattern, int maxDownloads, QObject *parent)
     : Downloader(parent), m_networkAccessManager(networkAccessManager), m_filePattern(filePattern), m_maxDownloads(maxDownloads)
@@ -63,18 +64,26 @@ bool UrlDownloader::isAlive()
     return m_runningDownloads > 0 || m_geoip->isAlive();
 }
 
+int UrlDownloader::numPendingUrls()
+{
+    QMutexLocker locker(m_internalMutex);
+    return m_urlQueue.count() + m_runningDownloads;
+}
+
 void UrlDownloader::download(const QUrl &url)
 {
     if (url.scheme() != QStringLiteral("http") && url.scheme() != QStringLiteral("https")) {
         qWarning() << "Untested/unknown protocol/scheme " << url.scheme() << " for URL " << url.toString();
         const QString logText = QString(QStringLiteral("<download message=\"Untested/unknown protocol/scheme\" status=\"error\" url=\"%1\" scheme=\"%2\"/>\n")).arg(url.toString(), url.scheme());
         emit report(logText);
+        emit creditsGranted(1); ///< nothing will be passed on for analysis
         return;
     }
 
     if (m_countSuccessfulDownloads > m_maxDownloads) {
         /// already reached limit of maximum downloads
         qDebug() << "Reached maximum download of " << m_maxDownloads << " > " << m_countSuccessfulDownloads << " for URL " << url.toString();
+        emit creditsGranted(1);
         return;
     }
 
@@ -86,8 +95,11 @@ void UrlDownloader::download(const QUrl &url)
         m_urlQueue.enqueue(url);
         m_internalMutex->unlock();
         // m_geoip->lookupHost(url.host());
-    } else
+    } else {
         m_internalMutex->unlock();
+        /// duplicate URL will not be passed on for analysis
+        emit creditsGranted(1);
+    }
 
     startNextDownload();
 }
@@ -102,6 +114,7 @@ void UrlDownloader::startNextDownload()
         QNetworkRequest request(url);
         m_networkAccessManager->setRequestHeaders(request);
         QNetworkReply *reply = m_networkAccessManager->get(request);
+        reply->setProperty("startTime", StageTiming::now());
         connect(reply, SIGNAL(finished()), this, SLOT(finished()));
 
         ++m_runningDownloads;
@@ -149,6 +162,8 @@ void UrlDownloader::finished()
     m_runningdownloadsPerHostname[hostname] = m_runningdownloadsPerHostname.value(hostname, 1) - 1;
     m_internalMutex->unlock();
 
+    StageTiming::instance()->record(QStringLiteral("download"), StageTiming::now() - reply->property("startTime").toLongLong());
+
     bool succeeded = false;
 
     if (reply->error() == QNetworkReply::NoError) {
@@ -308,6 +323,7 @@ void UrlDownloader::finished()
                 succeeded = true;
 
                 emit downloaded(reply->url(), filename);
+                emit downloaded(filename, data);
                 emit downloaded(filename);
 
                 qDebug() << "Downloaded URL " << reply->url().toString() << " to " << filename << " (running:" << m_runningDownloads << ")";
@@ -319,12 +335,14 @@ void UrlDownloader::finished()
         QString logText = QString(QStringLiteral("<download detailed=\"%1\" message=\"download-failed\" status=\"error\" url=\"%2\" />\n")).arg(DocScan::xmlify(reply->errorString()), DocScan::xmlify(reply->url().toString()));
         emit report(logText);
         ++m_countFailedDownloads;
+        emit creditsGranted(1);
     } else
         ++m_countSuccessfulDownloads;
 
     QCoreApplication::instance()->processEvents();
     reply->deleteLater();
     startNextDownload();
+    checkDrained();
 }
 
 void UrlDownloader::timeout(QObject *object)
@@ -68,6 +68,7 @@ public slots:
 signals:
     void downloaded(QUrl, QString);
     void downloaded(QString);
+    void downloaded(QString, QByteArray);
     void report(QString);
 
 private:
@@ -91,6 +92,9 @@ private:
 
     QString domainFromHostname(const QString &hostname);
 
+protected:
+    virtual int numPendingUrls();
+
 private slots:
     void finished();
     void timeout(QObject *);
@@ -0,0 +1,1020 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#include "validatorscheduler.h"
+
+#include <climits>
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QProcess>
+#include <QTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+
+#include "stagetiming.h"
+
+const int ValidatorScheduler::numTools = 5;
+
+/// Names of tools as used for timing statistics, in order of enum Tool
+static const char *toolNames[] = {"verapdf", "callaspdfapilot", "jhove", "pdfboxvalidator", "pdfworker"};
+
+ValidatorJob::~ValidatorJob()
+{
+    // nothing
+}
+
+ValidatorOutputParser::~ValidatorOutputParser()
+{
+    // nothing
+}
+
+void ValidatorOutputParser::finish()
+{
+    // nothing
+}
+
+ValidatorBatchSplitter::~ValidatorBatchSplitter()
+{
+    // nothing
+}
+
+ValidatorScheduler *ValidatorScheduler::instance()
+{
+    static QMutex instanceMutex;
+    static ValidatorScheduler *scheduler = nullptr;
+
+    QMutexLocker locker(&instanceMutex);
+    if (scheduler == nullptr) {
+        /// Never deleted, lives as long as the process
+        scheduler = new ValidatorScheduler();
+    }
+    return scheduler;
+}
+
+ValidatorScheduler::ValidatorScheduler()
+    : QObject(nullptr), m_maxPendingJobs(qMax(1, QThread::idealThreadCount()) * 4), m_serverMaxRequests(500), m_serverMaxMemoryMiB(1024), m_maxOutputSize(65536)
+{
+    m_mutex = new QMutex();
+    /// Aborting a run may submit and abort further runs for the same job
+    m_abortMutex = new QMutex(QMutex::Recursive);
+    m_stopped = false;
+    m_jobFinished = new QWaitCondition();
+    m_queuedRuns = new QQueue<Run>[numTools];
+    m_runningProcesses = new int[numTools];
+    m_maxProcesses = new int[numTools];
+    m_serverMode = new bool[numTools];
+    m_batchMaxFiles = new int[numTools];
+    m_batchMaxWait = new int[numTools];
+    m_batchSplitterFactory = new BatchSplitterFactory[numTools];
+    m_averageRunTime = new qint64[numTools];
+    for (int i = 0; i < numTools; ++i) {
+        m_runningProcesses[i] = 0;
+        m_maxProcesses[i] = qMax(1, QThread::idealThreadCount());
+        m_serverMode[i] = false;
+        m_batchMaxFiles[i] = 0;
+        m_batchMaxWait[i] = 0;
+        m_batchSplitterFactory[i] = nullptr;
+        m_averageRunTime[i] = 0;
+    }
+
+    /// Moves to the scheduler's thread along with its parent
+    m_batchTimer = new QTimer(this);
+    m_batchTimer->setSingleShot(true);
+    connect(m_batchTimer, SIGNAL(timeout()), this, SLOT(startQueuedRuns()));
+
+    m_thread = new QThread();
+    m_thread->setObjectName(QStringLiteral("ValidatorScheduler"));
+    moveToThread(m_thread);
+    m_thread->start();
+}
+
+ValidatorScheduler::~ValidatorScheduler()
+{
+    shutdown();
+    delete m_thread;
+    delete[] m_averageRunTime;
+    delete[] m_batchSplitterFactory;
+    delete[] m_batchMaxWait;
+    delete[] m_batchMaxFiles;
+    delete[] m_serverMode;
+    delete[] m_maxProcesses;
+    delete[] m_runningProcesses;
+    delete[] m_queuedRuns;
+    delete m_jobFinished;
+    delete m_abortMutex;
+    delete m_mutex;
+}
+
+void ValidatorScheduler::setMaxProcesses(Tool tool, int maxProcesses)
+{
+    QMutexLocker locker(m_mutex);
+    m_maxProcesses[tool] = qMax(1, maxProcesses);
+}
+
+void ValidatorScheduler::setMaxPendingJobs(int maxPendingJobs)
+{
+    QMutexLocker locker(m_mutex);
+    m_maxPendingJobs = qMax(1, maxPendingJobs);
+}
+
+void ValidatorScheduler::setServerMode(Tool tool, bool enabled)
+{
+    QMutexLocker locker(m_mutex);
+    m_serverMode[tool] = enabled;
+}
+
+bool ValidatorScheduler::serverMode(Tool tool) const
+{
+    QMutexLocker locker(m_mutex);
+    return m_serverMode[tool];
+}
+
+void ValidatorScheduler::setServerRecycling(int maxRequests, int maxMemoryMiB)
+{
+    QMutexLocker locker(m_mutex);
+    m_serverMaxRequests = qMax(1, maxRequests);
+    m_serverMaxMemoryMiB = qMax(0, maxMemoryMiB);
+}
+
+void ValidatorScheduler::setMaxOutputSize(int maxOutputSize)
+{
+    QMutexLocker locker(m_mutex);
+    m_maxOutputSize = qMax(0, maxOutputSize);
+}
+
+void ValidatorScheduler::setBatching(Tool tool, int maxFiles, int maxWait, BatchSplitterFactory factory)
+{
+    QMutexLocker locker(m_mutex);
+    m_batchMaxFiles[tool] = factory != nullptr ? maxFiles : 0;
+    m_batchMaxWait[tool] = qMax(0, maxWait);
+    m_batchSplitterFactory[tool] = factory;
+}
+
+qint64 ValidatorScheduler::averageRunTime(Tool tool) const
+{
+    QMutexLocker locker(m_mutex);
+    return m_averageRunTime[tool];
+}
+
+void ValidatorScheduler::waitForCapacity()
+{
+    /// Jobs finish in the scheduler's thread or wherever they get released,
+    /// so no events need to be processed here; doing so would let further
+    /// files get enqueued from within this call, out of order
+    m_mutex->lock();
+    while (m_jobs.count() >= m_maxPendingJobs && !m_stopped)
+        m_jobFinished->wait(m_mutex);
+    m_mutex->unlock();
+}
+
+void ValidatorScheduler::addJob(ValidatorJob *job)
+{
+    QMutexLocker locker(m_mutex);
+    JobState state;
+    state.outstandingRuns = 0;
+    state.released = false;
+    m_jobs.insert(job, state);
+}
+
+void ValidatorScheduler::submit(ValidatorJob *job, Tool tool, int tag, const QString &program, const QStringList &arguments, const QString &workingDirectory, int timeout, ValidatorOutputParser *parser)
+{
+    Run run;
+    run.job = job;
+    run.tool = tool;
+    run.tag = tag;
+    run.program = program;
+    run.arguments = arguments;
+    run.workingDirectory = workingDirectory;
+    run.timeout = timeout;
+    run.parser = parser;
+    run.outputTruncated = false;
+    enqueue(run);
+}
+
+void ValidatorScheduler::submitBatchable(ValidatorJob *job, Tool tool, int tag, const QString &program, const QStringList &arguments, const QString &file, const QString &workingDirectory, int timeout, ValidatorOutputParser *parser)
+{
+    Run run;
+    run.job = job;
+    run.tool = tool;
+    run.tag = tag;
+    run.program = program;
+    run.arguments = arguments;
+    run.workingDirectory = workingDirectory;
+    run.timeout = timeout;
+    run.parser = parser;
+    run.outputTruncated = false;
+    run.batchFile = file;
+    run.itemStarted = run.itemFinished = false;
+    enqueue(run);
+}
+
+void ValidatorScheduler::submitToServer(ValidatorJob *job, Tool tool, int tag, const QString &program, const QStringList &arguments, const QString &workingDirectory, const QByteArray &request, int timeout)
+{
+    Run run;
+    run.job = job;
+    run.tool = tool;
+    run.tag = tag;
+    run.program = program;
+    run.arguments = arguments;
+    run.workingDirectory = workingDirectory;
+    run.timeout = timeout;
+    run.request = request;
+    run.parser = nullptr;
+    run.outputTruncated = false;
+    enqueue(run);
+}
+
+void ValidatorScheduler::enqueue(const Run &queuedRun)
+{
+    Run run = queuedRun;
+    run.queuedTime = StageTiming::now();
+    m_mutex->lock();
+    ++m_jobs[run.job].outstandingRuns;
+    if (m_stopped) {
+        /// No run will be started anymore
+        m_mutex->unlock();
+        abortRun(run);
+        return;
+    }
+    m_queuedRuns[run.tool].enqueue(run);
+    m_mutex->unlock();
+
+    /// Processes have to be started in the scheduler's own thread
+    QMetaObject::invokeMethod(this, "startQueuedRuns", Qt::QueuedConnection);
+}
+
+void ValidatorScheduler::release(ValidatorJob *job)
+{
+    m_mutex->lock();
+    JobState &state = m_jobs[job];
+    state.released = true;
+    const bool finished = state.outstandingRuns == 0;
+    m_mutex->unlock();
+
+    if (finished) {
+        job->allToolsFinished();
+        delete job;
+
+        m_mutex->lock();
+        m_jobs.remove(job);
+        m_jobFinished->wakeAll();
+        m_mutex->unlock();
+    }
+}
+
+bool ValidatorScheduler::isRunning() const
+{
+    return m_thread->isRunning();
+}
+
+void ValidatorScheduler::shutdown()
+{
+    if (!m_thread->isRunning()) return;
+
+    m_mutex->lock();
+    int queued = 0;
+    for (int i = 0; i < numTools; ++i)
+        queued += m_queuedRuns[i].count();
+    int running = m_processes.count();
+    for (QHash<QProcess *, Batch>::ConstIterator it = m_batches.constBegin(); it != m_batches.constEnd(); ++it)
+        running += it->runs.count();
+    for (QHash<QProcess *, Server>::ConstIterator it = m_servers.constBegin(); it != m_servers.constEnd(); ++it)
+        if (it->busy) ++running;
+    m_mutex->unlock();
+    if (queued > 0 || running > 0)
+        qWarning() << "Shutting down validator scheduler with" << running << "running and" << queued << "queued validator runs";
+
+    /// Servers have to be told to quit from within the scheduler's thread
+    QMetaObject::invokeMethod(this, "stopServers", QThread::currentThread() == m_thread ? Qt::DirectConnection : Qt::BlockingQueuedConnection);
+
+    m_thread->quit();
+    m_thread->wait();
+
+    /// Processes still running will never be waited for, as their
+    /// thread is gone, so kill them and drop their runs, too
+    QList<Run> runs;
+    QList<QProcess *> processes;
+    m_mutex->lock();
+    for (QHash<QProcess *, Run>::ConstIterator it = m_processes.constBegin(); it != m_processes.constEnd(); ++it) {
+        runs.append(it.value());
+        processes.append(it.key());
+    }
+    m_processes.clear();
+    for (QHash<QProcess *, Batch>::ConstIterator it = m_batches.constBegin(); it != m_batches.constEnd(); ++it) {
+        for (const Run &run : it->runs)
+            if (!run.itemFinished) runs.append(run);
+        delete it->splitter;
+        processes.append(it.key());
+    }
+    m_batches.clear();
+    for (QHash<QProcess *, Server>::ConstIterator it = m_servers.constBegin(); it != m_servers.constEnd(); ++it) {
+        if (it->busy) runs.append(it->run);
+        processes.append(it.key());
+    }
+    m_servers.clear();
+    m_mutex->unlock();
+    for (QProcess *process : const_cast<const QList<QProcess *> &>(processes))
+        if (process->state() != QProcess::NotRunning)
+            process->kill();
+
+    /// Dropped runs, including those still queued, get finished as aborted,
+    /// so that their jobs complete and get reported; aborting may queue
+    /// further runs
+    forever {
+        m_mutex->lock();
+        m_stopped = true;
+        for (int i = 0; i < numTools; ++i) {
+            runs.append(m_queuedRuns[i]);
+            m_queuedRuns[i].clear();
+        }
+        m_mutex->unlock();
+        if (runs.isEmpty()) break;
+        for (const Run &run : const_cast<const QList<Run> &>(runs))
+            abortRun(run);
+        runs.clear();
+    }
+
+    m_mutex->lock();
+    m_jobFinished->wakeAll();
+    m_mutex->unlock();
+}
+
+void ValidatorScheduler::abortRun(const Run &run)
+{
+    ValidatorResult result;
+    result.commandLine = run.program + QChar(' ') + run.arguments.join(QChar(' '));
+    result.started = false;
+    result.timedOut = false;
+    result.terminated = false;
+    result.aborted = true;
+    result.outputTruncated = false;
+    result.exitCode = INT_MIN;
+
+    /// Runs get aborted in whichever thread shuts down or submits,
+    /// but calls for the same job must still not be concurrent
+    QMutexLocker locker(m_abortMutex);
+    run.job->toolFinished(run.tool, run.tag, result);
+    finishJobRun(run.job);
+}
+
+void ValidatorScheduler::startQueuedRuns()
+{
+    QList<QProcess *> toStart;
+    /// Time in milliseconds until the next incomplete batch is due
+    int batchDue = INT_MAX;
+
+    m_mutex->lock();
+    for (int i = 0; i < numTools; ++i)
+        while (!m_queuedRuns[i].isEmpty()) {
+            Run run = m_queuedRuns[i].head();
+            run.startTime = StageTiming::now();
+            if (!run.batchFile.isEmpty()) {
+                if (m_batchMaxFiles[i] > 1 && m_runningProcesses[i] < m_maxProcesses[i]) {
+                    /// Collect queued runs which can share a single invocation
+                    QList<int> queueIndices;
+                    for (int j = 0; j < m_queuedRuns[i].count() && queueIndices.count() < m_batchMaxFiles[i]; ++j) {
+                        const Run &other = m_queuedRuns[i].at(j);
+                        if (!other.batchFile.isEmpty() && other.program == run.program && other.arguments == run.arguments && other.workingDirectory == run.workingDirectory)
+                            queueIndices.append(j);
+                    }
+                    const int waited = static_cast<int>((run.startTime - run.queuedTime) / 1000);
+                    if (queueIndices.count() < m_batchMaxFiles[i] && waited < m_batchMaxWait[i]) {
+                        /// Wait for more files to fill this batch
+                        batchDue = qMin(batchDue, m_batchMaxWait[i] - waited);
+                        break;
+                    }
+                    if (queueIndices.count() > 1) {
+                        startBatch(static_cast<Tool>(i), queueIndices, toStart);
+                        continue;
+                    }
+                }
+                /// Validate this file on its own
+                run.arguments.append(run.batchFile);
+                run.batchFile.clear();
+            }
+            if (!run.request.isEmpty()) {
+                /// Request for a server, either idle or to be started
+                if (!dispatchToServer(run, toStart)) break;
+            } else if (m_runningProcesses[i] < m_maxProcesses[i]) {
+                ++m_runningProcesses[i];
+
+                QProcess *process = new QProcess(this);
+                if (!run.workingDirectory.isEmpty())
+                    process->setWorkingDirectory(run.workingDirectory);
+                /// Output is consumed while the program runs instead of piling up in QProcess
+                connect(process, SIGNAL(readyReadStandardOutput()), this, SLOT(runOutput()));
+                connect(process, SIGNAL(readyReadStandardError()), this, SLOT(runOutput()));
+                connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(runFinished()));
+                connect(process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(runFailed()));
+                m_processes.insert(process, run);
+                toStart.append(process);
+            } else
+                break;
+            m_queuedRuns[i].dequeue();
+        }
+    m_mutex->unlock();
+
+    if (batchDue < INT_MAX && (!m_batchTimer->isActive() || m_batchTimer->remainingTime() > batchDue))
+        m_batchTimer->start(batchDue);
+
+    /// Start processes without holding the mutex, as starting may fail
+    /// immediately and trigger runFailed() from within QProcess::start
+    for (QProcess *process : const_cast<const QList<QProcess *> &>(toStart)) {
+        m_mutex->lock();
+        const bool isServer = m_servers.contains(process);
+        const bool isBatch = m_batches.contains(process);
+        Run run = isServer ? m_servers.value(process).run : m_processes.value(process);
+        if (isBatch) {
+            const Batch &batch = m_batches[process];
+            run.program = batch.program;
+            run.arguments = batch.arguments;
+            run.timeout = batch.timeout;
+        }
+        QTimer *timer = isServer ? m_servers.value(process).timer : nullptr;
+        m_mutex->unlock();
+
+        if (isServer) {
+            timer->start(run.timeout);
+            process->start(run.program, run.arguments, QIODevice::ReadWrite);
+            if (process->state() != QProcess::NotRunning)
+                process->write(run.request + '\n');
+        } else {
+            timer = new QTimer(process);
+            timer->setSingleShot(true);
+            connect(timer, SIGNAL(timeout()), this, SLOT(runTimedOut()));
+            timer->start(run.timeout);
+            process->start(run.program, run.arguments, QIODevice::ReadOnly);
+        }
+    }
+}
+
+void ValidatorScheduler::startBatch(Tool tool, const QList<int> &queueIndices, QList<QProcess *> &toStart)
+{
+    /// Mutex is held by caller
+    ++m_runningProcesses[tool];
+
+    Batch batch;
+    batch.tool = tool;
+    batch.splitter = m_batchSplitterFactory[tool]();
+    batch.timeout = 0;
+    batch.current = -1;
+    const qint64 startTime = StageTiming::now();
+    for (int index : queueIndices) {
+        Run run = m_queuedRuns[tool].at(index);
+        run.startTime = startTime;
+        batch.runs.append(run);
+        batch.timeout += run.timeout;
+    }
+    /// Remove from the back, so that indices remain valid
+    for (int j = queueIndices.count() - 1; j >= 0; --j)
+        m_queuedRuns[tool].removeAt(queueIndices[j]);
+
+    const Run &first = batch.runs.first();
+    batch.program = first.program;
+    batch.arguments = first.arguments;
+    for (const Run &run : const_cast<const QList<Run> &>(batch.runs))
+        batch.arguments.append(run.batchFile);
+
+    QProcess *process = new QProcess(this);
+    if (!first.workingDirectory.isEmpty())
+        process->setWorkingDirectory(first.workingDirectory);
+    connect(process, SIGNAL(readyReadStandardOutput()), this, SLOT(batchOutput()));
+    connect(process, SIGNAL(readyReadStandardError()), this, SLOT(batchOutput()));
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(batchFinished()));
+    connect(process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(batchFailed()));
+    m_batches.insert(process, batch);
+    toStart.append(process);
+}
+
+bool ValidatorScheduler::dispatchToServer(const Run &run, QList<QProcess *> &toStart)
+{
+    /// Mutex is held by caller
+    const QString key = run.program + QChar('\n') + run.arguments.join(QChar('\n')) + QChar('\n') + run.workingDirectory;
+
+    QProcess *process = nullptr;
+    for (QHash<QProcess *, Server>::ConstIterator it = m_servers.constBegin(); process == nullptr && it != m_servers.constEnd(); ++it)
+        if (!it->busy && !it->retiring && it->key == key)
+            process = it.key();
+
+    if (process == nullptr) {
+        /// No idle server available, so start a new one if permitted
+        if (m_runningProcesses[run.tool] >= m_maxProcesses[run.tool])
+            return false;
+        ++m_runningProcesses[run.tool];
+
+        process = new QProcess(this);
+        if (!run.workingDirectory.isEmpty())
+            process->setWorkingDirectory(run.workingDirectory);
+        /// Servers report errors as part of each result
+        process->setStandardErrorFile(QProcess::nullDevice());
+        connect(process, SIGNAL(readyReadStandardOutput()), this, SLOT(serverOutput()));
+        connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(serverFinished()));
+        connect(process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(serverFailed()));
+
+        Server server;
+        server.tool = run.tool;
+        server.key = key;
+        server.numRequests = 0;
+        server.retiring = false;
+        server.timer = new QTimer(process);
+        server.timer->setSingleShot(true);
+        connect(server.timer, SIGNAL(timeout()), this, SLOT(runTimedOut()));
+        server.busy = true;
+        server.run = run;
+        m_servers.insert(process, server);
+        toStart.append(process);
+    } else {
+        Server &server = m_servers[process];
+        server.busy = true;
+        server.run = run;
+        server.buffer.clear();
+        server.timer->start(run.timeout);
+        process->write(run.request + '\n');
+    }
+
+    return true;
+}
+
+void ValidatorScheduler::runOutput()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process != nullptr)
+        readRunOutput(process);
+}
+
+void ValidatorScheduler::appendOutput(Run &run, const QByteArray &output, const QByteArray &error, int maxOutputSize)
+{
+    /// Keep only the beginning of long output
+    if (run.standardOutput.length() + output.length() > maxOutputSize || run.standardError.length() + error.length() > maxOutputSize)
+        run.outputTruncated = true;
+    run.standardOutput.append(output.left(maxOutputSize - run.standardOutput.length()));
+    run.standardError.append(error.left(maxOutputSize - run.standardError.length()));
+}
+
+void ValidatorScheduler::readRunOutput(QProcess *process)
+{
+    const QByteArray output = process->readAllStandardOutput();
+    const QByteArray error = process->readAllStandardError();
+    if (output.isEmpty() && error.isEmpty()) return;
+
+    m_mutex->lock();
+    QHash<QProcess *, Run>::Iterator it = m_processes.find(process);
+    if (it == m_processes.end()) {
+        /// Run was already finished
+        m_mutex->unlock();
+        return;
+    }
+    appendOutput(*it, output, error, m_maxOutputSize);
+    ValidatorOutputParser *parser = it->parser;
+    m_mutex->unlock();
+
+    /// Parser belongs to the job, which is not accessed by others while the run is active
+    if (parser != nullptr && !output.isEmpty())
+        parser->addData(output);
+}
+
+void ValidatorScheduler::runFinished()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process != nullptr)
+        finishRun(process, true);
+}
+
+void ValidatorScheduler::runFailed()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    /// Other errors like crashes will be followed by signal 'finished'
+    if (process != nullptr && process->error() == QProcess::FailedToStart)
+        finishRun(process, false);
+}
+
+void ValidatorScheduler::runTimedOut()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender()->parent());
+    if (process == nullptr) return;
+
+    m_mutex->lock();
+    m_timedOutProcesses.insert(process);
+    m_mutex->unlock();
+    /// Killing the process will emit 'finished'
+    process->kill();
+}
+
+void ValidatorScheduler::finishRun(QProcess *process, bool started)
+{
+    /// Output not yet announced via readyRead signals
+    if (started)
+        readRunOutput(process);
+
+    m_mutex->lock();
+    if (!m_processes.contains(process)) {
+        /// Run was already finished
+        m_mutex->unlock();
+        return;
+    }
+    const Run run = m_processes.take(process);
+    --m_runningProcesses[run.tool];
+    ValidatorResult result;
+    result.timedOut = m_timedOutProcesses.remove(process);
+    result.terminated = false;
+    result.aborted = false;
+    m_mutex->unlock();
+
+    result.commandLine = run.program + QChar(' ') + run.arguments.join(QChar(' '));
+    result.started = started;
+    result.exitCode = started ? process->exitCode() : INT_MIN;
+    result.standardOutput = run.standardOutput;
+    result.standardError = run.standardError;
+    result.outputTruncated = run.outputTruncated;
+    process->deleteLater();
+
+    if (run.parser != nullptr)
+        run.parser->finish();
+
+    recordRunTime(run);
+    run.job->toolFinished(run.tool, run.tag, result);
+    finishJobRun(run.job);
+
+    startQueuedRuns();
+}
+
+void ValidatorScheduler::batchOutput()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process != nullptr)
+        readBatchOutput(process);
+}
+
+void ValidatorScheduler::batchFinished()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process != nullptr)
+        finishBatch(process, true);
+}
+
+void ValidatorScheduler::batchFailed()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    /// Other errors like crashes will be followed by signal 'finished'
+    if (process != nullptr && process->error() == QProcess::FailedToStart)
+        finishBatch(process, false);
+}
+
+void ValidatorScheduler::readBatchOutput(QProcess *process)
+{
+    const QByteArray output = process->readAllStandardOutput();
+    const QByteArray error = process->readAllStandardError();
+    if (output.isEmpty() && error.isEmpty()) return;
+
+    m_mutex->lock();
+    QHash<QProcess *, Batch>::Iterator it = m_batches.find(process);
+    if (it == m_batches.end()) {
+        /// Batch was already finished
+        m_mutex->unlock();
+        return;
+    }
+    /// Batches get inserted and removed in this thread only,
+    /// so the reference stays valid without holding the mutex
+    Batch &batch = *it;
+    /// Error messages cannot be attributed to files reliably,
+    /// so they go to the file whose report is being received
+    if (batch.current >= 0)
+        appendOutput(batch.runs[batch.current], QByteArray(), error, m_maxOutputSize);
+    m_mutex->unlock();
+
+    if (!output.isEmpty())
+        deliverBatchSegments(batch, batch.splitter->addData(output));
+}
+
+void ValidatorScheduler::deliverBatchSegments(Batch &batch, const QList<ValidatorBatchSplitter::Segment> &segments)
+{
+    m_mutex->lock();
+    const int maxOutputSize = m_maxOutputSize;
+    m_mutex->unlock();
+
+    for (const ValidatorBatchSplitter::Segment &segment : segments) {
+        if (batch.currentFile.isNull() || segment.file != batch.currentFile) {
+            /// Report for another file begins
+            batch.currentFile = segment.file;
+            batch.current = findBatchRun(batch, segment.file);
+            if (batch.current >= 0)
+                batch.runs[batch.current].itemStarted = true;
+            else
+                qWarning() << "Validator reported on unexpected file" << segment.file;
+        }
+        if (batch.current < 0) continue;
+
+        Run &run = batch.runs[batch.current];
+        appendOutput(run, segment.data, QByteArray(), maxOutputSize);
+        if (run.parser != nullptr && !segment.data.isEmpty())
+            run.parser->addData(segment.data);
+        if (segment.complete) {
+            finishBatchRun(batch, batch.current);
+            batch.current = -1;
+            batch.currentFile = QString();
+        }
+    }
+}
+
+int ValidatorScheduler::findBatchRun(const Batch &batch, const QString &file) const
+{
+    /// Validators may print file names as given or as absolute paths
+    for (int j = 0; j < batch.runs.count(); ++j)
+        if (!batch.runs[j].itemStarted && batch.runs[j].batchFile == file)
+            return j;
+    const QFileInfo fileInfo(file);
+    for (int j = 0; j < batch.runs.count(); ++j)
+        if (!batch.runs[j].itemStarted) {
+            const QFileInfo runFileInfo(batch.runs[j].batchFile);
+            if (runFileInfo.absoluteFilePath() == fileInfo.absoluteFilePath() || (!fileInfo.canonicalFilePath().isEmpty() && runFileInfo.canonicalFilePath() == fileInfo.canonicalFilePath()))
+                return j;
+        }
+    return -1;
+}
+
+void ValidatorScheduler::finishBatchRun(Batch &batch, int index)
+{
+    Run &run = batch.runs[index];
+    run.itemFinished = true;
+    if (run.parser != nullptr)
+        run.parser->finish();
+
+    ValidatorResult result;
+    result.commandLine = batch.program + QChar(' ') + batch.arguments.join(QChar(' '));
+    result.started = true;
+    result.timedOut = false;
+    result.terminated = false;
+    result.aborted = false;
+    result.outputTruncated = run.outputTruncated;
+    /// Batch's exit code may reflect other files' results
+    result.exitCode = 0;
+    result.standardOutput = run.standardOutput;
+    result.standardError = run.standardError;
+
+    recordRunTime(run);
+    run.job->toolFinished(run.tool, run.tag, result);
+    finishJobRun(run.job);
+}
+
+void ValidatorScheduler::finishBatch(QProcess *process, bool started)
+{
+    /// Output not yet announced via readyRead signals
+    if (started)
+        readBatchOutput(process);
+
+    m_mutex->lock();
+    if (!m_batches.contains(process)) {
+        /// Batch was already finished
+        m_mutex->unlock();
+        return;
+    }
+    Batch batch = m_batches.take(process);
+    --m_runningProcesses[batch.tool];
+    const bool timedOut = m_timedOutProcesses.remove(process);
+    m_mutex->unlock();
+
+    /// Output of a crashed or killed validator may end within a file's report
+    if (started && !timedOut && process->exitStatus() == QProcess::NormalExit)
+        deliverBatchSegments(batch, batch.splitter->finish());
+    delete batch.splitter;
+    process->deleteLater();
+
+    /// Files without a complete report get validated on their own,
+    /// ahead of runs queued in the meantime
+    int numFallbacks = 0;
+    m_mutex->lock();
+    for (int j = batch.runs.count() - 1; j >= 0; --j) {
+        Run run = batch.runs[j];
+        if (run.itemFinished) continue;
+        if (run.itemStarted && run.parser != nullptr)
+            run.parser->reset();
+        run.arguments.append(run.batchFile);
+        run.batchFile.clear();
+        run.standardOutput.clear();
+        run.standardError.clear();
+        run.outputTruncated = false;
+        m_queuedRuns[batch.tool].prepend(run);
+        ++numFallbacks;
+    }
+    m_mutex->unlock();
+    if (numFallbacks > 0)
+        qWarning() << "Validator" << toolNames[batch.tool] << (!started ? "failed to start" : (timedOut ? "exceeded time limit" : "did not report")) << "for" << numFallbacks << "of" << batch.runs.count() << "files in batch, validating them one by one";
+
+    startQueuedRuns();
+}
+
+void ValidatorScheduler::serverOutput()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process == nullptr) return;
+    const QByteArray data = process->readAllStandardOutput();
+
+    m_mutex->lock();
+    QHash<QProcess *, Server>::Iterator it = m_servers.find(process);
+    if (it == m_servers.end() || !it->busy) {
+        /// Output not belonging to any request
+        m_mutex->unlock();
+        return;
+    }
+    it->buffer.append(data);
+
+    ValidatorResult result;
+    bool complete = false;
+    int eol;
+    while (!complete && (eol = it->buffer.indexOf('\n')) >= 0) {
+        static const QByteArray resultHeader("@@RESULT ");
+        if (!it->buffer.startsWith(resultHeader)) {
+            /// Skip anything not being a result header, e.g. start-up messages
+            it->buffer.remove(0, eol + 1);
+            continue;
+        }
+
+        const QList<QByteArray> fields = it->buffer.left(eol).mid(resultHeader.length()).split(' ');
+        bool ok1 = false, ok2 = false, ok3 = false;
+        const int exitCode = fields.count() == 3 ? fields[0].toInt(&ok1) : 0;
+        const int outputLength = fields.count() == 3 ? fields[1].toInt(&ok2) : 0;
+        const int errorLength = fields.count() == 3 ? fields[2].toInt(&ok3) : 0;
+        if (!ok1 || !ok2 || !ok3 || outputLength < 0 || errorLength < 0) {
+            qWarning() << "Malformed result header from validator server:" << it->buffer.left(eol);
+            it->buffer.remove(0, eol + 1);
+            continue;
+        }
+        if (it->buffer.length() < eol + 1 + outputLength + errorLength)
+            /// Wait for remaining output
+            break;
+
+        result.started = true;
+        result.timedOut = false;
+        result.terminated = false;
+        result.aborted = false;
+        result.outputTruncated = false;
+        result.exitCode = exitCode;
+        result.standardOutput = it->buffer.mid(eol + 1, outputLength);
+        result.standardError = it->buffer.mid(eol + 1 + outputLength, errorLength);
+        it->buffer.clear();
+        complete = true;
+    }
+    m_mutex->unlock();
+
+    if (complete)
+        finishServerRequest(process, result);
+}
+
+void ValidatorScheduler::serverFinished()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process != nullptr)
+        serverTerminated(process, true);
+}
+
+void ValidatorScheduler::serverFailed()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    /// Other errors like crashes will be followed by signal 'finished'
+    if (process != nullptr && process->error() == QProcess::FailedToStart)
+        serverTerminated(process, false);
+}
+
+void ValidatorScheduler::stopServers()
+{
+    QList<QProcess *> processes;
+    m_mutex->lock();
+    for (QHash<QProcess *, Server>::Iterator it = m_servers.begin(); it != m_servers.end(); ++it) {
+        it->retiring = true;
+        processes.append(it.key());
+    }
+    m_mutex->unlock();
+
+    /// Servers quit once their input is closed
+    for (QProcess *process : const_cast<const QList<QProcess *> &>(processes))
+        process->closeWriteChannel();
+}
+
+void ValidatorScheduler::finishServerRequest(QProcess *process, ValidatorResult &result)
+{
+    m_mutex->lock();
+    Server &server = m_servers[process];
+    const Run run = server.run;
+    server.busy = false;
+    server.timer->stop();
+    ++server.numRequests;
+    /// Long-running processes may accumulate memory, so replace them from time to time
+    server.retiring = server.numRequests >= m_serverMaxRequests || (m_serverMaxMemoryMiB > 0 && residentMemoryMiB(process) > m_serverMaxMemoryMiB);
+    const bool retiring = server.retiring;
+    m_mutex->unlock();
+
+    if (retiring)
+        /// Server will quit once its input is closed
+        process->closeWriteChannel();
+
+    result.commandLine = run.program + QChar(' ') + run.arguments.join(QChar(' ')) + QStringLiteral(" <<< ") + QString::fromUtf8(run.request);
+    recordRunTime(run);
+    run.job->toolFinished(run.tool, run.tag, result);
+    finishJobRun(run.job);
+
+    startQueuedRuns();
+}
+
+void ValidatorScheduler::serverTerminated(QProcess *process, bool started)
+{
+    m_mutex->lock();
+    if (!m_servers.contains(process)) {
+        /// Server was already removed
+        m_mutex->unlock();
+        return;
+    }
+    const Server server = m_servers.take(process);
+    --m_runningProcesses[server.tool];
+    ValidatorResult result;
+    result.timedOut = m_timedOutProcesses.remove(process);
+    m_mutex->unlock();
+
+    process->deleteLater();
+
+    if (server.busy) {
+        /// Server quit, crashed, or got killed while handling a request
+        result.commandLine = server.run.program + QChar(' ') + server.run.arguments.join(QChar(' ')) + QStringLiteral(" <<< ") + QString::fromUtf8(server.run.request);
+        result.started = started;
+        result.terminated = true;
+        result.aborted = false;
+        result.outputTruncated = false;
+        result.exitCode = started ? process->exitCode() : INT_MIN;
+        if (started)
+            result.standardError = QByteArrayLiteral("Validator server terminated while handling request");
+        recordRunTime(server.run);
+        server.run.job->toolFinished(server.run.tool, server.run.tag, result);
+        finishJobRun(server.run.job);
+    }
+
+    startQueuedRuns();
+}
+
+int ValidatorScheduler::residentMemoryMiB(QProcess *process) const
+{
+    /// Only available on Linux, returns 0 elsewhere
+    QFile status(QString(QStringLiteral("/proc/%1/status")).arg(process->processId()));
+    if (!status.open(QFile::ReadOnly))
+        return 0;
+    const QByteArray text = status.readAll();
+    const int p1 = text.indexOf("VmRSS:");
+    if (p1 < 0) return 0;
+    const int p2 = text.indexOf('\n', p1);
+    /// Value is given in kB
+    return text.mid(p1 + 6, p2 - p1 - 6).replace("kB", "").trimmed().toInt() / 1024;
+}
+
+void ValidatorScheduler::recordRunTime(const Run &run)
+{
+    const QString tool = QString::fromLatin1(toolNames[run.tool]);
+    const qint64 runTime = StageTiming::now() - run.startTime;
+    /// Waiting for a free process slot tells if limits are too tight
+    StageTiming::instance()->record(QStringLiteral("validator-queue:") + tool, run.startTime - run.queuedTime);
+    StageTiming::instance()->record(QStringLiteral("validator:") + tool, runTime);
+
+    /// Recent runs weigh more, as files of a run tend to be similar
+    m_mutex->lock();
+    qint64 &average = m_averageRunTime[run.tool];
+    average = average == 0 ? runTime : (average * 7 + runTime) / 8;
+    m_mutex->unlock();
+}
+
+void ValidatorScheduler::finishJobRun(ValidatorJob *job)
+{
+    m_mutex->lock();
+    JobState &state = m_jobs[job];
+    --state.outstandingRuns;
+    const bool finished = state.released && state.outstandingRuns == 0;
+    m_mutex->unlock();
+
+    if (finished) {
+        job->allToolsFinished();
+        delete job;
+
+        m_mutex->lock();
+        m_jobs.remove(job);
+        m_jobFinished->wakeAll();
+        m_mutex->unlock();
+    }
+}
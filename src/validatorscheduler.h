@@ -0,0 +1,442 @@
+/*
+    This file is part of DocScan.
+
+    DocScan is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    DocScan is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with DocScan.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Copyright (2017) Thomas Fischer <thomas.fischer@his.se>, senior
+    lecturer at University of Skövde, as part of the LIM-IT project.
+
+ */
+
+#ifndef VALIDATORSCHEDULER_H
+#define VALIDATORSCHEDULER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QQueue>
+#include <QHash>
+#include <QSet>
+
+class QThread;
+class QMutex;
+class QWaitCondition;
+class QProcess;
+class QTimer;
+
+/**
+ * Outcome of a single run of an external validator program.
+ */
+struct ValidatorResult {
+    /// Command line as started, for diagnostic messages
+    QString commandLine;
+    /// 'false' if the program could not be started at all
+    bool started;
+    /// 'true' if the program got killed for exceeding its time limit
+    bool timedOut;
+    /// 'true' if a server quit or crashed while handling the request
+    bool terminated;
+    /// 'true' if the run got dropped, queued or running, as the scheduler got shut down
+    bool aborted;
+    /// 'true' if output exceeded the limit and only its beginning is kept
+    bool outputTruncated;
+    int exitCode;
+    QByteArray standardOutput, standardError;
+};
+
+/**
+ * Receives a validator's standard output piece by piece while the
+ * program is still running, so that results can be extracted without
+ * keeping all output in memory. Called in the scheduler's thread.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class ValidatorOutputParser
+{
+public:
+    virtual ~ValidatorOutputParser();
+
+    /**
+     * Next chunk of output, may end anywhere, e.g. within a line.
+     */
+    virtual void addData(const QByteArray &data) = 0;
+
+    /**
+     * Program has finished, no more output will follow.
+     */
+    virtual void finish();
+
+    /**
+     * Discard everything received so far, as the output will be
+     * received once more, e.g. if the file is validated on its own
+     * after validating a batch of files failed.
+     */
+    virtual void reset() = 0;
+};
+
+/**
+ * Splits the output of a validator run over a batch of files into
+ * the reports for the individual files. A new instance is used for
+ * each batch. Called in the scheduler's thread.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class ValidatorBatchSplitter
+{
+public:
+    struct Segment {
+        /// File as named in the validator's output
+        QString file;
+        QByteArray data;
+        /// 'true' if this is the last segment of this file's report
+        bool complete;
+    };
+
+    virtual ~ValidatorBatchSplitter();
+
+    /**
+     * Next chunk of the batch's standard output, may end anywhere.
+     * Output not belonging to any file is dropped.
+     *
+     * @return segments of file reports contained in or completed by this chunk
+     */
+    virtual QList<Segment> addData(const QByteArray &data) = 0;
+
+    /**
+     * Program has finished, no more output will follow.
+     *
+     * @return remaining segments
+     */
+    virtual QList<Segment> finish() = 0;
+};
+
+/**
+ * All validator runs for one file. Instances are passed to a
+ * ValidatorScheduler which takes ownership and deletes them
+ * once all runs are finished and allToolsFinished() returned.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class ValidatorJob
+{
+public:
+    virtual ~ValidatorJob();
+
+    /**
+     * A single validator run for this job has finished.
+     * Called in the scheduler's thread, or for runs aborted due to
+     * shutdown in the thread calling ValidatorScheduler::shutdown()
+     * or submitting the run; calls for the same job are never
+     * concurrent. Further runs for this job may be submitted
+     * from here, e.g. to validate a different profile.
+     *
+     * @param tool tool as specified when submitting the run
+     * @param tag arbitrary value as specified when submitting the run
+     * @param result outcome of the run
+     */
+    virtual void toolFinished(int tool, int tag, const ValidatorResult &result) = 0;
+
+    /**
+     * All runs submitted for this job have finished and the job has
+     * been released. Called either in the scheduler's thread or in the
+     * thread calling ValidatorScheduler::release(..).
+     */
+    virtual void allToolsFinished() = 0;
+};
+
+/**
+ * Runs external validator programs such as veraPDF or jHove
+ * asynchronously in a dedicated thread, limiting the number of
+ * concurrently running processes for each tool. Runs from many
+ * files (and many analyzer threads) get queued per tool, so that
+ * validators for different files run in parallel while analyzers
+ * continue with other work.
+ *
+ * A job's life cycle is: addJob(..), any number of submit(..)
+ * or submitToServer(..), release(..). Once released and all its
+ * runs are finished, the job's ValidatorJob::allToolsFinished()
+ * is called.
+ *
+ * Tools that support it can be kept running as servers which
+ * receive one request per line on standard input and answer each
+ * request with a header line '@@RESULT <exitcode> <stdout length>
+ * <stderr length>' followed by exactly that many bytes of output.
+ * This saves the start-up cost (e.g. of a JVM) for every file.
+ * Servers are recycled after a number of requests or once their
+ * memory usage grows too large.
+ *
+ * Tools accepting many files per invocation can validate files in
+ * batches instead, see setBatching(..). Runs submitted via
+ * submitBatchable(..) are collected until a batch is full or the
+ * oldest run has waited long enough. Each batch's output is split
+ * into the reports for the individual files; files without a
+ * complete report, e.g. because the batch crashed or timed out,
+ * get validated once more on their own.
+ *
+ * @author Thomas Fischer <thomas.fischer@his.se>
+ */
+class ValidatorScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    /// PopplerWorker is no validator, but DocScan itself analyzing files in separate processes
+    enum Tool {VeraPDF = 0, CallasPdfAPilot = 1, JHove = 2, PdfBoxValidator = 3, PopplerWorker = 4};
+    static const int numTools;
+
+    /// Creates a splitter for a new batch, see setBatching(..)
+    typedef ValidatorBatchSplitter *(*BatchSplitterFactory)();
+
+    /**
+     * Process-wide scheduler instance, created on first use.
+     */
+    static ValidatorScheduler *instance();
+
+    ~ValidatorScheduler();
+
+    /**
+     * Set the maximum number of processes for a tool that may run
+     * at the same time. Default is the number of CPU cores.
+     */
+    void setMaxProcesses(Tool tool, int maxProcesses);
+
+    /**
+     * Set the maximum number of jobs that may be pending at the
+     * same time, see waitForCapacity(). Default is four times the
+     * number of CPU cores.
+     */
+    void setMaxPendingJobs(int maxPendingJobs);
+
+    /**
+     * Enable or disable running a tool as a long-running server,
+     * see submitToServer(..). Disabled by default.
+     */
+    void setServerMode(Tool tool, bool enabled);
+    bool serverMode(Tool tool) const;
+
+    /**
+     * Set when server processes get replaced by fresh ones.
+     *
+     * @param maxRequests number of requests after which a server is recycled
+     * @param maxMemoryMiB resident memory in MiB above which a server is recycled; 0 for no limit
+     */
+    void setServerRecycling(int maxRequests, int maxMemoryMiB);
+
+    /**
+     * Set how many bytes of a run's standard output and error are kept
+     * in ValidatorResult, see ValidatorResult::outputTruncated. Output
+     * beyond is still passed to the run's ValidatorOutputParser.
+     * Does not apply to servers. Default is 64 KiB.
+     */
+    void setMaxOutputSize(int maxOutputSize);
+
+    /**
+     * Enable or disable validating several files per run of a tool,
+     * see submitBatchable(..). Disabled by default.
+     *
+     * @param maxFiles maximum number of files per batch; 1 or less disables batching
+     * @param maxWait time in milliseconds a run may wait for further files to fill its batch
+     * @param factory creates the splitter for each batch's output
+     */
+    void setBatching(Tool tool, int maxFiles, int maxWait, BatchSplitterFactory factory);
+
+    /**
+     * Moving average of the time a tool's runs took recently,
+     * excluding time spent in the queue.
+     *
+     * @return time in microseconds; 0 if no run has finished yet
+     */
+    qint64 averageRunTime(Tool tool) const;
+
+    /**
+     * Block until the number of pending jobs is below the limit
+     * set by setMaxPendingJobs(..) or the scheduler got shut down.
+     * No events are processed while waiting.
+     */
+    void waitForCapacity();
+
+    /**
+     * Register a new job. The scheduler takes ownership of the job.
+     */
+    void addJob(ValidatorJob *job);
+
+    /**
+     * Queue a run of an external program for a job.
+     * May be called from any thread.
+     *
+     * @param job job as registered via addJob(..)
+     * @param tool tool whose concurrency limit applies
+     * @param tag arbitrary value passed back in ValidatorJob::toolFinished
+     * @param program program to start
+     * @param arguments arguments for the program
+     * @param workingDirectory working directory; current directory if empty
+     * @param timeout time in milliseconds before the running process gets killed
+     * @param parser if not null, receives standard output while the program runs; owned by the job
+     */
+    void submit(ValidatorJob *job, Tool tool, int tag, const QString &program, const QStringList &arguments, const QString &workingDirectory, int timeout, ValidatorOutputParser *parser = nullptr);
+
+    /**
+     * Queue a run of an external program validating a single file,
+     * which may be combined with runs for other files sharing the
+     * same program, arguments, and working directory if batching is
+     * enabled for the tool. The file is passed as last argument.
+     * The exit code reported for a file validated as part of a batch
+     * is 0 if its report was complete. Parameters are as for submit(..).
+     *
+     * @param file file to validate, passed after the other arguments
+     * @param timeout time in milliseconds for this file; a batch's time limit is the sum for all its files
+     */
+    void submitBatchable(ValidatorJob *job, Tool tool, int tag, const QString &program, const QStringList &arguments, const QString &file, const QString &workingDirectory, int timeout, ValidatorOutputParser *parser = nullptr);
+
+    /**
+     * Queue a request for a server process. An idle server started
+     * with the same program, arguments and working directory will
+     * be reused, otherwise a new one is started if the tool's process
+     * limit permits. Parameters are as for submit(..).
+     *
+     * @param request single line (without line break) written to the server's standard input
+     * @param timeout time in milliseconds for this request before the server gets killed
+     */
+    void submitToServer(ValidatorJob *job, Tool tool, int tag, const QString &program, const QStringList &arguments, const QString &workingDirectory, const QByteArray &request, int timeout);
+
+    /**
+     * Notify that no further runs will be submitted for a job except
+     * from within ValidatorJob::toolFinished. If all runs are already
+     * finished, ValidatorJob::allToolsFinished is called immediately
+     * in the calling thread.
+     */
+    void release(ValidatorJob *job);
+
+    /**
+     * Test if the scheduler's thread is still processing runs.
+     */
+    bool isRunning() const;
+
+public slots:
+    /**
+     * Stop the scheduler's thread. Runs still queued or submitted
+     * later will not be started anymore and running processes get
+     * killed. Such runs finish with ValidatorResult::aborted set,
+     * so that their jobs complete.
+     * Should be called before the application exits.
+     */
+    void shutdown();
+
+private slots:
+    void startQueuedRuns();
+    void runOutput();
+    void runFinished();
+    void runFailed();
+    void runTimedOut();
+    void batchOutput();
+    void batchFinished();
+    void batchFailed();
+    void serverOutput();
+    void serverFinished();
+    void serverFailed();
+    void stopServers();
+
+private:
+    struct Run {
+        ValidatorJob *job;
+        Tool tool;
+        int tag;
+        QString program;
+        QStringList arguments;
+        QString workingDirectory;
+        int timeout;
+        /// Non-empty for runs handled by a server process
+        QByteArray request;
+        ValidatorOutputParser *parser;
+        /// Output received so far, up to the size limit
+        QByteArray standardOutput, standardError;
+        bool outputTruncated;
+        /// Non-empty for runs that may be part of a batch
+        QString batchFile;
+        /// Progress of this file's report within a batch's output
+        bool itemStarted, itemFinished;
+        /// When the run got queued and started, see StageTiming::now()
+        qint64 queuedTime, startTime;
+    };
+    struct Server {
+        Tool tool;
+        /// Program, arguments and working directory the server was started with
+        QString key;
+        int numRequests;
+        bool busy, retiring;
+        Run run;
+        QByteArray buffer;
+        QTimer *timer;
+    };
+    struct Batch {
+        Tool tool;
+        QList<Run> runs;
+        ValidatorBatchSplitter *splitter;
+        QString program;
+        QStringList arguments;
+        int timeout;
+        /// Run receiving the current file's report or -1 if none
+        int current;
+        QString currentFile;
+    };
+    struct JobState {
+        int outstandingRuns;
+        bool released;
+    };
+
+    QThread *m_thread;
+    QMutex *m_mutex;
+    /// Serializes finishing runs aborted due to shutdown
+    QMutex *m_abortMutex;
+    /// Set once shutdown() has stopped the scheduler's thread
+    bool m_stopped;
+    QWaitCondition *m_jobFinished;
+    QQueue<Run> *m_queuedRuns;
+    int *m_runningProcesses, *m_maxProcesses;
+    int m_maxPendingJobs;
+    bool *m_serverMode;
+    int m_serverMaxRequests, m_serverMaxMemoryMiB;
+    int m_maxOutputSize;
+    int *m_batchMaxFiles, *m_batchMaxWait;
+    qint64 *m_averageRunTime;
+    BatchSplitterFactory *m_batchSplitterFactory;
+    /// Wakes up the scheduler once a waiting batch is due
+    QTimer *m_batchTimer;
+    QHash<QProcess *, Batch> m_batches;
+    QHash<QProcess *, Server> m_servers;
+    QHash<ValidatorJob *, JobState> m_jobs;
+    QHash<QProcess *, Run> m_processes;
+    QSet<QProcess *> m_timedOutProcesses;
+
+    explicit ValidatorScheduler();
+
+    void enqueue(const Run &run);
+    bool dispatchToServer(const Run &run, QList<QProcess *> &toStart);
+    void startBatch(Tool tool, const QList<int> &queueIndices, QList<QProcess *> &toStart);
+    static void appendOutput(Run &run, const QByteArray &output, const QByteArray &error, int maxOutputSize);
+    void readRunOutput(QProcess *process);
+    void readBatchOutput(QProcess *process);
+    void deliverBatchSegments(Batch &batch, const QList<ValidatorBatchSplitter::Segment> &segments);
+    int findBatchRun(const Batch &batch, const QString &file) const;
+    void finishBatchRun(Batch &batch, int index);
+    void finishBatch(QProcess *process, bool started);
+    void finishRun(QProcess *process, bool started);
+    void finishServerRequest(QProcess *process, ValidatorResult &result);
+    void serverTerminated(QProcess *process, bool started);
+    int residentMemoryMiB(QProcess *process) const;
+    void finishJobRun(ValidatorJob *job);
+    void abortRun(const Run &run);
+    void recordRunTime(const Run &run);
+};
+
+#endif // VALIDATORSCHEDULER_H
@@ -28,9 +28,11 @@
 #include "watchable.h"
 
 static const int countDownInit = 6;
+/// Grace period in seconds if pipeline reports its completion itself
+static const int drainTrackingCountDownInit = 60;
 
 WatchDog::WatchDog(QObject *parent)
-    : QObject(parent), m_countDown(countDownInit)
+    : QObject(parent), m_countDownInit(countDownInit), m_countDown(countDownInit), m_drainTracking(false)
 {
     connect(&m_timer, SIGNAL(timeout()), this, SLOT(watch()));
     m_timer.setInterval(1000);
@@ -42,6 +44,23 @@ void WatchDog::addWatchable(Watchable *watchable)
     m_watchables << watchable;
 }
 
+void WatchDog::setDrainTracking(bool enabled)
+{
+    m_drainTracking = enabled;
+    m_countDown = m_countDownInit = enabled ? drainTrackingCountDownInit : countDownInit;
+}
+
+void WatchDog::pipelineDrained()
+{
+    if (!m_timer.isActive()) return; ///< quit sequence already issued
+
+    m_timer.stop();
+    qDebug() << "Watchdog got notified that pipeline is drained, quit now";
+    emit firstWarning();
+    emit lastWarning();
+    emit quit();
+}
+
 void WatchDog::watch()
 {
     bool anyAlive = false;
@@ -51,14 +70,16 @@ void WatchDog::watch()
     }
 
     if (anyAlive)
-        m_countDown = countDownInit;
+        m_countDown = m_countDownInit;
     else
         --m_countDown;
 
-    if (m_countDown == countDownInit * 2 / 3) {
+    if (m_countDown == m_countDownInit * 2 / 3) {
+        if (m_drainTracking)
+            qWarning() << "Nothing alive for" << (m_countDownInit - m_countDown) << "seconds, but pipeline did not report to be drained";
         qDebug() << "Watchdog gives first warning";
         emit firstWarning();
-    } else if (m_countDown == countDownInit / 3) {
+    } else if (m_countDown == m_countDownInit / 3) {
         qDebug() << "Watchdog gives last warning";
         emit lastWarning();
     } else  if (m_countDown == 0) {
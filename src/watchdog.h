@@ -35,6 +35,9 @@ class Watchable;
  * of monitored objects. The watch dog object will test the objects in
  * regular intervals if they alive. If no object is alive, a sequence of
  * signals will be issued.
+ * If the processing pipeline reports its completion explicitly (see
+ * pipelineDrained()), the sequence of signals is issued immediately and
+ * the regular test only serves as a fallback to detect hangs.
  *
  * @author Thomas Fischer <thomas.fischer@his.se>
  */
@@ -52,6 +55,15 @@ public:
      */
     void addWatchable(Watchable *watchable);
 
+    /**
+     * Notify the watch dog that the processing pipeline will report
+     * its completion via pipelineDrained(). Objects no longer being
+     * alive will then only trigger the sequence of signals after a
+     * much longer grace period, as this indicates that the pipeline
+     * hangs or has lost track of some work item.
+     */
+    void setDrainTracking(bool enabled);
+
 signals:
     /**
      * First warning issued if all objects are no longer alive
@@ -73,10 +85,20 @@ signals:
      */
     void quit();
 
+public slots:
+    /**
+     * Notification that the last stage of the processing pipeline
+     * has processed all work items. Issues the sequence of signals
+     * firstWarning(), lastWarning(), and quit() immediately.
+     */
+    void pipelineDrained();
+
 private:
     QTimer m_timer;
     QSet<Watchable *> m_watchables;
+    int m_countDownInit;
     int m_countDown;
+    bool m_drainTracking;
 
 private slots:
     void watch();
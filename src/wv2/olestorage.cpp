@@ -26,12 +26,24 @@ using namespace wvWare;
 OLEStorage::OLEStorage()
     : m_storage(0)
     , m_fileName("")
+    , m_data(0)
+    , m_size(0)
 {
 }
 
 OLEStorage::OLEStorage(const std::string &fileName)
     : m_storage(0)
     , m_fileName(fileName)
+    , m_data(0)
+    , m_size(0)
+{
+}
+
+OLEStorage::OLEStorage(const char *data, size_t size)
+    : m_storage(0)
+    , m_fileName("")
+    , m_data(data)
+    , m_size(size)
 {
 }
 
@@ -44,7 +56,10 @@ bool OLEStorage::open(Mode mode)
 {
     Q_UNUSED(mode)
     if (!m_storage) {
-        m_storage = new POLE::Storage(m_fileName.c_str());
+        if (m_data)
+            m_storage = new POLE::Storage(reinterpret_cast<const unsigned char *>(m_data), m_size);
+        else
+            m_storage = new POLE::Storage(m_fileName.c_str());
     }
 
     return m_storage->open();
@@ -63,6 +63,12 @@ public:
      * right now, call @see open() to do that
      */
     OLEStorage(const std::string &fileName);
+    /**
+     * Use a storage held in memory. The data is not copied and
+     * has to stay valid as long as the storage is open. Only
+     * ReadOnly mode is supported.
+     */
+    OLEStorage(const char *data, size_t size);
 
     /**
      * Destroy the current storage. Open streams on it will
@@ -121,6 +127,8 @@ private:
     POLE::Storage *m_storage;
 
     std::string m_fileName;
+    const char *m_data;
+    size_t m_size;
 
     /**
      * We're not the owner, but we still keep track of all
@@ -127,5 +127,18 @@ SharedPtr<Parser> ParserFactory::createParser(const std::string &fileName)
         return 0;
     }
 
+    return setupParser(storage);
+}
+
+SharedPtr<Parser> ParserFactory::createParser(const char *data, size_t size)
+{
+    OLEStorage *storage(new OLEStorage(data, size));
+    if (!storage->open(OLEStorage::ReadOnly) || !storage->isValid()) {
+        delete storage;
+        if (size >= 4)
+            diagnose(reinterpret_cast<const unsigned char *>(data));
+        return 0;
+    }
+
     return setupParser(storage);
 }
\ No newline at end of file
@@ -41,6 +41,11 @@ public:
      * version, corrupted file,...).
      */
     static SharedPtr<Parser> createParser(const std::string &fileName);
+    /**
+     * Same as above, but for a document held in memory. The data
+     * is not copied and has to stay valid as long as the parser exists.
+     */
+    static SharedPtr<Parser> createParser(const char *data, size_t size);
 };
 
 } // namespace wvWare
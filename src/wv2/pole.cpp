@@ -153,12 +153,41 @@ private:
     DirTree &operator=(const DirTree &);
 };
 
+// read-only stream buffer on data in memory, without copying it
+class MemoryBuffer : public std::streambuf
+{
+public:
+    MemoryBuffer(const unsigned char *data, unsigned long size)
+    {
+        char *begin = reinterpret_cast<char *>(const_cast<unsigned char *>(data));
+        setg(begin, begin, begin + size);
+    }
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+    {
+        if (!(which & std::ios_base::in)) return pos_type(off_type(-1));
+        char *target = dir == std::ios_base::beg ? eback() + off : (dir == std::ios_base::cur ? gptr() + off : egptr() + off);
+        if (target < eback() || target > egptr()) return pos_type(off_type(-1));
+        setg(eback(), target, egptr());
+        return pos_type(target - eback());
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which)
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
 class StorageIO
 {
 public:
     Storage *storage;         // owner
     std::string filename;     // filename
     std::fstream file;        // associated with above name
+    MemoryBuffer *memory;     // data in memory, used instead of file if set
+    std::istream *memoryStream;
+    std::istream *input;      // either file or memoryStream
     int result;               // result of operation
     bool opened;              // true if file is opened
     unsigned long filesize;   // size of the file
@@ -173,6 +202,7 @@ public:
     std::list<Stream *> streams;
 
     StorageIO(Storage *storage, const char *filename);
+    StorageIO(Storage *storage, const unsigned char *data, unsigned long size);
     ~StorageIO();
 
     bool open();
@@ -1065,6 +1095,29 @@ StorageIO::StorageIO(Storage *st, const char *fname)
 {
     storage = st;
     filename = fname;
+    memory = 0;
+    memoryStream = 0;
+    input = &file;
+    result = Storage::Ok;
+    opened = false;
+
+    header = new Header();
+    dirtree = new DirTree();
+    bbat = new AllocTable();
+    sbat = new AllocTable();
+
+    filesize = 0;
+    bbat->blockSize = 1 << header->b_shift;
+    sbat->blockSize = 1 << header->s_shift;
+}
+
+StorageIO::StorageIO(Storage *st, const unsigned char *data, unsigned long size)
+{
+    storage = st;
+    filename = "";
+    memory = new MemoryBuffer(data, size);
+    memoryStream = new std::istream(memory);
+    input = memoryStream;
     result = Storage::Ok;
     opened = false;
 
@@ -1085,6 +1138,8 @@ StorageIO::~StorageIO()
     delete bbat;
     delete dirtree;
     delete header;
+    delete memoryStream;
+    delete memory;
 }
 
 bool StorageIO::open()
@@ -1105,18 +1160,21 @@ void StorageIO::load()
 
     // open the file, check for error
     result = Storage::OpenFailed;
-    file.open(filename.c_str(), std::ios::binary | std::ios::in);
-    if (!file.good()) return;
+    if (memory != 0) {
+        memoryStream->clear();
+    } else
+        file.open(filename.c_str(), std::ios::binary | std::ios::in);
+    if (!input->good()) return;
 
     // find size of input file
-    file.seekg(0, std::ios::end);
-    filesize = file.tellg();
+    input->seekg(0, std::ios::end);
+    filesize = input->tellg();
 
     // load header
     buffer = new unsigned char[OLE_HEADER_SIZE];
-    file.seekg(0);
-    file.read((char *)buffer, OLE_HEADER_SIZE);
-    if (!file.good()) {
+    input->seekg(0);
+    input->read((char *)buffer, OLE_HEADER_SIZE);
+    if (!input->good()) {
         delete[] buffer;
         return;
     }
@@ -1311,7 +1369,7 @@ unsigned long StorageIO::loadBigBlocks(const unsigned long *blocks, unsigned blo
 {
     // sentinel
     if (!data) return 0;
-    if (!file.good()) return 0;
+    if (!input->good()) return 0;
     if (!blocks) return 0;
     if (blockCount < 1) return 0;
     if (maxlen == 0) return 0;
@@ -1323,9 +1381,9 @@ unsigned long StorageIO::loadBigBlocks(const unsigned long *blocks, unsigned blo
         unsigned long pos =  bbat->blockSize * (block + 1);
         unsigned long p = (bbat->blockSize < maxlen - bytes) ? bbat->blockSize : maxlen - bytes;
         if (pos + p > filesize) p = filesize - pos;
-        file.seekg(pos);
-        file.read((char *)data + bytes, p);
-        if (!file.good()) return 0;
+        input->seekg(pos);
+        input->read((char *)data + bytes, p);
+        if (!input->good()) return 0;
         bytes += p;
     }
 
@@ -1337,7 +1395,7 @@ unsigned long StorageIO::loadBigBlock(unsigned long block,
 {
     // sentinel
     if (!data) return 0;
-    if (!file.good()) return 0;
+    if (!input->good()) return 0;
 
     return loadBigBlocks(&block, 1, data, maxlen);
 }
@@ -1354,7 +1412,7 @@ unsigned long StorageIO::loadSmallBlocks(const unsigned long *blocks, unsigned b
 {
     // sentinel
     if (!data) return 0;
-    if (!file.good()) return 0;
+    if (!input->good()) return 0;
     if (!blocks) return 0;
     if (blockCount < 1) return 0;
     if (maxlen == 0) return 0;
@@ -1396,7 +1454,7 @@ unsigned long StorageIO::loadSmallBlock(unsigned long block,
 {
     // sentinel
     if (!data) return 0;
-    if (!file.good()) return 0;
+    if (!input->good()) return 0;
 
     return loadSmallBlocks(&block, 1, data, maxlen);
 }
@@ -1568,6 +1626,11 @@ Storage::Storage(const char *filename)
     io = new StorageIO(this, filename);
 }
 
+Storage::Storage(const unsigned char *data, unsigned long size)
+{
+    io = new StorageIO(this, data, size);
+}
+
 Storage::~Storage()
 {
     delete io;
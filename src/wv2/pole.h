@@ -54,6 +54,13 @@ public:
      **/
     explicit Storage(const char *filename);
 
+    /**
+     * Constructs a read-only storage on data in memory.
+     * The data is not copied and has to stay valid as long
+     * as the storage is in use.
+     **/
+    Storage(const unsigned char *data, unsigned long size);
+
     /**
      * Destroys the storage.
      **/